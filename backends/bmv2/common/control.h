@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef BACKENDS_BMV2_COMMON_CONTROL_H_
 #define BACKENDS_BMV2_COMMON_CONTROL_H_
 
+#include <optional>
+#include <vector>
+
 #include "controlFlowGraph.h"
 #include "expression.h"
 #include "extern.h"
@@ -437,156 +440,202 @@ class ControlConverter : public Inspector {
         auto entriesList = table->getEntries();
         if (entriesList == nullptr) return;
 
-        auto entries = mkArrayField(jsonTable, "entries");
-        int entryPriority = 1;  // default priority is defined by index position
+        // Tables can have millions of const entries. They are checked here, so that errors are
+        // reported during the conversion, and only written when the JSON is serialized, straight
+        // into the output stream instead of into a tree of Json objects.
+        std::vector<cstring> matchTypes;
+        for (auto ke : table->getKey()->keyElements) matchTypes.push_back(getKeyMatchType(ke));
+        std::vector<unsigned> actionIds;
         for (auto e : entriesList->entries) {
-            auto entry = new Util::JsonObject();
-            entry->emplace_non_null("source_info", e->sourceInfoJsonObj());
-
-            auto keyset = e->getKeys();
-            auto matchKeys = mkArrayField(entry, "match_key");
-            int keyIndex = 0;
-            for (auto k : keyset->components) {
-                auto key = new Util::JsonObject();
-                auto tableKey = table->getKey()->keyElements.at(keyIndex);
-                auto keyWidth = tableKey->expression->type->width_bits();
+            checkEntryKeys(table, matchTypes, e);
+            actionIds.push_back(getEntryActionId(e));
+            checkEntryPriority(e);
+        }
+        jsonTable->emplace(
+            "entries",
+            new Util::JsonStream([table, matchTypes, actionIds](Util::JsonWriter &entries) {
+                writeTableEntries(entries, table, matchTypes, actionIds);
+            }));
+    }
+
+    /// @returns the length of the prefix that the mask of @p km selects in a key of
+    /// @p keyWidth bits, or std::nullopt if the mask is not a prefix.
+    static std::optional<int> lpmPrefixLength(const IR::Mask *km, int keyWidth) {
+        auto trailing_zeros = [](unsigned long n, unsigned long keyWidth) {
+            return n ? __builtin_ctzl(n) : static_cast<int>(keyWidth);
+        };
+        auto count_ones = [](unsigned long n) { return n ? __builtin_popcountl(n) : 0; };
+        auto mask = static_cast<unsigned long>(km->right->to<IR::Constant>()->value);
+        auto len = trailing_zeros(mask, keyWidth);
+        if (len + count_ones(mask) != keyWidth)  // any remaining 0s in the prefix?
+            return std::nullopt;
+        return keyWidth - len;
+    }
+
+    void checkEntryKeys(const IR::P4Table *table, const std::vector<cstring> &matchTypes,
+                        const IR::Entry *e) {
+        size_t keyIndex = 0;
+        for (auto k : e->getKeys()->components) {
+            auto keyWidth =
+                table->getKey()->keyElements.at(keyIndex)->expression->type->width_bits();
+            auto matchType = matchTypes.at(keyIndex++);
+            bool isDefault = k->is<IR::DefaultExpression>();
+            if (matchType == corelib.exactMatch.name) {
+                if (!k->is<IR::Constant>() && !k->is<IR::BoolLiteral>())
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported exact key expression",
+                            k);
+            } else if (matchType == corelib.ternaryMatch.name) {
+                if (!k->is<IR::Mask>() && !k->is<IR::Constant>() && !isDefault)
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported ternary key expression",
+                            k);
+            } else if (matchType == corelib.lpmMatch.name) {
+                if (auto km = k->to<IR::Mask>()) {
+                    if (!lpmPrefixLength(km, keyWidth))
+                        ::error(ErrorType::ERR_INVALID, "%1%: invalid mask for LPM key", k);
+                } else if (!k->is<IR::Constant>() && !isDefault) {
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported LPM key expression", k);
+                }
+            } else if (matchType == "range") {
+                if (!k->is<IR::Range>() && !k->is<IR::Constant>() && !isDefault)
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported range key expression", k);
+            } else if (matchType == "optional") {
+                // In the P4 source code we only allow exact values or a DefaultExpression (_ or
+                // default), no &&& expression.
+                if (!k->is<IR::Constant>() && !isDefault)
+                    ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported optional key expression",
+                            k);
+            } else {
+                ::error(ErrorType::ERR_UNKNOWN, "unknown key match type '%2%' for key %1%", k,
+                        matchType);
+            }
+        }
+    }
+
+    unsigned getEntryActionId(const IR::Entry *e) {
+        auto actionRef = e->getAction();
+        if (!actionRef->is<IR::MethodCallExpression>()) {
+            ::error(ErrorType::ERR_INVALID, "Invalid action '%1%' in entries list.", actionRef);
+            return INVALID_ACTION_ID;
+        }
+        auto actionCall = actionRef->to<IR::MethodCallExpression>();
+        auto method = actionCall->method->to<IR::PathExpression>()->path;
+        auto decl = ctxt->refMap->getDeclaration(method, true);
+        auto actionDecl = decl->to<IR::P4Action>();
+        unsigned id = get(ctxt->structure->ids, actionDecl, INVALID_ACTION_ID);
+        BUG_CHECK(id != INVALID_ACTION_ID, "Could not find id for %1%", actionDecl);
+        return id;
+    }
+
+    void checkEntryPriority(const IR::Entry *e) {
+        auto priorityAnnotation = e->getAnnotation("priority");
+        if (priorityAnnotation == nullptr) return;
+        if (priorityAnnotation->expr.size() > 1)
+            ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%", priorityAnnotation->expr);
+        if (!priorityAnnotation->expr.front()->is<IR::Constant>())
+            ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%; must be constant.",
+                    priorityAnnotation->expr);
+    }
+
+    /// Writes the entries of @p table, which have been checked by convertTableEntries.
+    static void writeTableEntries(Util::JsonWriter &entries, const IR::P4Table *table,
+                                  const std::vector<cstring> &matchTypes,
+                                  const std::vector<unsigned> &actionIds) {
+        const auto &corelib = P4::P4CoreLibrary::instance();
+        entries.beginArray();
+        int entryPriority = 1;  // default priority is defined by index position
+        size_t entryIndex = 0;
+        for (auto e : table->getEntries()->entries) {
+            entries.beginObject();
+            if (auto sourceInfo = e->sourceInfoJsonObj())
+                entries.field("source_info", sourceInfo);
+
+            entries.key("match_key").beginArray();
+            size_t keyIndex = 0;
+            for (auto k : e->getKeys()->components) {
+                entries.beginObject();
+                auto keyWidth =
+                    table->getKey()->keyElements.at(keyIndex)->expression->type->width_bits();
                 auto k8 = ROUNDUP(keyWidth, 8);
-                auto matchType = getKeyMatchType(tableKey);
+                auto matchType = matchTypes.at(keyIndex++);
+                bool isDefault = k->is<IR::DefaultExpression>();
                 // Table key fields with match_kind optional will be
                 // represented in the BMv2 JSON file the same as a ternary
                 // field would be.
                 if (matchType == "optional") {
-                    key->emplace("match_type", "ternary");
+                    entries.field("match_type", "ternary");
                 } else {
-                    key->emplace("match_type", matchType);
+                    entries.field("match_type", matchType);
                 }
                 if (matchType == corelib.exactMatch.name) {
-                    if (k->is<IR::Constant>())
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                    else if (k->is<IR::BoolLiteral>())
+                    if (auto kb = k->to<IR::BoolLiteral>())
                         // booleans are converted to ints
-                        key->emplace("key",
-                                     stringRepr(k->to<IR::BoolLiteral>()->value ? 1 : 0, k8));
+                        entries.field("key", stringRepr(kb->value ? 1 : 0, k8));
                     else
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported exact key expression",
-                                k);
-                } else if (matchType == corelib.ternaryMatch.name) {
-                    if (k->is<IR::Mask>()) {
-                        auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(km->right->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
+                        entries.field("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                } else if (matchType == corelib.ternaryMatch.name || matchType == "optional") {
+                    // Table key fields with match_kind optional with
+                    // "const entries" in the P4 source code will be
+                    // represented using the same "key" and "mask" keys in
+                    // the BMv2 JSON file as table key fields with
+                    // match_kind ternary.
+                    if (auto km = k->to<IR::Mask>()) {
+                        entries.field("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
+                        entries.field("mask", stringRepr(km->right->to<IR::Constant>()->value, k8));
+                    } else if (isDefault) {
+                        entries.field("key", stringRepr(0, k8));
+                        entries.field("mask", stringRepr(0, k8));
                     } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED,
-                                "%1%: unsupported ternary key expression", k);
+                        entries.field("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                        entries.field("mask", stringRepr(Util::mask(keyWidth), k8));
                     }
                 } else if (matchType == corelib.lpmMatch.name) {
-                    if (k->is<IR::Mask>()) {
-                        auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
-                        auto trailing_zeros = [](unsigned long n, unsigned long keyWidth) {
-                            return n ? __builtin_ctzl(n) : static_cast<int>(keyWidth);
-                        };
-                        auto count_ones = [](unsigned long n) {
-                            return n ? __builtin_popcountl(n) : 0;
-                        };
-                        auto mask =
-                            static_cast<unsigned long>(km->right->to<IR::Constant>()->value);
-                        auto len = trailing_zeros(mask, keyWidth);
-                        if (len + count_ones(mask) != keyWidth)  // any remaining 0s in the prefix?
-                            ::error(ErrorType::ERR_INVALID, "%1%: invalid mask for LPM key", k);
-                        else
-                            key->emplace("prefix_length", keyWidth - len);
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("prefix_length", keyWidth);
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("prefix_length", 0);
+                    if (auto km = k->to<IR::Mask>()) {
+                        entries.field("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
+                        entries.field("prefix_length", *lpmPrefixLength(km, keyWidth));
+                    } else if (isDefault) {
+                        entries.field("key", stringRepr(0, k8));
+                        entries.field("prefix_length", 0);
                     } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported LPM key expression",
-                                k);
+                        entries.field("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                        entries.field("prefix_length", keyWidth);
                     }
                 } else if (matchType == "range") {
-                    if (k->is<IR::Range>()) {
-                        auto kr = k->to<IR::Range>();
-                        key->emplace("start", stringRepr(kr->left->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(kr->right->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::Constant>()) {
-                        key->emplace("start", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(k->to<IR::Constant>()->value, k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("start", stringRepr(0, k8));
-                        key->emplace("end", stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
+                    if (auto kr = k->to<IR::Range>()) {
+                        entries.field("start", stringRepr(kr->left->to<IR::Constant>()->value, k8));
+                        entries.field("end", stringRepr(kr->right->to<IR::Constant>()->value, k8));
+                    } else if (isDefault) {
+                        entries.field("start", stringRepr(0, k8));
+                        entries.field("end", stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
                     } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported range key expression",
-                                k);
+                        entries.field("start", stringRepr(k->to<IR::Constant>()->value, k8));
+                        entries.field("end", stringRepr(k->to<IR::Constant>()->value, k8));
                     }
-                } else if (matchType == "optional") {
-                    // Table key fields with match_kind optional with
-                    // "const entries" in the P4 source code will be
-                    // represented using the same "key" and "mask" keys in
-                    // the BMv2 JSON file as table key fields with
-                    // match_kind ternary.  In the P4 source code we only
-                    // allow exact values or a DefaultExpression (_ or
-                    // default), no &&& expression.
-                    if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
-                    } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
-                    } else {
-                        ::error(ErrorType::ERR_UNSUPPORTED,
-                                "%1%: unsupported optional key expression", k);
-                    }
-                } else {
-                    ::error(ErrorType::ERR_UNKNOWN, "unknown key match type '%2%' for key %1%", k,
-                            matchType);
                 }
-                matchKeys->append(key);
-                keyIndex++;
+                entries.endObject();
             }
+            entries.endArray();
 
-            auto action = new Util::JsonObject();
-            auto actionRef = e->getAction();
-            if (!actionRef->is<IR::MethodCallExpression>())
-                ::error(ErrorType::ERR_INVALID, "Invalid action '%1%' in entries list.", actionRef);
-            auto actionCall = actionRef->to<IR::MethodCallExpression>();
-            auto method = actionCall->method->to<IR::PathExpression>()->path;
-            auto decl = ctxt->refMap->getDeclaration(method, true);
-            auto actionDecl = decl->to<IR::P4Action>();
-            unsigned id = get(ctxt->structure->ids, actionDecl, INVALID_ACTION_ID);
-            BUG_CHECK(id != INVALID_ACTION_ID, "Could not find id for %1%", actionDecl);
-            action->emplace("action_id", id);
-            auto actionData = mkArrayField(action, "action_data");
+            auto actionCall = e->getAction()->to<IR::MethodCallExpression>();
+            entries.key("action_entry").beginObject();
+            entries.field("action_id", actionIds.at(entryIndex++));
+            entries.key("action_data").beginArray(true);
             for (auto arg : *actionCall->arguments) {
-                actionData->append(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
+                entries.value(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
             }
-            entry->emplace("action_entry", action);
+            entries.endArray().endObject();
 
             auto priorityAnnotation = e->getAnnotation("priority");
             if (priorityAnnotation != nullptr) {
-                if (priorityAnnotation->expr.size() > 1)
-                    ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%",
-                            priorityAnnotation->expr);
                 auto priValue = priorityAnnotation->expr.front();
-                if (!priValue->is<IR::Constant>())
-                    ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%; must be constant.",
-                            priorityAnnotation->expr);
-                entry->emplace("priority", priValue->to<IR::Constant>()->value);
+                entries.field("priority", priValue->to<IR::Constant>()->value);
             } else {
-                entry->emplace("priority", entryPriority);
+                entries.field("priority", entryPriority);
             }
             entryPriority += 1;
 
-            entries->append(entry);
+            entries.endObject();
         }
+        entries.endArray();
     }
     cstring getKeyMatchType(const IR::KeyElement *ke) {
         auto path = ke->matchType->path;
@@ -48,6 +48,7 @@ class BMV2Options : public CompilerOptions {
                 return true;
             },
             "Write output to outfile");
+        registerOutputOption("-o");
         registerOption(
             "--fromJSON", "file",
             [this](const char *arg) {
@@ -25,6 +25,7 @@ limitations under the License.
 #include "backends/bmv2/simple_switch/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileStats.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "fstream"
@@ -32,15 +33,15 @@ limitations under the License.
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
 #include "lib/algorithm.h"
+#include "lib/compile_server.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/timer.h"
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoBMV2Context(new BMV2::SimpleSwitchContext);
     auto &options = BMV2::SimpleSwitchContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
@@ -57,10 +58,11 @@ int main(int argc, char *const argv[]) {
     options.preprocessor_options += " -D__TARGET_BMV2__";
 
     const IR::P4Program *program = nullptr;
+    P4::CompileStatsWriter statsWriter(options, program);
     const IR::ToplevelBlock *toplevel = nullptr;
 
     if (options.loadIRFromJson == false) {
-        program = P4::parseP4File(options);
+        Util::withTimer("parse", [&] { program = P4::parseP4File(options); });
 
         if (program == nullptr || ::errorCount() > 0) return 1;
         try {
@@ -69,7 +71,7 @@ int main(int argc, char *const argv[]) {
 
             P4::FrontEnd frontend;
             frontend.addDebugHook(hook);
-            program = frontend.run(options, program);
+            Util::withTimer("frontend", [&] { program = frontend.run(options, program); });
         } catch (const std::exception &bug) {
             std::cerr << bug.what() << std::endl;
             return 1;
@@ -97,7 +99,7 @@ int main(int argc, char *const argv[]) {
     BMV2::SimpleSwitchMidEnd midEnd(options);
     midEnd.addDebugHook(hook);
     try {
-        toplevel = midEnd.process(program);
+        Util::withTimer("midend", [&] { toplevel = midEnd.process(program); });
         if (::errorCount() > 1 || toplevel == nullptr || toplevel->getMain() == nullptr) return 1;
         if (options.dumpJsonFile && !options.loadIRFromJson)
             JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
@@ -113,7 +115,7 @@ int main(int argc, char *const argv[]) {
     // Necessary because BMV2Context is expected at the top of stack in further processing
     AutoCompileContext autoContext(new BMV2::BMV2Context(BMV2::SimpleSwitchContext::get()));
     try {
-        backend->convert(toplevel);
+        Util::withTimer("backend", [&] { backend->convert(toplevel); });
     } catch (const std::exception &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -130,3 +132,9 @@ int main(int argc, char *const argv[]) {
 
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+
+    return CompileServer::main(argc, argv, compile);
+}
@@ -22,6 +22,7 @@ limitations under the License.
 #include "dpdkAsmOpt.h"
 #include "dpdkCheckExternInvocation.h"
 #include "dpdkContext.h"
+#include "dpdkCostModel.h"
 #include "dpdkHelpers.h"
 #include "dpdkMetadata.h"
 #include "dpdkProgram.h"
@@ -150,6 +151,15 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
     };
 
     dpdk_program = dpdk_program->apply(post_code_gen)->to<IR::DpdkAsmProgram>();
+
+    if (!options.costReportFile.isNullOrEmpty() || options.maxPathInstructions != 0) {
+        DpdkCostModel costModel(options);
+        dpdk_program->apply(costModel);
+        if (!options.costReportFile.isNullOrEmpty()) {
+            std::ostream *out = openFile(options.costReportFile, false);
+            if (out != nullptr) costModel.serializeCostReport(out);
+        }
+    }
 }
 
 void DpdkBackend::codegen(std::ostream &out) const { dpdk_program->toSpec(out) << std::endl; }
@@ -0,0 +1,234 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dpdkCostModel.h"
+
+#include "dpdkUtils.h"
+#include "lib/error.h"
+
+namespace DPDK {
+
+namespace {
+
+// Sums the width of all metadata fields (m.<field_name>) referenced by a statement.
+class MetadataBytesCounter : public Inspector {
+    const std::map<cstring, unsigned> &fieldBytes;
+
+ public:
+    unsigned bytes = 0;
+    explicit MetadataBytesCounter(const std::map<cstring, unsigned> &fieldBytes)
+        : fieldBytes(fieldBytes) {}
+    bool preorder(const IR::Member *m) override {
+        if (m->expr->toString() != "m") return true;
+        auto it = fieldBytes.find(m->member.toString());
+        if (it != fieldBytes.end()) bytes += it->second;
+        return false;
+    }
+};
+
+cstring actionName(const IR::ActionListElement *ale) { return ale->getName().name; }
+
+}  // namespace
+
+Util::JsonObject *DpdkCost::toJson() const {
+    auto *json = new Util::JsonObject();
+    json->emplace("instructions", new Util::JsonValue(instructions));
+    json->emplace("metadata_bytes", new Util::JsonValue(metadataBytes));
+    json->emplace("table_lookups", new Util::JsonValue(tableLookups));
+    return json;
+}
+
+Util::JsonObject *DpdkPathCost::toJson() const {
+    auto *json = cost.toJson();
+    auto *tablesJson = new Util::JsonArray();
+    for (auto t : tables) tablesJson->append(t);
+    json->emplace("tables", tablesJson);
+    return json;
+}
+
+void DpdkCostModel::collectMetadataFields(const IR::DpdkAsmProgram *p) {
+    for (auto st : p->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields) {
+            metadataFieldBytes[field->name.name] = (field->type->width_bits() + 7) / 8;
+        }
+    }
+}
+
+DpdkCost DpdkCostModel::statementCost(const IR::DpdkAsmStatement *s) const {
+    DpdkCost cost;
+    // Labels are not instructions.
+    if (s->is<IR::DpdkLabelStatement>()) return cost;
+    cost.instructions = 1;
+    MetadataBytesCounter counter(metadataFieldBytes);
+    s->apply(counter);
+    cost.metadataBytes = counter.bytes;
+    return cost;
+}
+
+void DpdkCostModel::computeActionCosts(const IR::DpdkAsmProgram *p) {
+    for (auto action : p->actions) {
+        DpdkCost cost;
+        for (auto s : action->statements) cost += statementCost(s);
+        actionCost[action->name.name] = cost;
+    }
+}
+
+void DpdkCostModel::computeTableCost(cstring name, const IR::ActionList *actions) {
+    DpdkTableCost cost;
+    cost.worstCase.tableLookups = 1;
+    cost.typical.tableLookups = 1;
+    if (actions && actions->size() > 0) {
+        DpdkCost sum;
+        for (auto ale : actions->actionList) {
+            auto it = actionCost.find(actionName(ale));
+            if (it == actionCost.end()) continue;
+            if (it->second.instructions > cost.worstCase.instructions) {
+                cost.worstCase.instructions = it->second.instructions;
+                cost.worstCase.metadataBytes = it->second.metadataBytes;
+            }
+            sum += it->second;
+        }
+        cost.typical.instructions = sum.instructions / actions->size();
+        cost.typical.metadataBytes = sum.metadataBytes / actions->size();
+    }
+    tableCost[name] = cost;
+}
+
+void DpdkCostModel::computePathCosts(const IR::IndexedVector<IR::DpdkAsmStatement> &statements) {
+    size_t count = statements.size();
+    std::map<cstring, size_t> labelIndex;
+    for (size_t i = 0; i < count; i++) {
+        if (auto label = statements[i]->to<IR::DpdkLabelStatement>())
+            labelIndex[label->label] = i;
+    }
+
+    // Successors of each instruction; an index of 'count' ends the path. Jumps to labels
+    // outside of the apply block (e.g. LABEL_DROP) and backward jumps end the path too.
+    auto successors = [&](size_t i) {
+        std::vector<size_t> result;
+        auto s = statements[i];
+        if (s->is<IR::DpdkTxStatement>() || s->is<IR::DpdkDropStatement>() ||
+            s->is<IR::DpdkReturnStatement>()) {
+            result.push_back(count);
+            return result;
+        }
+        if (!s->is<IR::DpdkJmpLabelStatement>()) result.push_back(i + 1);
+        if (auto jmp = s->to<IR::DpdkJmpStatement>()) {
+            auto it = labelIndex.find(jmp->label);
+            result.push_back((it == labelIndex.end() || it->second <= i) ? count : it->second);
+        }
+        return result;
+    };
+
+    auto costOf = [&](size_t i, bool worstCase) {
+        auto cost = statementCost(statements[i]);
+        if (auto apply = statements[i]->to<IR::DpdkApplyStatement>()) {
+            auto it = tableCost.find(apply->table);
+            if (it != tableCost.end())
+                cost += worstCase ? it->second.worstCase : it->second.typical;
+            else
+                cost.tableLookups += 1;
+        }
+        return cost;
+    };
+
+    // Jumps only go forward, so a single backward sweep computes the most expensive path
+    // from each instruction to the end of the apply block.
+    std::vector<DpdkCost> worst(count + 1);
+    std::vector<size_t> next(count + 1, count);
+    for (size_t i = count; i-- > 0;) {
+        auto succs = successors(i);
+        next[i] = succs.front();
+        for (auto succ : succs) {
+            if (worst[succ].instructions > worst[next[i]].instructions) next[i] = succ;
+        }
+        worst[i] = costOf(i, true);
+        worst[i] += worst[next[i]];
+    }
+
+    DpdkPathCost path;
+    if (count > 0) path.cost = worst[0];
+    for (size_t i = 0; i < count; i = next[i]) {
+        if (auto apply = statements[i]->to<IR::DpdkApplyStatement>())
+            path.tables.push_back(apply->table);
+    }
+    if (path.cost.instructions >= worstCasePath.cost.instructions) worstCasePath = path;
+
+    path = DpdkPathCost();
+    for (size_t i = 0; i < count;) {
+        path.cost += costOf(i, false);
+        if (auto apply = statements[i]->to<IR::DpdkApplyStatement>())
+            path.tables.push_back(apply->table);
+        i = successors(i).front();
+    }
+    if (path.cost.instructions >= typicalPath.cost.instructions) typicalPath = path;
+}
+
+bool DpdkCostModel::preorder(const IR::DpdkAsmProgram *p) {
+    collectMetadataFields(p);
+    computeActionCosts(p);
+    for (auto t : p->tables) computeTableCost(t->name, t->actions);
+    for (auto l : p->learners) computeTableCost(l->name, l->actions);
+    for (auto s : p->selectors) computeTableCost(s->name, nullptr);
+    for (auto s : p->statements) {
+        if (auto list = s->to<IR::DpdkListStatement>()) computePathCosts(list->statements);
+    }
+    return false;
+}
+
+void DpdkCostModel::end_apply() {
+    if (options.maxPathInstructions == 0) return;
+    if (worstCasePath.cost.instructions > options.maxPathInstructions) {
+        ::error(ErrorType::ERR_OVERLIMIT,
+                "Estimated worst-case path of %1% instructions exceeds the budget of %2% "
+                "instructions",
+                static_cast<unsigned>(worstCasePath.cost.instructions),
+                options.maxPathInstructions);
+    }
+}
+
+const Util::JsonObject *DpdkCostModel::genCostReportJsonObject() const {
+    auto *json = new Util::JsonObject();
+    auto *actionsJson = new Util::JsonArray();
+    for (auto &a : actionCost) {
+        auto *actionJson = a.second.toJson();
+        actionJson->emplace("name", a.first);
+        actionsJson->append(actionJson);
+    }
+    json->emplace("actions", actionsJson);
+
+    auto *tablesJson = new Util::JsonArray();
+    for (auto &t : tableCost) {
+        auto *tableJson = new Util::JsonObject();
+        tableJson->emplace("name", t.first);
+        tableJson->emplace("worst_case", t.second.worstCase.toJson());
+        tableJson->emplace("typical", t.second.typical.toJson());
+        tablesJson->append(tableJson);
+    }
+    json->emplace("tables", tablesJson);
+
+    auto *pathsJson = new Util::JsonObject();
+    pathsJson->emplace("worst_case", worstCasePath.toJson());
+    pathsJson->emplace("typical", typicalPath.toJson());
+    json->emplace("paths", pathsJson);
+    return json;
+}
+
+void DpdkCostModel::serializeCostReport(std::ostream *destination) const {
+    genCostReportJsonObject()->serialize(*destination);
+    destination->flush();
+}
+
+}  // namespace DPDK
@@ -0,0 +1,98 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_DPDK_DPDKCOSTMODEL_H_
+#define BACKENDS_DPDK_DPDKCOSTMODEL_H_
+
+#include <map>
+#include <vector>
+
+#include "ir/ir.h"
+#include "lib/json.h"
+#include "options.h"
+
+/**
+The pass defined in this file computes an offline cost estimate for the generated
+DPDK SWX assembly program (the .spec output). The estimate is per action, per table and
+per packet path through the apply block, and counts instructions, metadata bytes touched
+and table lookups. It can be serialized as JSON and checked against an instruction budget.
+*/
+
+namespace DPDK {
+
+/// Estimated cost of a fragment of the assembly program.
+struct DpdkCost {
+    double instructions = 0;
+    /// Bytes of metadata read or written, counted per instruction.
+    double metadataBytes = 0;
+    double tableLookups = 0;
+
+    DpdkCost &operator+=(const DpdkCost &other) {
+        instructions += other.instructions;
+        metadataBytes += other.metadataBytes;
+        tableLookups += other.tableLookups;
+        return *this;
+    }
+    Util::JsonObject *toJson() const;
+};
+
+/// A path through the apply block together with the tables it applies.
+struct DpdkPathCost {
+    DpdkCost cost;
+    std::vector<cstring> tables;
+    Util::JsonObject *toJson() const;
+};
+
+/// Worst-case and typical cost of applying a table, including the action it runs.
+struct DpdkTableCost {
+    DpdkCost worstCase;
+    DpdkCost typical;
+};
+
+// This pass computes the cost report of a DpdkAsmProgram. It must run on the final
+// assembly program, after all assembly level optimizations.
+// Paths are walked with the assumption (shared with the assembly optimizations) that the
+// compiler only produces forward jumps. The worst-case path maximizes the instruction count
+// and assumes every table runs its most expensive action. The typical path falls through
+// every conditional jump and charges each table the mean cost of its actions.
+class DpdkCostModel : public Inspector {
+    const DpdkOptions &options;
+    /// Width in bytes of every field of the metadata struct.
+    std::map<cstring, unsigned> metadataFieldBytes;
+    std::map<cstring, DpdkCost> actionCost;
+    std::map<cstring, DpdkTableCost> tableCost;
+    DpdkPathCost worstCasePath;
+    DpdkPathCost typicalPath;
+
+    void collectMetadataFields(const IR::DpdkAsmProgram *p);
+    DpdkCost statementCost(const IR::DpdkAsmStatement *s) const;
+    void computeActionCosts(const IR::DpdkAsmProgram *p);
+    void computeTableCost(cstring name, const IR::ActionList *actions);
+    void computePathCosts(const IR::IndexedVector<IR::DpdkAsmStatement> &statements);
+
+ public:
+    explicit DpdkCostModel(const DpdkOptions &options) : options(options) {}
+
+    bool preorder(const IR::DpdkAsmProgram *p) override;
+    void end_apply() override;
+
+    const DpdkPathCost &getWorstCasePath() const { return worstCasePath; }
+    const DpdkPathCost &getTypicalPath() const { return typicalPath; }
+    const Util::JsonObject *genCostReportJsonObject() const;
+    void serializeCostReport(std::ostream *destination) const;
+};
+
+}  // namespace DPDK
+
+#endif /* BACKENDS_DPDK_DPDKCOSTMODEL_H_ */
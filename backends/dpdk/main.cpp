@@ -27,17 +27,20 @@ limitations under the License.
 #include "control-plane/bfruntime_ext.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileStats.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/common/parser_options.h"
 #include "frontends/p4/frontend.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/compile_server.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/timer.h"
 
 void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOptions &options) {
     auto p4RuntimeSerializer = P4::P4RuntimeSerializer::get();
@@ -59,9 +62,7 @@ void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOpt
     p4rt->serializeBFRuntimeSchema(out);
 }
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoDpdkContext(new DPDK::DpdkContext);
     auto &options = DPDK::DpdkContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
@@ -75,10 +76,11 @@ int main(int argc, char *const argv[]) {
     auto hook = options.getDebugHook();
 
     const IR::P4Program *program = nullptr;
+    P4::CompileStatsWriter statsWriter(options, program);
     const IR::ToplevelBlock *toplevel = nullptr;
 
     if (options.loadIRFromJson == false) {
-        program = P4::parseP4File(options);
+        Util::withTimer("parse", [&] { program = P4::parseP4File(options); });
 
         if (program == nullptr || ::errorCount() > 0) return 1;
         try {
@@ -87,7 +89,7 @@ int main(int argc, char *const argv[]) {
 
             P4::FrontEnd frontend;
             frontend.addDebugHook(hook);
-            program = frontend.run(options, program);
+            Util::withTimer("frontend", [&] { program = frontend.run(options, program); });
         } catch (const std::exception &bug) {
             std::cerr << bug.what() << std::endl;
             return 1;
@@ -124,7 +126,7 @@ int main(int argc, char *const argv[]) {
     DPDK::DpdkMidEnd midEnd(options);
     midEnd.addDebugHook(hook);
     try {
-        toplevel = midEnd.process(program);
+        Util::withTimer("midend", [&] { toplevel = midEnd.process(program); });
         if (::errorCount() > 1 || toplevel == nullptr || toplevel->getMain() == nullptr) return 1;
         if (options.dumpJsonFile)
             JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
@@ -136,7 +138,7 @@ int main(int argc, char *const argv[]) {
 
     auto backend = new DPDK::DpdkBackend(options, &midEnd.refMap, &midEnd.typeMap, p4info);
 
-    backend->convert(toplevel);
+    Util::withTimer("backend", [&] { backend->convert(toplevel); });
     if (::errorCount() > 0) return 1;
 
     if (!options.outputFile.isNullOrEmpty()) {
@@ -149,3 +151,9 @@ int main(int argc, char *const argv[]) {
 
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+
+    return CompileServer::main(argc, argv, compile);
+}
@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef BACKENDS_DPDK_OPTIONS_H_
 #define BACKENDS_DPDK_OPTIONS_H_
 
+#include <charconv>
+#include <cstring>
+
 #include "backends/dpdk/midend.h"
 
 namespace DPDK {
@@ -34,6 +37,11 @@ class DpdkOptions : public CompilerOptions {
     bool loadIRFromJson = false;
     // Enable/Disable Egress pipeline in psa
     bool enableEgress = false;
+    // file to output the cost report of the generated .spec program to
+    cstring costReportFile = "";
+    // Fail the compilation when the estimated worst-case path exceeds this
+    // number of instructions, 0 disables the check
+    unsigned maxPathInstructions = 0;
 
     DpdkOptions() {
         registerOption(
@@ -81,6 +89,29 @@ class DpdkOptions : public CompilerOptions {
                 return true;
             },
             "Generate and write context JSON to the specified file");
+        registerOption(
+            "--cost-report", "file",
+            [this](const char *arg) {
+                costReportFile = arg;
+                return true;
+            },
+            "Write the estimated instruction count, metadata bytes and table lookups\n"
+            "per action, table and packet path of the generated program to the specified file");
+        for (auto option : {"--bf-rt-schema", "-o", "--tdi", "--context", "--cost-report"})
+            registerOutputOption(option);
+        registerOption(
+            "--max-path-instructions", "count",
+            [this](const char *arg) {
+                const char *end = arg + strlen(arg);
+                auto [ptr, ec] = std::from_chars(arg, end, maxPathInstructions);
+                if (ec != std::errc() || ptr != end || maxPathInstructions == 0) {
+                    ::error(ErrorType::ERR_INVALID, "Illegal instruction count %1%", arg);
+                    return false;
+                }
+                return true;
+            },
+            "Report an error if the estimated worst-case packet path of the generated\n"
+            "program exceeds the specified number of instructions");
         registerOption(
             "--fromJSON", "file",
             [this](const char *arg) {
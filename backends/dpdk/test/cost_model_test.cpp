@@ -0,0 +1,128 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+
+#include "backends/dpdk/dpdkCostModel.h"
+#include "backends/dpdk/options.h"
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+#include "test/gtest/helpers.h"
+
+namespace Test {
+
+namespace {
+
+const IR::Expression *metadataField() {
+    return new IR::Member(new IR::PathExpression(IR::ID("m")), IR::ID("x"));
+}
+
+/// A metadata struct with one 16 bit field, two actions of 2 and 1 instructions, a table
+/// using both of them and an apply block that skips the table when m.x is 0:
+///     jmpeq LABEL_SKIP m.x 0
+///     table t
+///     LABEL_SKIP :
+///     tx m.x
+const IR::DpdkAsmProgram *program() {
+    IR::IndexedVector<IR::StructField> fields;
+    fields.push_back(new IR::StructField(IR::ID("x"), IR::Type_Bits::get(16)));
+    auto *annotations = new IR::Annotations({new IR::Annotation(IR::ID("__metadata__"), {})});
+    IR::IndexedVector<IR::DpdkStructType> structType;
+    structType.push_back(new IR::DpdkStructType(IR::ID("main_metadata_t"), annotations, fields));
+
+    IR::IndexedVector<IR::DpdkAsmStatement> a1, a2;
+    a1.push_back(new IR::DpdkMovStatement(metadataField(), new IR::Constant(1)));
+    a1.push_back(new IR::DpdkMovStatement(metadataField(), new IR::Constant(2)));
+    a2.push_back(new IR::DpdkMovStatement(metadataField(), new IR::Constant(3)));
+    IR::IndexedVector<IR::DpdkAction> actions;
+    actions.push_back(new IR::DpdkAction(a1, IR::ID("a1"), IR::ParameterList()));
+    actions.push_back(new IR::DpdkAction(a2, IR::ID("a2"), IR::ParameterList()));
+
+    IR::IndexedVector<IR::ActionListElement> elements;
+    elements.push_back(new IR::ActionListElement(new IR::PathExpression(IR::ID("a1"))));
+    elements.push_back(new IR::ActionListElement(new IR::PathExpression(IR::ID("a2"))));
+    IR::IndexedVector<IR::DpdkTable> tables;
+    tables.push_back(new IR::DpdkTable("t", new IR::Key(IR::Vector<IR::KeyElement>()),
+                                       new IR::ActionList(elements),
+                                       new IR::PathExpression(IR::ID("a2")),
+                                       new IR::TableProperties(), IR::ParameterList()));
+
+    IR::IndexedVector<IR::DpdkAsmStatement> apply;
+    apply.push_back(
+        new IR::DpdkJmpEqualStatement("LABEL_SKIP", metadataField(), new IR::Constant(0)));
+    apply.push_back(new IR::DpdkApplyStatement("t"));
+    apply.push_back(new IR::DpdkLabelStatement("LABEL_SKIP"));
+    apply.push_back(new IR::DpdkTxStatement(metadataField()));
+    IR::IndexedVector<IR::DpdkAsmStatement> statements;
+    statements.push_back(new IR::DpdkListStatement(apply));
+
+    return new IR::DpdkAsmProgram({}, structType, {}, actions, tables, {}, {}, statements, {});
+}
+
+}  // namespace
+
+class DpdkCostModelTest : public P4CTest {};
+
+TEST_F(DpdkCostModelTest, PathCosts) {
+    DPDK::DpdkOptions options;
+    DPDK::DpdkCostModel costModel(options);
+    program()->apply(costModel);
+    EXPECT_EQ(::errorCount(), 0u);
+
+    // The worst-case path applies the table and runs its most expensive action.
+    auto &worstCase = costModel.getWorstCasePath();
+    EXPECT_EQ(worstCase.cost.instructions, 5);
+    EXPECT_EQ(worstCase.cost.metadataBytes, 8);
+    EXPECT_EQ(worstCase.cost.tableLookups, 1);
+    EXPECT_EQ(worstCase.tables, std::vector<cstring>{"t"});
+
+    // The typical path falls through the jump and charges the mean cost of the actions.
+    auto &typical = costModel.getTypicalPath();
+    EXPECT_EQ(typical.cost.instructions, 4.5);
+    EXPECT_EQ(typical.cost.metadataBytes, 7);
+    EXPECT_EQ(typical.cost.tableLookups, 1);
+    EXPECT_EQ(typical.tables, std::vector<cstring>{"t"});
+}
+
+TEST_F(DpdkCostModelTest, InstructionBudget) {
+    DPDK::DpdkOptions options;
+    options.maxPathInstructions = 5;
+    DPDK::DpdkCostModel withinBudget(options);
+    program()->apply(withinBudget);
+    EXPECT_EQ(::errorCount(), 0u);
+
+    options.maxPathInstructions = 4;
+    DPDK::DpdkCostModel overBudget(options);
+    program()->apply(overBudget);
+    EXPECT_EQ(::errorCount(), 1u);
+}
+
+TEST_F(DpdkCostModelTest, InstructionBudgetOption) {
+    auto process = [](const char *count) {
+        DPDK::DpdkOptions options;
+        char *argv[] = {const_cast<char *>("p4c-dpdk"),
+                        const_cast<char *>("--max-path-instructions"), const_cast<char *>(count)};
+        return options.process(3, argv) != nullptr ? options.maxPathInstructions : 0;
+    };
+    EXPECT_EQ(process("120"), 120u);
+    EXPECT_EQ(::errorCount(), 0u);
+    EXPECT_EQ(process("0"), 0u);
+    EXPECT_EQ(process("12k"), 0u);
+    EXPECT_EQ(process("-1"), 0u);
+    EXPECT_EQ(process("many"), 0u);
+    EXPECT_EQ(::errorCount(), 4u);
+}
+
+}  // namespace Test
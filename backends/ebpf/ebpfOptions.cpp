@@ -27,6 +27,7 @@ EbpfOptions::EbpfOptions() {
             return true;
         },
         "Write output to outfile");
+    registerOutputOption("-o");
     registerOption(
         "--listMidendPasses", nullptr,
         [this](const char *) {
@@ -23,6 +23,7 @@ limitations under the License.
 #include "ebpfBackend.h"
 #include "ebpfOptions.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileStats.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "fstream"
@@ -33,16 +34,18 @@ limitations under the License.
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/timer.h"
 #include "midend.h"
 
 void compile(EbpfOptions &options) {
+    const IR::P4Program *program = nullptr;
+    P4::CompileStatsWriter statsWriter(options, program);
     auto hook = options.getDebugHook();
     bool isv1 = options.langVersion == CompilerOptions::FrontendVersion::P4_14;
     if (isv1) {
         ::error(ErrorType::ERR_UNSUPPORTED_ON_TARGET, "This compiler only handles P4-16");
         return;
     }
-    const IR::P4Program *program = nullptr;
 
     if (options.loadIRFromJson) {
         std::filebuf fb;
@@ -60,7 +63,7 @@ void compile(EbpfOptions &options) {
         program = new IR::P4Program(jsonFileLoader);
         fb.close();
     } else {
-        program = P4::parseP4File(options);
+        Util::withTimer("parse", [&] { program = P4::parseP4File(options); });
         if (::errorCount() > 0) return;
 
         P4::P4COptionPragmaParser optionsPragmaParser;
@@ -68,17 +71,20 @@ void compile(EbpfOptions &options) {
 
         P4::FrontEnd frontend;
         frontend.addDebugHook(hook);
-        program = frontend.run(options, program);
+        Util::withTimer("frontend", [&] { program = frontend.run(options, program); });
         if (::errorCount() > 0) return;
     }
     EBPF::MidEnd midend;
     midend.addDebugHook(hook);
-    auto toplevel = midend.run(options, program);
+    const IR::ToplevelBlock *toplevel = nullptr;
+    Util::withTimer("midend", [&] { toplevel = midend.run(options, program); });
     if (options.dumpJsonFile)
         JSONGenerator(*openFile(options.dumpJsonFile, true)) << program << std::endl;
     if (::errorCount() > 0) return;
 
-    EBPF::run_ebpf_backend(options, toplevel, &midend.refMap, &midend.typeMap);
+    Util::withTimer("backend", [&] {
+        EBPF::run_ebpf_backend(options, toplevel, &midend.refMap, &midend.typeMap);
+    });
 }
 
 int main(int argc, char *const argv[]) {
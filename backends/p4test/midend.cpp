@@ -27,6 +27,7 @@ limitations under the License.
 #include "frontends/p4/toP4/toP4.h"
 #include "frontends/p4/typeMap.h"
 #include "frontends/p4/unusedDeclarations.h"
+#include "ir/pass_result_cache.h"
 #include "midend/actionSynthesis.h"
 #include "midend/compileTimeOps.h"
 #include "midend/complexComparison.h"
@@ -162,6 +163,12 @@ MidEnd::MidEnd(CompilerOptions &options, std::ostream *outStream) {
     if (options.excludeMidendPasses) {
         removePasses(options.passesToExcludeMidend);
     }
+    // On a hit the evaluator rebuilds the toplevel block, the only other result of the passes.
+    if (options.passCacheDir && options.top4.empty()) {
+        auto setToplevel = [this, evaluator]() { toplevel = evaluator->getToplevelBlock(); };
+        cacheResults(new PassResultCache(options.passCacheDir), "MidEndLast",
+                     options.passCacheContext(), {evaluator, setToplevel});
+    }
     addDebugHooks(hooks, true);
 }
 
@@ -20,18 +20,22 @@ limitations under the License.
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileStats.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_ir.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/compile_server.h"
 #include "lib/crash.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/timer.h"
 #include "midend.h"
 
 class P4TestOptions : public CompilerOptions {
@@ -39,6 +43,8 @@ class P4TestOptions : public CompilerOptions {
     bool parseOnly = false;
     bool validateOnly = false;
     bool loadIRFromJson = false;
+    bool loadIRFromBinary = false;
+    cstring dumpBinaryIRFile = nullptr;
     P4TestOptions() {
         registerOption(
             "--listMidendPasses", nullptr,
@@ -72,6 +78,23 @@ class P4TestOptions : public CompilerOptions {
                 return true;
             },
             "read previously dumped json instead of P4 source code");
+        registerOption(
+            "--fromBinaryIR", "file",
+            [this](const char *arg) {
+                loadIRFromBinary = true;
+                file = arg;
+                return true;
+            },
+            "read IR previously dumped with --toBinaryIR instead of P4 source code");
+        registerOption(
+            "--toBinaryIR", "file",
+            [this](const char *arg) {
+                dumpBinaryIRFile = arg;
+                return true;
+            },
+            "Dump the compiler IR after the midend in the binary IR format in the specified "
+            "file.\nThe binary format holds the same information as --toJSON.");
+        registerOutputOption("--toBinaryIR");
         registerOption(
             "--turn-off-logn", nullptr,
             [](const char *) {
@@ -100,20 +123,18 @@ static void log_dump(const IR::Node *node, const char *head) {
     }
 }
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-    setup_signals();
-
+static int compile(int argc, char *const argv[]) {
     AutoCompileContext autoP4TestContext(new P4TestContext);
     auto &options = P4TestContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = P4TEST_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
     const IR::P4Program *program = nullptr;
+    P4::CompileStatsWriter statsWriter(options, program);
     auto hook = options.getDebugHook();
     if (options.loadIRFromJson) {
         std::ifstream json(options.file);
@@ -126,8 +147,14 @@ int main(int argc, char *const argv[]) {
         } else {
             error(ErrorType::ERR_IO, "Can't open %s", options.file);
         }
+    } else if (options.loadIRFromBinary) {
+        if (auto node = loadBinaryIR(options.file)) {
+            if (!(program = node->to<IR::P4Program>()))
+                error(ErrorType::ERR_INVALID, "%s is not a P4Program in binary IR format",
+                      options.file);
+        }
     } else {
-        program = P4::parseP4File(options);
+        Util::withTimer("parse", [&] { program = P4::parseP4File(options); });
 
         if (program != nullptr && ::errorCount() == 0) {
             P4::P4COptionPragmaParser optionsPragmaParser;
@@ -137,7 +164,7 @@ int main(int argc, char *const argv[]) {
                 try {
                     P4::FrontEnd fe;
                     fe.addDebugHook(hook);
-                    program = fe.run(options, program);
+                    Util::withTimer("frontend", [&] { program = fe.run(options, program); });
                 } catch (const std::exception &bug) {
                     std::cerr << bug.what() << std::endl;
                     return 1;
@@ -165,7 +192,7 @@ int main(int argc, char *const argv[]) {
 #endif
             const IR::ToplevelBlock *top = nullptr;
             try {
-                top = midEnd.process(program);
+                Util::withTimer("midend", [&] { top = midEnd.process(program); });
                 // This can modify program!
                 log_dump(program, "After midend");
                 log_dump(top, "Top level block");
@@ -177,6 +204,8 @@ int main(int argc, char *const argv[]) {
         if (program) {
             if (options.dumpJsonFile)
                 JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+            if (options.dumpBinaryIRFile)
+                writeBinaryIR(*openFile(options.dumpBinaryIRFile, true), program, true);
             if (options.debugJson) {
                 std::stringstream ss1, ss2;
                 JSONGenerator gen1(ss1), gen2(ss2);
@@ -203,3 +232,10 @@ int main(int argc, char *const argv[]) {
     if (Log::verbose()) std::cerr << "Done." << std::endl;
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+    setup_signals();
+
+    return CompileServer::main(argc, argv, compile);
+}
@@ -304,11 +304,13 @@ def main(args, extra_args):
         "GREEDY_STATEMENT_SEARCH",
         "RANDOM_BACKTRACK",
         "DEPTH_FIRST",
+        "DISTANCE_STATEMENT_SEARCH",
     ]
     config = {
         "DEPTH_FIRST": "",
         "RANDOM_BACKTRACK": "",
         "GREEDY_STATEMENT_SEARCH": "",
+        "DISTANCE_STATEMENT_SEARCH": "",
     }
     p4_program = options.p4_programs[0]
     p4_program = testutils.check_if_file(p4_program)
@@ -3,16 +3,30 @@
 #include <z3_api.h>
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <cstdint>
 #include <exception>
 #include <iterator>
 #include <list>
 #include <map>
+#include <numeric>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#ifdef MULTITHREAD
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
 
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include "backends/p4tools/common/lib/variables.h"
 #include "ir/ir.h"
 #include "ir/irutils.h"
 #include "ir/json_loader.h"  // IWYU pragma: keep
@@ -20,7 +34,9 @@
 #include "ir/node.h"
 #include "ir/visitor.h"
 #include "lib/big_int_util.h"
+#include "lib/error.h"
 #include "lib/exceptions.h"
+#include "lib/gc.h"
 #include "lib/indent.h"
 #include "lib/log.h"
 #include "lib/timer.h"
@@ -50,6 +66,162 @@ const char *toString(z3::model m) { return Z3_model_to_string(m.ctx(), m); }
 #define Z3_LOG(...)
 #endif  // NDEBUG
 
+/// The maximal number of cluster results kept by Z3Solver before they are discarded.
+static constexpr size_t MAX_CLUSTER_RESULTS = 1 << 16;
+
+#ifdef MULTITHREAD
+/// The alternative configurations of the solver portfolio.
+enum class PortfolioConfig {
+    /// Simplifies the assertions, bit-blasts them, and solves them with the SAT solver.
+    BitBlast,
+    /// The solver Z3 picks for quantifier-free bit-vector logic.
+    QfBv,
+    /// The default configuration with a different random seed.
+    Reseeded,
+};
+
+static constexpr PortfolioConfig PORTFOLIO_CONFIGS[] = {
+    PortfolioConfig::BitBlast, PortfolioConfig::QfBv, PortfolioConfig::Reseeded};
+
+/// The assertions of a solver, translated into a context of their own, so that the alternative
+/// configurations of the portfolio can copy them while the solver's context is checking.
+class PortfolioAssertions {
+ public:
+    z3::context context;
+
+    /// The assertions in the context of the solver.
+    z3::expr_vector sources;
+
+    /// The assertions, translated into @ref context.
+    z3::expr_vector assertions;
+
+    explicit PortfolioAssertions(z3::context &solverContext)
+        : sources(solverContext), assertions(context) {}
+
+    /// Updates the translated assertions to @param current. The assertions in the common prefix
+    /// with the previous update are kept, only the others are translated.
+    void update(const z3::expr_vector &current) {
+        unsigned common = 0;
+        while (common < sources.size() && common < current.size() &&
+               z3::eq(sources[static_cast<int>(common)], current[static_cast<int>(common)])) {
+            common++;
+        }
+        sources.resize(common);
+        assertions.resize(common);
+        for (unsigned i = common; i < current.size(); i++) {
+            const auto &assertion = current[static_cast<int>(i)];
+            sources.push_back(assertion);
+            assertions.push_back(
+                z3::expr(context, Z3_translate(assertion.ctx(), assertion, context)));
+        }
+    }
+};
+
+/// An alternative configuration of the solver portfolio. A Z3 context can not be used by several
+/// threads at once, so each configuration has its own context and a copy of the assertions.
+class PortfolioSolver {
+    static z3::solver mkSolver(z3::context &context, PortfolioConfig config, unsigned seed,
+                               unsigned timeout) {
+        z3::params param(context);
+        param.set(":timeout", timeout);
+        switch (config) {
+            case PortfolioConfig::BitBlast: {
+                auto tactic = z3::tactic(context, "simplify") & z3::tactic(context, "solve-eqs") &
+                              z3::tactic(context, "bit-blast") & z3::tactic(context, "sat");
+                return z3::try_for(tactic, timeout).mk_solver();
+            }
+            case PortfolioConfig::QfBv: {
+                z3::solver solver(context, "QF_BV");
+                solver.set(param);
+                return solver;
+            }
+            case PortfolioConfig::Reseeded: {
+                z3::solver solver(context);
+                param.set("phase_selection", 5U);
+                param.set("random_seed", seed + 1);
+                solver.set(param);
+                return solver;
+            }
+        }
+        BUG("Unknown portfolio configuration");
+    }
+
+ public:
+    z3::context context;
+
+    /// The assertions, translated into @ref context.
+    z3::expr_vector assertions;
+
+    z3::solver solver;
+
+    z3::check_result result = z3::unknown;
+
+    /// Copies @param source into the context of this configuration.
+    PortfolioSolver(PortfolioConfig config, const z3::expr_vector &source, unsigned seed,
+                    unsigned timeout)
+        : assertions(context), solver(mkSolver(context, config, seed, timeout)) {
+        for (unsigned i = 0; i < source.size(); i++) {
+            const auto &assertion = source[i];
+            assertions.push_back(
+                z3::expr(context, Z3_translate(assertion.ctx(), assertion, context)));
+        }
+        solver.add(assertions);
+    }
+};
+
+/// A check of a Z3 context that other threads can cancel. An interrupt only takes effect while
+/// the context is checking, and one that arrives after the check returned would cancel the next
+/// use of the context. So the interrupts are repeated until the check returns, and never sent
+/// to a context that is not checking. Cancelling is latched: a check that has not started yet
+/// does not start anymore.
+class CancellableCheck {
+    std::mutex mutex;
+
+    /// The context that is being checked, or nullptr.
+    z3::context *checking = nullptr;
+
+    bool cancelled = false;
+
+ public:
+    /// Runs @param check on @param context, unless the check was cancelled before.
+    z3::check_result run(z3::context &context, const std::function<z3::check_result()> &check) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (cancelled) {
+                return z3::unknown;
+            }
+            checking = &context;
+        }
+        z3::check_result result = z3::unknown;
+        try {
+            result = check();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            checking = nullptr;
+            throw;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        checking = nullptr;
+        return result;
+    }
+
+    /// Cancels the check and waits until it has returned, if it is running.
+    void cancel() {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+                if (checking == nullptr) {
+                    return;
+                }
+                checking->interrupt();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+#endif  // MULTITHREAD
+
 /// Translates P4 expressions into Z3. Any variables encountered are declared to a Z3 instance.
 class Z3Translator : public virtual Inspector {
  public:
@@ -174,19 +346,29 @@ z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var) {
     // Need to take the reference here to avoid accidental copies.
     auto *latestVars = &declaredVarsById.back();
     latestVars->emplace(expr.id(), &var);
+    if (translationVars != nullptr) {
+        translationVars->emplace_back(expr.id(), &var);
+    }
     return expr;
 }
 
 void Z3Solver::reset() {
     z3solver.reset();
+    portfolioModel = std::nullopt;
     declaredVarsById.clear();
     checkpoints.clear();
     z3Assertions.resize(0);
+    constraintVariables.clear();
 }
 
 void Z3Solver::clearMemory() {
     auto p4AssertionsBuf = p4Assertions;
     reset();
+    // Cached translations refer to the context that is about to be released.
+    portfolioAssertions = nullptr;
+    translationCache.clear();
+    translationsByNode.clear();
+    translationHashes.clear();
     Z3_finalize_memory();
     z3solver = z3::solver(*new z3::context());
     p4Assertions.clear();
@@ -229,8 +411,11 @@ void Z3Solver::pop() {
         }
     }
 
-    // Update p4Assertions to match.
+    // Update p4Assertions to match, forgetting the variables of the popped assertions.
     BUG_CHECK(p4Assertions.size() >= sz, "Invalid size of assertions");
+    for (size_t i = sz; i < p4Assertions.size(); i++) {
+        constraintVariables.erase(p4Assertions[i]);
+    }
     p4Assertions.resize(sz);
 }
 
@@ -261,6 +446,14 @@ void Z3Solver::timeout(unsigned tm) {
 
 std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &asserts) {
     Util::ScopedTimer ctZ3("z3");
+    if (constraintSlicing) {
+        return checkSatSliced(asserts);
+    }
+    return checkSatZ3(asserts);
+}
+
+std::optional<bool> Z3Solver::checkSatZ3(const std::vector<const Constraint *> &asserts) {
+    portfolioModel = std::nullopt;
     if (isIncremental) {
         // Find common prefix with the previous invocation's list of assertions
         auto from = asserts.begin();
@@ -283,7 +476,12 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
     Z3_LOG("checking satisfiability for %d assertions",
            isIncremental ? z3solver.assertions().size() : z3Assertions.size());
     Util::ScopedTimer ctCheckSat("checkSat");
-    z3::check_result result = isIncremental ? z3solver.check() : z3solver.check(z3Assertions);
+    z3::check_result result = z3::unknown;
+    if (portfolio) {
+        result = checkPortfolio();
+    } else {
+        result = isIncremental ? z3solver.check() : z3solver.check(z3Assertions);
+    }
     switch (result) {
         case z3::sat:
             Z3_LOG("result:%s", "sat");
@@ -298,12 +496,263 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
     }
 }
 
+z3::check_result Z3Solver::checkPortfolio() {
+#ifdef MULTITHREAD
+    auto check = [this]() {
+        return isIncremental ? z3solver.check() : z3solver.check(z3Assertions);
+    };
+    unsigned timeoutMs = timeout_.value_or(UINT_MAX);
+    if (timeoutMs <= PORTFOLIO_DELAY_MS) {
+        return check();
+    }
+
+    // The context of this solver can not be read while the default configuration checks the
+    // assertions, so they are kept up to date in a context of their own beforehand. This only
+    // translates the assertions that changed since the previous query. The alternative
+    // configurations copy them from there when they are started.
+    // The alternative configurations start after the delay and only get what is left of the
+    // timeout, so that the query as a whole does not take longer than without the portfolio.
+    if (!portfolioAssertions) {
+        portfolioAssertions = std::make_shared<PortfolioAssertions>(ctx());
+    }
+    portfolioAssertions->update(isIncremental ? z3solver.assertions() : z3Assertions);
+    unsigned remainingMs = timeout_ ? timeoutMs - PORTFOLIO_DELAY_MS : timeoutMs;
+    auto seed = seed_.value_or(0);
+    std::vector<std::unique_ptr<PortfolioSolver>> solvers(std::size(PORTFOLIO_CONFIGS));
+
+    // The check of the default configuration is 0, the check of the alternative solver i is
+    // i + 1. The first check with a definite answer wins and cancels all other checks.
+    static constexpr int NO_WINNER = -1;
+    std::atomic<int> winner = NO_WINNER;
+    std::vector<CancellableCheck> checks(solvers.size() + 1);
+    auto finish = [&](int checkIdx, z3::check_result result) {
+        int noWinner = NO_WINNER;
+        if (result == z3::unknown || !winner.compare_exchange_strong(noWinner, checkIdx)) {
+            return;
+        }
+        for (size_t i = 0; i < checks.size(); i++) {
+            if (static_cast<int>(i) != checkIdx) {
+                checks[i].cancel();
+            }
+        }
+    };
+
+    // Most queries are answered quickly by the default configuration. The alternative
+    // configurations are only started if it has not returned within the delay. The default
+    // configuration keeps checking meanwhile, it is not restarted.
+    std::mutex defaultMutex;
+    std::condition_variable defaultReturned;
+    bool defaultDone = false;
+    bool raced = false;
+    enable_gc_threads();
+    std::thread launcher([&]() {
+        GCThreadRegistration gcThread;
+        {
+            std::unique_lock<std::mutex> lock(defaultMutex);
+            if (defaultReturned.wait_for(lock, std::chrono::milliseconds(PORTFOLIO_DELAY_MS),
+                                         [&defaultDone]() { return defaultDone; })) {
+                return;
+            }
+        }
+        raced = true;
+        for (size_t i = 0; i < solvers.size(); i++) {
+            solvers[i] = std::make_unique<PortfolioSolver>(
+                PORTFOLIO_CONFIGS[i], portfolioAssertions->assertions, seed, remainingMs);
+        }
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < solvers.size(); i++) {
+            threads.emplace_back([&, i]() {
+                GCThreadRegistration gcThread;
+                auto &portfolioSolver = *solvers[i];
+                try {
+                    portfolioSolver.result = checks[i + 1].run(
+                        portfolioSolver.context, [&]() { return portfolioSolver.solver.check(); });
+                } catch (z3::exception &) {
+                    // Configurations that do not support the assertions do not take part.
+                    portfolioSolver.result = z3::unknown;
+                }
+                finish(static_cast<int>(i) + 1, portfolioSolver.result);
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    });
+
+    z3::check_result result = z3::unknown;
+    std::exception_ptr failure;
+    try {
+        result = checks.front().run(ctx(), check);
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(defaultMutex);
+        defaultDone = true;
+    }
+    defaultReturned.notify_all();
+    if (failure) {
+        for (auto &portfolioCheck : checks) {
+            portfolioCheck.cancel();
+        }
+    } else {
+        finish(0, result);
+    }
+    launcher.join();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    if (raced) {
+        portfolioStats.races++;
+        Z3_LOG("raced the solver portfolio after %d ms", PORTFOLIO_DELAY_MS);
+    }
+    int winnerIdx = winner;
+    if (winnerIdx == NO_WINNER) {
+        if (raced) {
+            portfolioStats.unknowns++;
+        }
+        return result;
+    }
+    if (winnerIdx == 0) {
+        return result;
+    }
+    portfolioStats.alternativeWins++;
+    auto &portfolioSolver = *solvers.at(winnerIdx - 1);
+    Z3_LOG("alternative configuration %d won the portfolio", winnerIdx - 1);
+    if (portfolioSolver.result == z3::sat) {
+        auto model = portfolioSolver.solver.get_model();
+        portfolioModel = z3::model(
+            ctx(), Z3_model_translate(portfolioSolver.context, model, ctx()));
+    }
+    return portfolioSolver.result;
+#else
+    BUG("The solver portfolio requires MULTITHREAD.");
+#endif  // MULTITHREAD
+}
+
+std::optional<bool> Z3Solver::checkSatSliced(const std::vector<const Constraint *> &asserts) {
+    slicedModel = std::nullopt;
+    auto clusters = sliceConstraints(asserts);
+
+    // Reuse the results of the clusters solved before.
+    SymbolicMapping model;
+    std::vector<const std::vector<const Constraint *> *> unsolvedClusters;
+    for (const auto &cluster : clusters) {
+        auto it = clusterResults.find(cluster);
+        if (it == clusterResults.end()) {
+            unsolvedClusters.push_back(&cluster);
+            continue;
+        }
+        if (!it->second) {
+            Z3_LOG("result:%s (cached)", "unsat");
+            return false;
+        }
+        model.insert(it->second->begin(), it->second->end());
+    }
+    Z3_LOG("sliced %d assertions into %d clusters, %d unsolved", asserts.size(), clusters.size(),
+           unsolvedClusters.size());
+
+    if (!unsolvedClusters.empty()) {
+        // Send the assertions of the unsolved clusters in their original order, so the common
+        // prefix with the previous invocation is kept as far as possible.
+        std::unordered_set<const Constraint *> unsolvedAsserts;
+        for (const auto *cluster : unsolvedClusters) {
+            unsolvedAsserts.insert(cluster->begin(), cluster->end());
+        }
+        std::vector<const Constraint *> unsolved;
+        for (const auto *assert : asserts) {
+            if (unsolvedAsserts.count(assert) != 0) {
+                unsolved.push_back(assert);
+            }
+        }
+        auto result = checkSatZ3(unsolved);
+        if (result == std::nullopt) {
+            return result;
+        }
+        // Bound the memory used by the cluster results and the variables of the constraints
+        // that were sliced but never asserted.
+        if (clusterResults.size() > MAX_CLUSTER_RESULTS) {
+            clusterResults.clear();
+        }
+        if (constraintVariables.size() > MAX_CLUSTER_RESULTS) {
+            constraintVariables.clear();
+        }
+        if (!result.value()) {
+            // Only a single unsolved cluster is known to be the unsatisfiable one.
+            if (unsolvedClusters.size() == 1) {
+                clusterResults.emplace(*unsolvedClusters.front(), std::nullopt);
+            }
+            return false;
+        }
+        const auto *z3Model = getZ3Mapping();
+        for (const auto *cluster : unsolvedClusters) {
+            SymbolicMapping clusterModel;
+            for (const auto *assert : *cluster) {
+                for (const auto *var : getConstraintVariables(assert)) {
+                    auto value = z3Model->find(var);
+                    if (value != z3Model->end()) {
+                        clusterModel.insert(*value);
+                    }
+                }
+            }
+            model.insert(clusterModel.begin(), clusterModel.end());
+            clusterResults.emplace(*cluster, std::move(clusterModel));
+        }
+    }
+    slicedModel = std::move(model);
+    return true;
+}
+
+std::vector<std::vector<const Constraint *>> Z3Solver::sliceConstraints(
+    const std::vector<const Constraint *> &asserts) {
+    // Union-find over the assertions, joining assertions that share a variable.
+    std::vector<size_t> parent(asserts.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    std::map<const IR::SymbolicVariable *, size_t, SymbolicVarComp> owners;
+    for (size_t i = 0; i < asserts.size(); i++) {
+        for (const auto *var : getConstraintVariables(asserts[i])) {
+            auto [owner, inserted] = owners.emplace(var, i);
+            if (!inserted) {
+                parent[find(i)] = find(owner->second);
+            }
+        }
+    }
+
+    std::vector<std::vector<const Constraint *>> clusters;
+    std::unordered_map<size_t, size_t> clusterIndex;
+    for (size_t i = 0; i < asserts.size(); i++) {
+        auto [index, inserted] = clusterIndex.emplace(find(i), clusters.size());
+        if (inserted) {
+            clusters.emplace_back();
+        }
+        clusters[index->second].push_back(asserts[i]);
+    }
+    return clusters;
+}
+
+const SymbolicSet &Z3Solver::getConstraintVariables(const Constraint *constraint) {
+    auto it = constraintVariables.find(constraint);
+    if (it != constraintVariables.end()) {
+        return it->second;
+    }
+    auto &variables = constraintVariables[constraint];
+    ToolsVariables::collectSymbolicVariables(constraint, variables);
+    return variables;
+}
+
 void Z3Solver::asrt(const Constraint *assertion) {
     CHECK_NULL(assertion);
     try {
-        Z3Translator z3translator(*this);
-        assertion->apply(z3translator);
-        auto expr = z3translator.getResult();
+        Util::ScopedTimer ctTranslate("translate");
+        auto expr = translate(assertion);
 
         Z3_LOG("add assertion '%s'", toString(expr));
         if (isIncremental) {
@@ -321,6 +770,13 @@ void Z3Solver::asrt(const Constraint *assertion) {
 
 const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     Util::ScopedTimer ctZ3("z3");
+    if (slicedModel) {
+        return *new SymbolicMapping(*slicedModel);
+    }
+    return *getZ3Mapping();
+}
+
+SymbolicMapping *Z3Solver::getZ3Mapping() const {
     auto *result = new SymbolicMapping();
     // First, collect a map of all the declared variables we have encountered in the stack.
     std::map<unsigned int, const IR::SymbolicVariable *> declaredVars;
@@ -333,7 +789,7 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     // Then, get the model and match each declaration in the model to its IR::SymbolicVariable.
     try {
         Util::ScopedTimer ctCheckSat("getModel");
-        auto z3Model = z3solver.get_model();
+        auto z3Model = portfolioModel ? *portfolioModel : z3solver.get_model();
         Z3_LOG("z3 model:%s", toString(z3Model));
 
         // Loop through each declaration in the Z3 model and convert to the output model.
@@ -347,6 +803,10 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
 
             // Convert to a symbolic variable and value.
             auto exprId = z3Expr.id();
+            // The tactics of the portfolio may add auxiliary declarations to their models.
+            if (portfolioModel && declaredVars.count(exprId) == 0) {
+                continue;
+            }
             BUG_CHECK(declaredVars.count(exprId) > 0, "Z3Solver: unknown variable declaration: %1%",
                       z3Expr);
             const auto *symbolicVar = declaredVars.at(exprId);
@@ -360,7 +820,7 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     } catch (...) {
         BUG("Z3Solver : unknown segmentation fault in getModel");
     }
-    return *result;
+    return result;
 }
 
 const IR::Literal *Z3Solver::toLiteral(const z3::expr &e, const IR::Type *type) {
@@ -414,6 +874,27 @@ void Z3Solver::addZ3Pushes(size_t &chkIndex, size_t asrtIndex) {
 
 const z3::solver &Z3Solver::getZ3Solver() const { return z3solver; }
 
+const Z3TranslationCacheStats &Z3Solver::getTranslationCacheStats() const {
+    return translationCacheStats;
+}
+
+void Z3Solver::setConstraintSlicing(bool enable) {
+    constraintSlicing = enable;
+    slicedModel = std::nullopt;
+}
+
+void Z3Solver::setPortfolio(bool enable) {
+#ifdef MULTITHREAD
+    portfolio = enable;
+#else
+    if (enable) {
+        ::warning("The solver portfolio requires multithreading. Solving without it.");
+    }
+#endif  // MULTITHREAD
+}
+
+const Z3PortfolioStats &Z3Solver::getPortfolioStats() const { return portfolioStats; }
+
 const z3::context &Z3Solver::getZ3Ctx() const { return z3solver.ctx(); }
 
 z3::context &Z3Solver::ctx() const { return z3solver.ctx(); }
@@ -452,16 +933,66 @@ Z3Solver::Z3Solver(bool isIncremental, std::optional<std::istream *> inOpt)
 
 Z3Translator::Z3Translator(Z3Solver &solver) : result(solver.ctx()), solver(solver) {}
 
+z3::expr Z3Solver::translate(const IR::Expression *expr) {
+    const TranslationCacheEntry *entry = nullptr;
+    auto byNode = translationsByNode.find(expr);
+    if (byNode != translationsByNode.end()) {
+        entry = byNode->second;
+    } else {
+        auto it = translationCache.find(expr);
+        if (it != translationCache.end()) {
+            entry = &it->second;
+            translationsByNode.emplace(expr, entry);
+        }
+    }
+
+    if (entry != nullptr) {
+        translationCacheStats.hits++;
+        translationCacheStats.saved += entry->translationTime;
+        BUG_CHECK(!declaredVarsById.empty(),
+                  "DeclaredVarsById should have at least one entry! Check if push() was used "
+                  "correctly.");
+        auto *latestVars = &declaredVarsById.back();
+        for (const auto &var : entry->vars) {
+            latestVars->emplace(var.first, var.second);
+        }
+        if (translationVars != nullptr) {
+            translationVars->insert(translationVars->end(), entry->vars.begin(), entry->vars.end());
+        }
+        return entry->result;
+    }
+
+    translationCacheStats.misses++;
+    DeclaredVars vars;
+    auto *outerVars = translationVars;
+    translationVars = &vars;
+    auto start = std::chrono::steady_clock::now();
+    Z3Translator translator(*this);
+    expr->apply(translator);
+    auto translationTime = std::chrono::steady_clock::now() - start;
+    translationVars = outerVars;
+
+    std::sort(vars.begin(), vars.end());
+    vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+    if (outerVars != nullptr) {
+        outerVars->insert(outerVars->end(), vars.begin(), vars.end());
+    }
+    auto it = translationCache
+                  .emplace(expr, TranslationCacheEntry{translator.getResult(), std::move(vars),
+                                                       translationTime})
+                  .first;
+    translationsByNode.emplace(expr, &it->second);
+    return it->second.result;
+}
+
 bool Z3Translator::preorder(const IR::Node *node) {
     BUG("%1%: Unhandled node type: %2%", node, node->node_type_name());
 }
 
 bool Z3Translator::preorder(const IR::Cast *cast) {
-    Z3Translator tCast(solver);
-    cast->expr->apply(tCast);
     uint64_t exprSize = 0;
     const auto *const castExtrType = cast->expr->type;
-    auto castExpr = tCast.result;
+    auto castExpr = solver.translate(cast->expr);
     if (const auto *tb = cast->destType->to<IR::Type_Bits>()) {
         uint64_t destSize = tb->width_bits();
         if (const auto *exprType = castExtrType->to<IR::Type_Bits>()) {
@@ -576,9 +1107,7 @@ const ShiftType *Z3Translator::rewriteShift(const ShiftType *shift) const {
 /// General function for unary operations.
 bool Z3Translator::recurseUnary(const IR::Operation_Unary *unary, Z3UnaryOp f) {
     BUG_CHECK(unary, "Z3Translator: encountered null node during translation");
-    Z3Translator tExpr(solver);
-    unary->expr->apply(tExpr);
-    result = f(tExpr.result);
+    result = f(solver.translate(unary->expr));
     return false;
 }
 
@@ -661,11 +1190,9 @@ bool Z3Translator::preorder(const IR::Concat *op) { return recurseBinary(op, z3:
 /// general function for binary operations
 bool Z3Translator::recurseBinary(const IR::Operation_Binary *binary, Z3BinaryOp f) {
     BUG_CHECK(binary, "Z3Translator: encountered null node during translation");
-    Z3Translator tLeft(solver);
-    Z3Translator tRight(solver);
-    binary->left->apply(tLeft);
-    binary->right->apply(tRight);
-    result = f(tLeft.result, tRight.result);
+    auto left = solver.translate(binary->left);
+    auto right = solver.translate(binary->right);
+    result = f(left, right);
     return false;
 }
 
@@ -681,13 +1208,10 @@ bool Z3Translator::preorder(const IR::Slice *op) {
 /// general function for ternary operations
 bool Z3Translator::recurseTernary(const IR::Operation_Ternary *ternary, Z3TernaryOp f) {
     BUG_CHECK(ternary, "Z3Translator: encountered null node during translation");
-    Z3Translator t0(solver);
-    Z3Translator t1(solver);
-    Z3Translator t2(solver);
-    ternary->e0->apply(t0);
-    ternary->e1->apply(t1);
-    ternary->e2->apply(t2);
-    result = f(t0.result, t1.result, t2.result);
+    auto e0 = solver.translate(ternary->e0);
+    auto e1 = solver.translate(ternary->e1);
+    auto e2 = solver.translate(ternary->e2);
+    result = f(e0, e1, e2);
     return false;
 }
 
@@ -3,15 +3,22 @@
 
 #include <z3++.h>
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
+#include "ir/structural_hash.h"
 #include "lib/cstring.h"
 #include "lib/ordered_map.h"
 #include "lib/safe_vector.h"
@@ -23,6 +30,34 @@ namespace P4Tools {
 /// pop() operations.
 using Z3DeclaredVariablesMap = std::vector<ordered_map<unsigned, const IR::SymbolicVariable *>>;
 
+class PortfolioAssertions;
+
+/// Statistics of the cache of translated expressions kept by Z3Solver.
+struct Z3TranslationCacheStats {
+    /// Number of expressions whose translation was found in the cache.
+    uint64_t hits = 0;
+
+    /// Number of expressions that had to be translated.
+    uint64_t misses = 0;
+
+    /// The time it took to translate the expressions that were later found in the cache, i.e.,
+    /// the translation time saved by the cache.
+    std::chrono::nanoseconds saved{0};
+};
+
+/// Statistics of the solver portfolio of Z3Solver.
+struct Z3PortfolioStats {
+    /// Number of queries the default configuration could not answer quickly, i.e., the number of
+    /// races between the configurations of the portfolio.
+    uint64_t races = 0;
+
+    /// Number of races won by an alternative configuration.
+    uint64_t alternativeWins = 0;
+
+    /// Number of races no configuration could answer.
+    uint64_t unknowns = 0;
+};
+
 /// A Z3-based implementation of AbstractSolver. Encapsulates a z3::solver and a z3::context.
 class Z3Solver : public AbstractSolver {
     friend class Z3Translator;
@@ -70,12 +105,62 @@ class Z3Solver : public AbstractSolver {
 
     /// Reset the internal Z3 solver state (memory and active assertions).
     /// In incremental state, all active assertions are reapplied after resetting.
+    /// The cache of translated expressions is dropped, as it belongs to the released Z3 context.
     void clearMemory();
 
+    /// @returns the statistics of the cache of translated expressions.
+    [[nodiscard]] const Z3TranslationCacheStats &getTranslationCacheStats() const;
+
+    /// Enables or disables constraint independence slicing in @ref checkSat. When enabled, the
+    /// assertions are partitioned into clusters that do not share any variable. Clusters that
+    /// were solved before reuse their result and model, only the other clusters are sent to Z3.
+    void setConstraintSlicing(bool enable);
+
+    /// Enables or disables the solver portfolio. When enabled, queries the default configuration
+    /// does not answer within PORTFOLIO_DELAY_MS are raced against alternative Z3 configurations
+    /// for the rest of the timeout, while the default configuration keeps checking. Each
+    /// configuration runs on its own thread with its own Z3 context, the first definite answer
+    /// wins. Queries that no configuration answers still return std::nullopt. Without
+    /// MULTITHREAD, enabling the portfolio only emits a warning and the solver keeps checking
+    /// queries with the default configuration alone.
+    void setPortfolio(bool enable);
+
+    /// @returns the statistics of the solver portfolio.
+    [[nodiscard]] const Z3PortfolioStats &getPortfolioStats() const;
+
  private:
+    /// The time in milliseconds the default configuration gets before the portfolio is started.
+    static constexpr unsigned PORTFOLIO_DELAY_MS = 200;
+
     /// Inserts an assertion into the topmost solver context.
     void asrt(const Constraint *assertion);
 
+    /// Checks the satisfiability of @asserts with Z3, reusing the assertions of the previous
+    /// invocation that form a common prefix with @asserts.
+    std::optional<bool> checkSatZ3(const std::vector<const Constraint *> &asserts);
+
+    /// Checks the satisfiability of the asserted constraints with the solver portfolio.
+    z3::check_result checkPortfolio();
+
+    /// Implements @ref checkSat with constraint independence slicing.
+    std::optional<bool> checkSatSliced(const std::vector<const Constraint *> &asserts);
+
+    /// Partitions @asserts into clusters such that no two clusters share a variable. The
+    /// assertions in each cluster keep their order in @asserts.
+    std::vector<std::vector<const Constraint *>> sliceConstraints(
+        const std::vector<const Constraint *> &asserts);
+
+    /// @returns the variables occurring in @constraint. Results are memoized per constraint.
+    const SymbolicSet &getConstraintVariables(const Constraint *constraint);
+
+    /// @returns the model of the last satisfiable Z3 invocation.
+    [[nodiscard]] SymbolicMapping *getZ3Mapping() const;
+
+    /// Translates @expr to Z3, reusing the translation of any structurally equal expression
+    /// translated before. The variables occurring in @expr are declared in the topmost solver
+    /// context, also when the translation is reused.
+    z3::expr translate(const IR::Expression *expr);
+
     /// Converts a P4 type to a Z3 sort.
     z3::sort toSort(const IR::Type *type);
 
@@ -127,6 +212,69 @@ class Z3Solver : public AbstractSolver {
 
     /// Stores the timeout, as last set by @ref timeout.
     std::optional<unsigned> timeout_;
+
+    /// Z3 expression IDs of declared variables together with the corresponding state variables.
+    using DeclaredVars = std::vector<std::pair<unsigned, const IR::SymbolicVariable *>>;
+
+    /// A translated expression.
+    struct TranslationCacheEntry {
+        /// The result of the translation.
+        z3::expr result;
+
+        /// The variables occurring in @ref result. They are declared again whenever the entry is
+        /// reused, as the solver context that first declared them may have been popped.
+        DeclaredVars vars;
+
+        /// The time it took to translate @ref expr.
+        std::chrono::nanoseconds translationTime;
+    };
+
+    /// The structural hashes of the expressions looked up in @ref translationCache. Translating
+    /// an expression looks up its subexpressions too, so their hashes are computed only once.
+    IR::StructuralHashMemo translationHashes;
+
+    /// Translated expressions. Structurally equal expressions share an entry.
+    std::unordered_map<const IR::Expression *, TranslationCacheEntry, IR::StructuralHash,
+                       IR::StructuralEquiv>
+        translationCache{0, IR::StructuralHash(&translationHashes)};
+
+    /// Maps expressions to their entry in @ref translationCache, avoiding the structural lookup
+    /// for expressions that are translated repeatedly.
+    std::unordered_map<const IR::Expression *, const TranslationCacheEntry *> translationsByNode;
+
+    /// Collects the variables declared by the translation in progress, if any.
+    DeclaredVars *translationVars = nullptr;
+
+    Z3TranslationCacheStats translationCacheStats;
+
+    /// Whether @ref checkSat slices the assertions into independent clusters.
+    bool constraintSlicing = false;
+
+    /// Memoized results of @ref getConstraintVariables. The entries of the popped assertions are
+    /// dropped by @ref pop, all entries are dropped by @ref reset.
+    std::unordered_map<const Constraint *, SymbolicSet> constraintVariables;
+
+    /// The results of the clusters solved so far: the model of a satisfiable cluster, or
+    /// std::nullopt if the cluster is unsatisfiable.
+    std::map<std::vector<const Constraint *>, std::optional<SymbolicMapping>> clusterResults;
+
+    /// The model of the last satisfiable invocation of @ref checkSat with slicing enabled,
+    /// combined from the models of its clusters.
+    std::optional<SymbolicMapping> slicedModel;
+
+    /// Whether @ref checkSat uses the solver portfolio.
+    bool portfolio = false;
+
+    Z3PortfolioStats portfolioStats;
+
+    /// The model of the last invocation of @ref checkSatZ3 if an alternative configuration of the
+    /// portfolio found it, translated into the context of this solver.
+    std::optional<z3::model> portfolioModel;
+
+    /// The assertions of this solver, kept in a Z3 context of their own for the alternative
+    /// configurations of the portfolio. Each query only adds the assertions that changed since
+    /// the previous one; the configurations copy them when they are started.
+    std::shared_ptr<PortfolioAssertions> portfolioAssertions;
 };
 
 }  // namespace P4Tools
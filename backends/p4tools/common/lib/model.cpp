@@ -3,6 +3,7 @@
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/container/vector.hpp>
 
@@ -16,6 +17,50 @@
 
 namespace P4Tools {
 
+namespace {
+
+/// Checks whether an expression can be evaluated with Model::evaluate: all its variables must be
+/// bound in the model and it must only consist of literals and operations whose constant folding
+/// agrees with the solver. Division, modulo, and shifts are excluded, as folding them may report
+/// diagnostics.
+class ModelEvaluable : public Inspector {
+    const Model &model;
+
+    bool evaluable = true;
+
+    bool reject() {
+        evaluable = false;
+        return false;
+    }
+
+ public:
+    explicit ModelEvaluable(const Model &model) : model(model) {}
+
+    [[nodiscard]] bool isEvaluable() const { return evaluable; }
+
+    bool preorder(const IR::Expression *expr) override {
+        if (!expr->is<IR::Operation>() && !expr->is<IR::Literal>()) {
+            evaluable = false;
+        }
+        return evaluable;
+    }
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        if (model.get(var, false) == nullptr) {
+            evaluable = false;
+        }
+        return false;
+    }
+
+    bool preorder(const IR::Member * /*member*/) override { return reject(); }
+    bool preorder(const IR::Div * /*div*/) override { return reject(); }
+    bool preorder(const IR::Mod * /*mod*/) override { return reject(); }
+    bool preorder(const IR::Shl * /*shl*/) override { return reject(); }
+    bool preorder(const IR::Shr * /*shr*/) override { return reject(); }
+};
+
+}  // namespace
+
 Model::SubstVisitor::SubstVisitor(const Model &model, bool doComplete)
     : self(model), doComplete(doComplete) {}
 
@@ -85,6 +130,24 @@ const IR::Literal *Model::evaluate(const IR::Expression *expr, bool doComplete,
     return literal;
 }
 
+bool Model::satisfies(const std::vector<const IR::Expression *> &constraints, size_t from) const {
+    if (from > constraints.size()) {
+        return false;
+    }
+    for (auto it = constraints.begin() + from; it != constraints.end(); ++it) {
+        ModelEvaluable evaluable(*this);
+        (*it)->apply(evaluable);
+        if (!evaluable.isEvaluable()) {
+            return false;
+        }
+        const auto *value = evaluate(*it, false)->to<IR::BoolLiteral>();
+        if (value == nullptr || !value->value) {
+            return false;
+        }
+    }
+    return true;
+}
+
 const IR::Expression *Model::get(const IR::SymbolicVariable *var, bool checked) const {
     auto it = symbolicMap.find(var);
     if (it != symbolicMap.end()) {
@@ -76,6 +76,12 @@ class Model {
     const IR::ListExpression *evaluateListExpr(const IR::ListExpression *listExpr, bool doComplete,
                                                ExpressionMap *resolvedExpressions = nullptr) const;
 
+    /// @returns true if this model satisfies the constraints in @param constraints starting at
+    /// index @param from. Returns false if this can not be decided without a solver, for example
+    /// because a variable is not bound in this model.
+    [[nodiscard]] bool satisfies(const std::vector<const IR::Expression *> &constraints,
+                                 size_t from = 0) const;
+
     /// Tries to retrieve @param var from the model.
     /// If @param checked is true, this function throws a BUG if the variable can not be found.
     /// Otherwise, it returns a nullptr.
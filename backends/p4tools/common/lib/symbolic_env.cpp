@@ -1,6 +1,8 @@
 #include "backends/p4tools/common/lib/symbolic_env.h"
 
 #include <algorithm>
+#include <limits>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -17,18 +19,71 @@
 
 namespace P4Tools {
 
+StateVariableIds &StateVariableIds::instance() {
+    static StateVariableIds INSTANCE;
+    return INSTANCE;
+}
+
+void StateVariableIds::cacheNode(const IR::Expression *node, Id id) {
+    if (idsByNode.size() >= MAX_CACHED_NODES) {
+        idsByNode.clear();
+    }
+    idsByNode.emplace(node, id);
+}
+
+std::optional<StateVariableIds::Id> StateVariableIds::find(const IR::StateVariable &var) {
+    auto &self = instance();
+    auto cached = self.idsByNode.find(var.ref);
+    if (cached != self.idsByNode.end()) {
+        return cached->second;
+    }
+    auto it = self.ids.find(var);
+    if (it == self.ids.end()) {
+        return std::nullopt;
+    }
+    self.cacheNode(var.ref, it->second);
+    return it->second;
+}
+
+StateVariableIds::Id StateVariableIds::get(const IR::StateVariable &var) {
+    if (auto id = find(var)) {
+        return *id;
+    }
+    auto &self = instance();
+    BUG_CHECK(self.variables.size() < std::numeric_limits<Id>::max(),
+              "Too many state variables to intern.");
+    auto id = static_cast<Id>(self.variables.size());
+    self.variables.push_back(var);
+    self.ids.emplace(var, id);
+    self.cacheNode(var.ref, id);
+    return id;
+}
+
+const IR::StateVariable &StateVariableIds::getVariable(Id id) {
+    auto &self = instance();
+    BUG_CHECK(id < self.variables.size(), "Unknown state variable ID %1%.", id);
+    return self.variables[id];
+}
+
 const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
-    auto it = map.find(var);
-    if (it != map.end()) {
-        return it->second;
+    auto id = StateVariableIds::find(var);
+    if (id && *id < values.size() && values[*id] != nullptr) {
+        return values[*id];
     }
     BUG("Unable to find var %s in the symbolic environment.", var);
 }
 
-bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.find(var) != map.end(); }
+bool SymbolicEnv::exists(const IR::StateVariable &var) const {
+    auto id = StateVariableIds::find(var);
+    return id && *id < values.size() && values[*id] != nullptr;
+}
 
 void SymbolicEnv::set(const IR::StateVariable &var, const IR::Expression *value) {
-    map[var] = P4::optimizeExpression(value);
+    auto id = StateVariableIds::get(var);
+    if (id >= values.size()) {
+        values.resize(id + 1, nullptr);
+    }
+    values[id] = P4::optimizeExpression(value);
 }
 
 const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
@@ -66,7 +121,17 @@ const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
     return expr->apply(SubstVisitor(*this));
 }
 
-const SymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
+SymbolicMapType SymbolicEnv::getInternalMap() const {
+    SymbolicMapType map;
+    for (StateVariableIds::Id id = 0; id < values.size(); id++) {
+        if (values[id] != nullptr) {
+            map.emplace(StateVariableIds::getVariable(id), values[id]);
+        }
+    }
+    return map;
+}
+
+const std::vector<const IR::Expression *> &SymbolicEnv::getValues() const { return values; }
 
 bool SymbolicEnv::isSymbolicValue(const IR::Node *node) {
     // Check the obvious case first.
@@ -1,17 +1,63 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 #include "backends/p4tools/common/lib/model.h"
 #include "ir/ir.h"
 #include "ir/node.h"
 
 namespace P4Tools {
 
+/// Interns state variables as small integer IDs. A variable gets its ID when it is first bound in
+/// a symbolic environment, and the ID stays valid for the rest of the run. Equal variables get
+/// the same ID, also if they are represented by different IR nodes.
+class StateVariableIds {
+ public:
+    using Id = uint32_t;
+
+    /// @returns the ID of @param var. Assigns a new ID if the variable does not have one yet.
+    static Id get(const IR::StateVariable &var);
+
+    /// @returns the ID of @param var, or std::nullopt if the variable does not have one yet.
+    static std::optional<Id> find(const IR::StateVariable &var);
+
+    /// @returns the state variable with the given ID.
+    static const IR::StateVariable &getVariable(Id id);
+
+ private:
+    /// The number of IR nodes whose ID is cached before the cache is cleared.
+    static constexpr size_t MAX_CACHED_NODES = 1 << 16;
+
+    /// The IDs of the interned variables.
+    std::map<IR::StateVariable, Id> ids;
+
+    /// The interned variables, indexed by their ID. A deque keeps references to the variables
+    /// valid while variables are added.
+    std::deque<IR::StateVariable> variables;
+
+    /// The IDs by the IR node that represents the variable. Most lookups are for the same nodes of
+    /// the program, so this avoids comparing Member chains in @ref ids.
+    std::unordered_map<const IR::Expression *, Id> idsByNode;
+
+    static StateVariableIds &instance();
+
+    /// Caches the ID of the variable represented by @param node.
+    void cacheNode(const IR::Expression *node, Id id);
+};
+
 /// A symbolic environment maps variables to their symbolic value. A symbolic value is just an
 /// expression on the program's initial state.
 class SymbolicEnv {
  private:
-    SymbolicMapType map;
+    /// The symbolic values of the state variables, indexed by their StateVariableIds. Unbound
+    /// variables have no value.
+    std::vector<const IR::Expression *> values;
 
  public:
     // Maybe coerce from Model for concrete execution?
@@ -30,8 +76,12 @@ class SymbolicEnv {
     /// Variables that are unbound by this environment are left untouched.
     const IR::Expression *subst(const IR::Expression *expr) const;
 
-    /// @returns The immutable map that is internal to this symbolic environment.
-    [[nodiscard]] const SymbolicMapType &getInternalMap() const;
+    /// @returns a map of all bound variables to their symbolic value, ordered by variable.
+    [[nodiscard]] SymbolicMapType getInternalMap() const;
+
+    /// @returns the symbolic values of the variables, indexed by their StateVariableIds. Unbound
+    /// variables have no value.
+    [[nodiscard]] const std::vector<const IR::Expression *> &getValues() const;
 
     /// Determines whether the given node represents a symbolic value. Symbolic values may be
     /// stored in the symbolic environment.
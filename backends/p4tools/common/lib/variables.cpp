@@ -5,9 +5,27 @@
 #include <tuple>
 
 #include "ir/id.h"
+#include "ir/visitor.h"
 
 namespace P4Tools::ToolsVariables {
 
+namespace {
+
+/// Collects the symbolic variables occurring in an expression.
+class SymbolicVariableCollector : public Inspector {
+    SymbolicSet &variables;
+
+ public:
+    explicit SymbolicVariableCollector(SymbolicSet &variables) : variables(variables) {}
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        variables.insert(var);
+        return false;
+    }
+};
+
+}  // namespace
+
 /// The prefix used for state variables.
 static const IR::PathExpression VAR_PREFIX = IR::PathExpression("p4tools*var");
 
@@ -62,4 +80,9 @@ IR::StateVariable convertReference(const IR::Expression *ref) {
     return path;
 }
 
+void collectSymbolicVariables(const IR::Expression *expr, SymbolicSet &variables) {
+    SymbolicVariableCollector collector(variables);
+    expr->apply(collector);
+}
+
 }  // namespace P4Tools::ToolsVariables
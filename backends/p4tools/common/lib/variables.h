@@ -1,6 +1,7 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_VARIABLES_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_VARIABLES_H_
 
+#include "backends/p4tools/common/core/solver.h"
 #include "ir/ir.h"
 #include "lib/cstring.h"
 
@@ -41,6 +42,9 @@ IR::StateVariable getHeaderValidity(const IR::Expression *headerRef);
 /// and IR::Member can be converted into a state variable.
 IR::StateVariable convertReference(const IR::Expression *ref);
 
+/// Inserts the symbolic variables that occur in @param expr into @param variables.
+void collectSymbolicVariables(const IR::Expression *expr, SymbolicSet &variables);
+
 }  // namespace P4Tools::ToolsVariables
 
 #endif /* BACKENDS_P4TOOLS_COMMON_LIB_VARIABLES_H_ */
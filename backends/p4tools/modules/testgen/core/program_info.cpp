@@ -11,6 +11,7 @@
 #include "lib/exceptions.h"
 #include "midend/coverage.h"
 
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/lib/concolic.h"
 #include "backends/p4tools/modules/testgen/lib/continuation.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -19,7 +20,10 @@ namespace P4Tools::P4Testgen {
 
 ProgramInfo::ProgramInfo(const IR::P4Program *program) : concolicMethodImpls({}), program(program) {
     concolicMethodImpls.add(*Concolic::getCoreConcolicMethodImpls());
-    if (TestgenOptions::get().dcg || !TestgenOptions::get().pattern.empty()) {
+    const auto &options = TestgenOptions::get();
+    // The distance-guided path selection uses the DCG to find uncovered nodes.
+    if (options.dcg || !options.pattern.empty() ||
+        options.pathSelectionPolicy == PathSelectionPolicy::DistanceStmtCoverage) {
         // Create DCG.
         auto *currentDCG = new NodesCallGraph("NodesCallGraph");
         P4ProgramDCGCreator dcgCreator(currentDCG);
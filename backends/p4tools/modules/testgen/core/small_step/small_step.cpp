@@ -72,6 +72,12 @@ SmallStepEvaluator::SmallStepEvaluator(AbstractSolver &solver, const ProgramInfo
         reachabilityEngine =
             new ReachabilityEngine(*programInfo.dcg, TestgenOptions::get().pattern, true);
     }
+    // Merged states do not follow a single sequence of branch decisions.
+    const auto &options = TestgenOptions::get();
+    if (options.stateMerging && options.pattern.empty() && options.selectedBranches.empty() &&
+        !options.trackBranches) {
+        stateMerger = new StateMerger();
+    }
 }
 
 void SmallStepEvaluator::renginePostprocessing(ReachabilityResult &result,
@@ -237,6 +243,15 @@ SmallStepEvaluator::Result SmallStepEvaluator::step(ExecutionState &state) {
     BUG_CHECK(!state.isTerminal(), "Tried to step from a terminal state.");
 
     if (const auto cmdOpt = state.getNextCmd()) {
+        // Parser states are the join points at which states are merged.
+        if (const auto *const *node = std::get_if<const IR::Node *>(&*cmdOpt);
+            stateMerger != nullptr && node != nullptr) {
+            if (const auto *parserState = (*node)->to<IR::ParserState>()) {
+                if (stateMerger->arrive(state, parserState)) {
+                    return new std::vector<Branch>();
+                }
+            }
+        }
         return std::visit(CommandVisitor(*this, state), *cmdOpt);
     }
     // State has an empty body. Pop the continuation stack.
@@ -244,4 +259,10 @@ SmallStepEvaluator::Result SmallStepEvaluator::step(ExecutionState &state) {
     return new std::vector<Branch>({Branch(state)});
 }
 
+ExecutionState *SmallStepEvaluator::releaseParkedState() {
+    return stateMerger == nullptr ? nullptr : stateMerger->release();
+}
+
+const StateMerger *SmallStepEvaluator::getStateMerger() const { return stateMerger; }
+
 }  // namespace P4Tools::P4Testgen
@@ -13,6 +13,7 @@
 #include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/small_step/state_merger.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 
 namespace P4Tools::P4Testgen {
@@ -65,6 +66,9 @@ class SmallStepEvaluator {
     /// Reachability engine.
     ReachabilityEngine *reachabilityEngine = nullptr;
 
+    /// Merges states that reach the same parser state, if state merging is enabled.
+    StateMerger *stateMerger = nullptr;
+
     using REngineType = std::pair<ReachabilityResult, std::vector<SmallStepEvaluator::Branch> *>;
 
     static void renginePostprocessing(ReachabilityResult &result,
@@ -74,8 +78,17 @@ class SmallStepEvaluator {
                                      const IR::Node *node);
 
  public:
+    /// Takes a step from @param state. Returns no branches if state merging is enabled and the
+    /// state was parked before a parser state, to be merged with other states.
     Result step(ExecutionState &state);
 
+    /// @returns a state that was parked for state merging and continues execution, or nullptr if
+    /// no state is parked.
+    ExecutionState *releaseParkedState();
+
+    /// @returns the state merger, or nullptr if state merging is disabled.
+    [[nodiscard]] const StateMerger *getStateMerger() const;
+
     SmallStepEvaluator(AbstractSolver &solver, const ProgramInfo &programInfo);
 };
 
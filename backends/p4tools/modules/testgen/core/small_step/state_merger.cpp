@@ -0,0 +1,44 @@
+#include "backends/p4tools/modules/testgen/core/small_step/state_merger.h"
+
+#include <vector>
+
+#include "lib/log.h"
+
+namespace P4Tools::P4Testgen {
+
+bool StateMerger::arrive(ExecutionState &state, const IR::ParserState *parserState) {
+    if (releasedStates.erase(&state) > 0 || state.getMergeCount() >= MAX_MERGES) {
+        return false;
+    }
+    auto &parked = parkedStates[parserState];
+    for (auto *&parkedState : parked) {
+        if (parkedState->getMergeCount() + state.getMergeCount() < MAX_MERGES &&
+            parkedState->isMergeableWith(state, MAX_DIFFERING_VARIABLES)) {
+            LOG1("Merging execution state into parked state at " << parserState->name);
+            parkedState = &parkedState->merge(state);
+            stats.merged++;
+            return true;
+        }
+    }
+    parked.push_back(&state);
+    stats.parked++;
+    return true;
+}
+
+ExecutionState *StateMerger::release() {
+    if (parkedStates.empty()) {
+        return nullptr;
+    }
+    auto first = parkedStates.begin();
+    auto *state = first->second.front();
+    first->second.erase(first->second.begin());
+    if (first->second.empty()) {
+        parkedStates.erase(first);
+    }
+    releasedStates.insert(state);
+    return state;
+}
+
+const StateMerger::Stats &StateMerger::getStats() const { return stats; }
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,63 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SMALL_STEP_STATE_MERGER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SMALL_STEP_STATE_MERGER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "ir/ir.h"
+#include "lib/ordered_map.h"
+
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Merges execution states at the join points of parsers. A state that is about to execute a
+/// parser state is parked until exploration is exhausted. Other states that reach the same
+/// parser state with the same continuation are merged into the parked state, so parsers with
+/// loops or several paths to the same state are not explored once per path.
+///
+/// Every merge makes the path constraints of a state larger, so states are only merged a bounded
+/// number of times and only if few of their variables differ.
+class StateMerger {
+ public:
+    /// The maximal number of merges that a single state may be the result of.
+    static constexpr uint16_t MAX_MERGES = 16;
+
+    /// The maximal number of variables that may differ between two merged states.
+    static constexpr size_t MAX_DIFFERING_VARIABLES = 32;
+
+    /// Counters of the merges.
+    struct Stats {
+        /// Number of states that were parked at a parser state.
+        uint64_t parked = 0;
+
+        /// Number of states that were merged into a parked state.
+        uint64_t merged = 0;
+    };
+
+    /// Called before @param state executes @param parserState. @returns true if the state was
+    /// parked or merged into a parked state, in which case it must not be executed further.
+    bool arrive(ExecutionState &state, const IR::ParserState *parserState);
+
+    /// Removes a parked state, which then continues execution past its parser state.
+    /// @returns nullptr if no state is parked.
+    ExecutionState *release();
+
+    /// @returns the counters of the merges.
+    [[nodiscard]] const Stats &getStats() const;
+
+ private:
+    /// The parked states, by the parser state they are about to execute.
+    ordered_map<const IR::ParserState *, std::vector<ExecutionState *>> parkedStates;
+
+    /// Released states that have not executed their parser state yet.
+    std::set<const ExecutionState *> releasedStates;
+
+    Stats stats;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SMALL_STEP_STATE_MERGER_H_ */
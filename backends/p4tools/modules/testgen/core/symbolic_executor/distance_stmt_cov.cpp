@@ -0,0 +1,291 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/distance_stmt_cov.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "backends/p4tools/common/core/solver.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+#include "lib/timer.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4Tools::P4Testgen {
+
+DistanceStmtSelection::DistanceStmtSelection(AbstractSolver &solver,
+                                             const ProgramInfo &programInfo)
+    : SymbolicExecutor(solver, programInfo) {
+    const auto *dcg = programInfo.dcg;
+    BUG_CHECK(dcg != nullptr, "Distance-guided path selection requires the DCG of the program.");
+    for (const auto &[vertex, vertexSuccessors] : *dcg) {
+        for (const auto *successor : *vertexSuccessors) {
+            predecessors[successor].push_back(vertex);
+            successors[vertex].push_back(successor);
+        }
+    }
+    const auto &coveredNodes = getVisitedNodes();
+    for (const auto *vertex : dcg->nodes) {
+        if (coverableNodes.count(vertex) != 0U && coveredNodes.count(vertex) == 0U) {
+            uncoveredTargets.push_back(vertex);
+        }
+    }
+    computeDistances();
+}
+
+void DistanceStmtSelection::computeDistances() {
+    distancesCoverage = getVisitedNodes().size();
+    distances.clear();
+
+    // Breadth-first search along the reversed edges, starting at all uncovered nodes.
+    std::deque<const DCGVertexType *> worklist;
+    for (const auto *target : uncoveredTargets) {
+        if (distances.emplace(target, 0).second) {
+            worklist.push_back(target);
+        }
+    }
+    while (!worklist.empty()) {
+        const auto *vertex = worklist.front();
+        worklist.pop_front();
+        auto vertexPredecessors = predecessors.find(vertex);
+        if (vertexPredecessors == predecessors.end()) {
+            continue;
+        }
+        auto distance = distances.at(vertex) + 1;
+        for (const auto *predecessor : vertexPredecessors->second) {
+            if (distances.emplace(predecessor, distance).second) {
+                worklist.push_back(predecessor);
+            }
+        }
+    }
+}
+
+void DistanceStmtSelection::updateDistances() {
+    const auto &coveredNodes = getVisitedNodes();
+    if (coveredNodes.size() == distancesCoverage) {
+        return;
+    }
+    distancesCoverage = coveredNodes.size();
+
+    // The targets covered since the last update are no longer sources of the search.
+    std::deque<const DCGVertexType *> worklist;
+    std::unordered_set<const DCGVertexType *> affected;
+    size_t kept = 0;
+    for (const auto *target : uncoveredTargets) {
+        if (coveredNodes.count(target) != 0U) {
+            affected.insert(target);
+            worklist.push_back(target);
+        } else {
+            uncoveredTargets[kept++] = target;
+        }
+    }
+    uncoveredTargets.resize(kept);
+    if (affected.empty()) {
+        return;
+    }
+
+    // A vertex keeps its distance if one of its successors that keeps its distance is one step
+    // closer. Vertices are collected in the order of their distance, so the successors of a
+    // vertex have been decided when the vertex is checked.
+    auto keepsDistance = [this, &affected](const DCGVertexType *vertex, size_t distance) {
+        auto vertexSuccessors = successors.find(vertex);
+        if (vertexSuccessors == successors.end()) {
+            return false;
+        }
+        return std::any_of(vertexSuccessors->second.begin(), vertexSuccessors->second.end(),
+                           [this, &affected, distance](const DCGVertexType *successor) {
+                               auto successorDistance = distances.find(successor);
+                               return successorDistance != distances.end() &&
+                                      successorDistance->second + 1 == distance &&
+                                      affected.count(successor) == 0U;
+                           });
+    };
+    while (!worklist.empty()) {
+        const auto *vertex = worklist.front();
+        worklist.pop_front();
+        auto vertexPredecessors = predecessors.find(vertex);
+        if (vertexPredecessors == predecessors.end()) {
+            continue;
+        }
+        auto distance = distances.at(vertex) + 1;
+        for (const auto *predecessor : vertexPredecessors->second) {
+            auto predecessorDistance = distances.find(predecessor);
+            if (predecessorDistance == distances.end() || predecessorDistance->second != distance ||
+                affected.count(predecessor) != 0U || keepsDistance(predecessor, distance)) {
+                continue;
+            }
+            affected.insert(predecessor);
+            worklist.push_back(predecessor);
+        }
+    }
+
+    // Search the new distances of the affected vertices, starting from the closest successor of
+    // each that kept its distance.
+    for (const auto *vertex : affected) {
+        distances.erase(vertex);
+    }
+    using QueueEntry = std::pair<size_t, const DCGVertexType *>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+    for (const auto *vertex : affected) {
+        auto vertexSuccessors = successors.find(vertex);
+        if (vertexSuccessors == successors.end()) {
+            continue;
+        }
+        size_t distance = UNREACHABLE;
+        for (const auto *successor : vertexSuccessors->second) {
+            auto successorDistance = distances.find(successor);
+            if (successorDistance != distances.end()) {
+                distance = std::min(distance, successorDistance->second + 1);
+            }
+        }
+        if (distance != UNREACHABLE) {
+            queue.emplace(distance, vertex);
+        }
+    }
+    while (!queue.empty()) {
+        auto [distance, vertex] = queue.top();
+        queue.pop();
+        if (!distances.emplace(vertex, distance).second) {
+            continue;
+        }
+        auto vertexPredecessors = predecessors.find(vertex);
+        if (vertexPredecessors == predecessors.end()) {
+            continue;
+        }
+        for (const auto *predecessor : vertexPredecessors->second) {
+            if (affected.count(predecessor) != 0U && distances.count(predecessor) == 0U) {
+                queue.emplace(distance + 1, predecessor);
+            }
+        }
+    }
+}
+
+size_t DistanceStmtSelection::getDistance(const Branch &branch) {
+    const auto &nextState = branch.nextState.get();
+    // The branch has already covered new nodes.
+    const auto &visited = nextState.getVisited();
+    auto &firstUncovered =
+        firstUncoveredVisits.try_emplace(&nextState, visited.begin()).first->second;
+    while (firstUncovered != visited.end() && visitedNodes.count(*firstUncovered) != 0U) {
+        ++firstUncovered;
+    }
+    if (firstUncovered != visited.end()) {
+        return 0;
+    }
+
+    size_t distance = UNREACHABLE;
+    auto updateDistance = [this, &distance](const IR::Node *node) {
+        auto vertexDistance = distances.find(node);
+        if (vertexDistance != distances.end()) {
+            distance = std::min(distance, vertexDistance->second);
+        }
+    };
+    for (const auto *node : branch.potentialStatements) {
+        updateDistance(node);
+    }
+    if (const auto cmdOpt = nextState.getNextCmd()) {
+        if (const auto *const *node = std::get_if<const IR::Node *>(&*cmdOpt)) {
+            updateDistance(*node);
+        }
+    }
+    return distance;
+}
+
+SymbolicExecutor::Branch DistanceStmtSelection::popClosestBranch(
+    std::vector<Branch> &candidateBranches) {
+    // Only perform a guided search if we are still producing tests consistently.
+    // This guard is necessary to avoid getting caught in parser loops.
+    if (stepsWithoutTest < MAX_STEPS_WITHOUT_TEST) {
+        updateDistances();
+        size_t closestDistance = UNREACHABLE;
+        size_t closestIdx = 0;
+        // Prefer the most recent branches on ties, which finishes the current path first.
+        for (size_t idx = candidateBranches.size(); idx > 0 && closestDistance > 0; --idx) {
+            auto distance = getDistance(candidateBranches[idx - 1]);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closestIdx = idx - 1;
+            }
+        }
+        if (closestDistance != UNREACHABLE) {
+            auto branch = candidateBranches[closestIdx];
+            candidateBranches[closestIdx] = candidateBranches.back();
+            candidateBranches.pop_back();
+            // The state of the branch is about to be executed.
+            firstUncoveredVisits.erase(&branch.nextState.get());
+            return branch;
+        }
+    }
+    auto branch = popRandomBranch(candidateBranches);
+    firstUncoveredVisits.erase(&branch.nextState.get());
+    return branch;
+}
+
+std::optional<ExecutionStateReference> DistanceStmtSelection::pickSuccessor(
+    StepResult successors) {
+    if (successors->empty()) {
+        return std::nullopt;
+    }
+    // If there is only one successor, choose it and move on.
+    if (successors->size() == 1) {
+        return successors->at(0).nextState;
+    }
+
+    stepsWithoutTest++;
+    auto nextState = popClosestBranch(*successors).nextState;
+    // Add the remaining branches to the unexplored branches.
+    unexploredBranches.insert(unexploredBranches.end(), successors->begin(), successors->end());
+    return nextState;
+}
+
+void DistanceStmtSelection::runImpl(const Callback &callBack,
+                                    ExecutionStateReference executionState) {
+    while (true) {
+        try {
+            if (executionState.get().isTerminal()) {
+                // We've reached the end of the program. Call back and (if desired) end execution.
+                bool terminate = handleTerminalState(callBack, executionState);
+                stepsWithoutTest = 0;
+                if (terminate) {
+                    return;
+                }
+            } else {
+                // Take a step in the program, choose a branch, and continue execution. If
+                // branch selection fails, fall through to the roll-back code below.
+                StepResult successors = step(executionState);
+                auto nextState = pickSuccessor(successors);
+                if (nextState.has_value()) {
+                    executionState = nextState.value();
+                    continue;
+                }
+            }
+        } catch (TestgenUnimplemented &e) {
+            // If strict is enabled, bubble the exception up.
+            if (TestgenOptions::get().strict) {
+                throw;
+            }
+            // Otherwise we try to roll back as we typically do.
+            ::warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+        }
+
+        // Roll back to the unexplored branch that is closest to an uncovered node. If there are
+        // no more branches to explore, finish execution.
+        if (unexploredBranches.empty()) {
+            return;
+        }
+        Util::ScopedTimer chooseBranchtimer("branch_selection");
+        executionState = popClosestBranch(unexploredBranches).nextState;
+    }
+}
+
+}  // namespace P4Tools::P4Testgen
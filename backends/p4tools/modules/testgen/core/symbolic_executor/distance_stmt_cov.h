@@ -0,0 +1,104 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DISTANCE_STMT_COV_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DISTANCE_STMT_COV_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "backends/p4tools/common/compiler/reachability.h"
+#include "backends/p4tools/common/core/solver.h"
+#include "midend/coverage.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Path selection strategy guided by the control-flow graph (DCG) of the program. For every
+/// vertex of the DCG, the strategy knows the length of the shortest path to a coverable node that
+/// has not been covered yet. At branch points and when rolling back, it picks the branch that is
+/// closest to an uncovered node, based on the statements the branch covers or potentially covers.
+/// The distances are updated whenever coverage grows. Like the greedy strategy, it falls back to
+/// random selection when it cycles without producing a test.
+class DistanceStmtSelection : public SymbolicExecutor {
+ public:
+    /// Executes the P4 program along a randomly chosen path. When the program terminates, the
+    /// given callback is invoked. If the callback returns true, then the executor terminates.
+    /// Otherwise, execution of the P4 program continues on a different random path.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// Constructor for this strategy, considering inheritance. Requires the DCG of the program.
+    DistanceStmtSelection(AbstractSolver &solver, const ProgramInfo &programInfo);
+
+ private:
+    /// The distance of branches that can not reach an uncovered node.
+    static constexpr size_t UNREACHABLE = std::numeric_limits<size_t>::max();
+
+    /// The maximum number of steps without generating a test before falling back to random.
+    static const uint64_t MAX_STEPS_WITHOUT_TEST = 1000;
+
+    /// This variable keeps track of how many branch decisions we have made without producing a
+    /// test. This is a safety guard in case the strategy gets stuck in parser loops.
+    uint64_t stepsWithoutTest = 0;
+
+    /// The predecessors of each vertex in the DCG.
+    std::unordered_map<const DCGVertexType *, std::vector<const DCGVertexType *>> predecessors;
+
+    /// The successors of each vertex in the DCG.
+    std::unordered_map<const DCGVertexType *, std::vector<const DCGVertexType *>> successors;
+
+    /// The coverable nodes that are vertices of the DCG and were not covered when
+    /// @ref distances was computed.
+    std::vector<const DCGVertexType *> uncoveredTargets;
+
+    /// For each vertex of the DCG from which an uncovered node can be reached, the length of the
+    /// shortest path to such a node.
+    std::unordered_map<const DCGVertexType *, size_t> distances;
+
+    /// The number of visited nodes when @ref distances was computed.
+    size_t distancesCoverage = 0;
+
+    /// For the state of each branch that has been scored and not been picked yet, the first
+    /// node visited by the state that was not covered when the branch was last scored. The
+    /// visited nodes of a pending state do not change and covered nodes stay covered, so the
+    /// nodes before it do not need to be checked again.
+    std::unordered_map<const ExecutionState *, P4::Coverage::CoverageSet::const_iterator>
+        firstUncoveredVisits;
+
+    /// Branches that have not been explored yet.
+    ///
+    /// Invariants:
+    ///   - Each element's path constraints are satisfiable.
+    std::vector<Branch> unexploredBranches;
+
+    /// Computes @ref distances with a breadth-first search over the reversed edges of the DCG,
+    /// starting at the uncovered targets.
+    void computeDistances();
+
+    /// Updates @ref distances if coverage has grown since they were computed. Covering a target
+    /// only affects the vertices whose shortest paths led to it: the update first collects those
+    /// vertices, then searches their new distances from the vertices around them that are not
+    /// affected. Its cost is proportional to the edges of the affected vertices, not of the DCG.
+    void updateDistances();
+
+    /// @returns the distance of @param branch to the closest uncovered node, or UNREACHABLE.
+    /// Checking whether the branch covers new nodes resumes where the previous check of the
+    /// branch stopped, so nodes that were found covered are not checked again.
+    [[nodiscard]] size_t getDistance(const Branch &branch);
+
+    /// Removes and returns the branch from @param candidateBranches that is closest to an
+    /// uncovered node. Picks a random branch if none can reach an uncovered node or if the
+    /// strategy has cycled without a test for too long.
+    Branch popClosestBranch(std::vector<Branch> &candidateBranches);
+
+    /// Picks a successor from the given successors and adds the others to the unexplored
+    /// branches. Returns none if there are no successors.
+    [[nodiscard]] std::optional<ExecutionStateReference> pickSuccessor(StepResult successors);
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DISTANCE_STMT_COV_H_ */
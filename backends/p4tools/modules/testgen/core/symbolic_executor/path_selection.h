@@ -10,11 +10,13 @@ enum class PathSelectionPolicy {
     RandomBacktrack,
     GreedyStmtCoverage,
     RandomMaxStmtCoverage,
+    DistanceStmtCoverage,
 };
 
 inline bool requiresLookahead(PathSelectionPolicy &pathSelectionPolicy) {
     static const std::set LOOKAHEAD_STRATEGYIES = {PathSelectionPolicy::GreedyStmtCoverage,
-                                                   PathSelectionPolicy::RandomMaxStmtCoverage};
+                                                   PathSelectionPolicy::RandomMaxStmtCoverage,
+                                                   PathSelectionPolicy::DistanceStmtCoverage};
     return LOOKAHEAD_STRATEGYIES.find(pathSelectionPolicy) != LOOKAHEAD_STRATEGYIES.end();
 }
 
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
 #include "lib/error.h"
@@ -39,6 +40,23 @@ SymbolicExecutor::StepResult SymbolicExecutor::step(ExecutionState &state) {
 
 void SymbolicExecutor::run(const Callback &callBack) {
     runImpl(callBack, ExecutionState::create(programInfo.program));
+    // States that were parked for state merging continue once exploration is exhausted. Branches
+    // whose check timed out are retried last. A branch that times out again is dropped.
+    while (!terminated) {
+        if (auto *parkedState = evaluator.releaseParkedState()) {
+            runImpl(callBack, *parkedState);
+            continue;
+        }
+        if (timedOutBranches.empty()) {
+            return;
+        }
+        auto branch = timedOutBranches.front();
+        timedOutBranches.pop_front();
+        if (checkWithSolver(branch.nextState, solver).value_or(false)) {
+            branchCheckStats.recoveredBranches++;
+            runImpl(callBack, branch.nextState);
+        }
+    }
 }
 
 bool SymbolicExecutor::handleTerminalState(const Callback &callback,
@@ -48,6 +66,7 @@ bool SymbolicExecutor::handleTerminalState(const Callback &callback,
     auto solverResult = solver.checkSat(terminalState.getPathConstraint());
     if (!solverResult) {
         ::warning("Solver timed out");
+        branchCheckStats.solverTimeouts++;
         return false;
     }
 
@@ -60,7 +79,8 @@ bool SymbolicExecutor::handleTerminalState(const Callback &callback,
     // final symbolic environment and trace, use it to evaluate the
     // final execution state, and finally delegate to the callback.
     const FinalState finalState(solver, terminalState);
-    return callback(finalState);
+    terminated = callback(finalState);
+    return terminated;
 }
 
 bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
@@ -71,12 +91,36 @@ bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
         return boolLiteral->value;
     }
 
+    // Most branches only add conditions that the model of the parent state already satisfies.
+    auto &nextState = branch.nextState.get();
+    const auto &pathConstraint = nextState.getPathConstraint();
+    auto [model, modelSize] = nextState.getPathModel();
+    if (model != nullptr && model->satisfies(pathConstraint, modelSize)) {
+        branchCheckStats.modelHits++;
+        nextState.setPathModel(model);
+        return true;
+    }
+
     // Check the consistency of the path constraints asserted so far.
-    auto solverResult = solver.checkSat(branch.nextState.get().getPathConstraint());
+    auto solverResult = checkWithSolver(nextState, solver);
+    if (solverResult == std::nullopt) {
+        timedOutBranches.push_back(branch);
+        return false;
+    }
+    return *solverResult;
+}
+
+std::optional<bool> SymbolicExecutor::checkWithSolver(ExecutionState &state,
+                                                      AbstractSolver &solver) {
+    branchCheckStats.solverQueries++;
+    auto solverResult = solver.checkSat(state.getPathConstraint());
     if (solverResult == std::nullopt) {
         ::warning("Solver timed out");
+        branchCheckStats.solverTimeouts++;
+    } else if (*solverResult) {
+        state.setPathModel(new Model(solver.getSymbolicMapping()));
     }
-    return solverResult.value_or(false);
+    return solverResult;
 }
 
 SymbolicExecutor::Branch SymbolicExecutor::popRandomBranch(
@@ -107,6 +151,12 @@ void SymbolicExecutor::updateVisitedNodes(const P4::Coverage::CoverageSet &newNo
 
 const P4::Coverage::CoverageSet &SymbolicExecutor::getVisitedNodes() { return visitedNodes; }
 
+const SymbolicExecutor::BranchCheckStats &SymbolicExecutor::getBranchCheckStats() const {
+    return branchCheckStats;
+}
+
+const StateMerger *SymbolicExecutor::getStateMerger() const { return evaluator.getStateMerger(); }
+
 void SymbolicExecutor::printCurrentTraceAndBranches(std::ostream &out,
                                                     const ExecutionState &executionState) {
     const auto &branchesList = executionState.getSelectedBranches();
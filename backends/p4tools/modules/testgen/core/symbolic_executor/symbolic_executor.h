@@ -1,8 +1,11 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iosfwd>
+#include <optional>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
@@ -57,6 +60,30 @@ class SymbolicExecutor {
     /// Update the set of visited statements.
     void updateVisitedNodes(const P4::Coverage::CoverageSet &newNodes);
 
+    /// Counters of the feasibility checks of branches.
+    struct BranchCheckStats {
+        /// Number of branches whose path constraints were satisfied by the model of the parent
+        /// state, i.e., the number of solver queries avoided.
+        uint64_t modelHits = 0;
+
+        /// Number of branches that were checked with the solver.
+        uint64_t solverQueries = 0;
+
+        /// Number of solver queries that timed out. Branches whose query timed out are deferred
+        /// until all other branches have been explored, terminal states whose query timed out
+        /// are dropped.
+        uint64_t solverTimeouts = 0;
+
+        /// Number of deferred branches that were found feasible when they were checked again.
+        uint64_t recoveredBranches = 0;
+    };
+
+    /// @returns the counters of the feasibility checks of branches.
+    [[nodiscard]] const BranchCheckStats &getBranchCheckStats() const;
+
+    /// @returns the state merger, or nullptr if state merging is disabled.
+    [[nodiscard]] const StateMerger *getStateMerger() const;
+
  protected:
     /// Target-specific information about the P4 program.
     const ProgramInfo &programInfo;
@@ -82,7 +109,9 @@ class SymbolicExecutor {
     /// Take a branch and a solver as input.
     /// Compute the branch's path conditions using the solver.
     /// Return true if the solver can find a solution and does not time out.
-    static bool evaluateBranch(const SymbolicExecutor::Branch &branch, AbstractSolver &solver);
+    /// The solver is not invoked if the model found for the parent state also satisfies the path
+    /// conditions added by the branch. If the solver times out, the branch is deferred.
+    bool evaluateBranch(const SymbolicExecutor::Branch &branch, AbstractSolver &solver);
 
     /// Select a branch at random from the input @param candidateBranches.
     //  Remove the branch from the container.
@@ -91,6 +120,20 @@ class SymbolicExecutor {
 
  private:
     SmallStepEvaluator evaluator;
+
+    BranchCheckStats branchCheckStats;
+
+    /// Branches whose feasibility check timed out, in the order they were checked. Their part of
+    /// the program is likely expensive to explore, so @ref run retries them only once the path
+    /// selection policy has explored all other branches.
+    std::deque<Branch> timedOutBranches;
+
+    /// Checks the path constraints of @param state with @param solver and sets the path model of
+    /// the state if they are satisfiable. @returns std::nullopt if the solver timed out.
+    std::optional<bool> checkWithSolver(ExecutionState &state, AbstractSolver &solver);
+
+    /// Set once the callback requested to end symbolic execution.
+    bool terminated = false;
 };
 
 }  // namespace P4Tools::P4Testgen
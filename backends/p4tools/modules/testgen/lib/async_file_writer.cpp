@@ -0,0 +1,112 @@
+#include "backends/p4tools/modules/testgen/lib/async_file_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "lib/error.h"
+
+namespace P4Tools::P4Testgen {
+
+bool AsyncFileWriter::writeFile(const Job &job) {
+    int flags = O_WRONLY | O_CREAT | (job.append ? O_APPEND : O_TRUNC);
+    int fd = open(job.path.c_str(), flags, 0666);
+    if (fd < 0) {
+        return false;
+    }
+    const char *data = job.content.data();
+    size_t left = job.content.size();
+    while (left > 0) {
+        auto written = ::write(fd, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            return false;
+        }
+        data += written;
+        left -= written;
+    }
+    return close(fd) == 0;
+}
+
+void AsyncFileWriter::reportFailure(const Job &job) {
+    if (job.failed) {
+        ::error(ErrorType::ERR_IO, "%1%: could not write test file", job.path.string());
+    }
+}
+
+#ifdef MULTITHREAD
+
+AsyncFileWriter::AsyncFileWriter(size_t capacity) : capacity(capacity) {
+    worker = std::thread(&AsyncFileWriter::run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobQueued.notify_all();
+    worker.join();
+}
+
+void AsyncFileWriter::write(std::filesystem::path path, std::string content, bool append) {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this] { return jobs.size() - done < capacity; });
+    reclaim();
+    jobs.push_back({std::move(path), std::move(content), append, false});
+    jobQueued.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [this] { return done == jobs.size(); });
+    reclaim();
+}
+
+void AsyncFileWriter::reclaim() {
+    for (; done > 0; done--) {
+        reportFailure(jobs.front());
+        jobs.pop_front();
+    }
+}
+
+void AsyncFileWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobQueued.wait(lock, [this] { return stopping || jobs.size() > done; });
+        if (jobs.size() == done) {
+            return;
+        }
+        // References to deque elements stay valid while other elements are added or removed.
+        auto &job = jobs[done];
+        lock.unlock();
+        job.failed = !writeFile(job);
+        lock.lock();
+        done++;
+        jobDone.notify_all();
+    }
+}
+
+#else
+
+AsyncFileWriter::AsyncFileWriter(size_t /*capacity*/) {}
+
+AsyncFileWriter::~AsyncFileWriter() = default;
+
+void AsyncFileWriter::write(std::filesystem::path path, std::string content, bool append) {
+    Job job{std::move(path), std::move(content), append, false};
+    job.failed = !writeFile(job);
+    reportFailure(job);
+}
+
+void AsyncFileWriter::flush() {}
+
+#endif  // MULTITHREAD
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,97 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_ASYNC_FILE_WRITER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_ASYNC_FILE_WRITER_H_
+
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <string>
+
+#ifdef MULTITHREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
+
+namespace P4Tools::P4Testgen {
+
+/// Writes files on a background thread, so test generation does not wait for the disk. Writes
+/// are queued and executed in order, so several writes to the same file produce the same result
+/// as writing synchronously. The queue is bounded: @ref write blocks while it is full.
+/// Failed writes are reported as errors by the thread that issues the writes.
+///
+/// Without MULTITHREAD, files are written synchronously.
+class AsyncFileWriter {
+ public:
+    /// The default maximal number of writes that may be pending.
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    explicit AsyncFileWriter(size_t capacity = DEFAULT_CAPACITY);
+
+    AsyncFileWriter(const AsyncFileWriter &) = delete;
+
+    AsyncFileWriter(AsyncFileWriter &&) = delete;
+
+    AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+    AsyncFileWriter &operator=(AsyncFileWriter &&) = delete;
+
+    /// Waits for all pending writes.
+    ~AsyncFileWriter();
+
+    /// Queues a write of @param content to the file at @param path. The file is truncated, unless
+    /// @param append is true.
+    void write(std::filesystem::path path, std::string content, bool append = false);
+
+    /// Blocks until all pending writes are done.
+    void flush();
+
+ private:
+    struct Job {
+        std::filesystem::path path;
+        std::string content;
+        bool append;
+        bool failed;
+    };
+
+    /// Executes @param job. Does not allocate, so it is safe to call from the writer thread.
+    /// @returns false if the file could not be written.
+    static bool writeFile(const Job &job);
+
+    /// Reports an error for @param job if it failed.
+    static void reportFailure(const Job &job);
+
+    /// Pending and completed writes. Completed writes are removed by the thread that issues the
+    /// writes, so the writer thread neither allocates nor frees memory.
+    std::deque<Job> jobs;
+
+#ifdef MULTITHREAD
+    /// Removes the completed writes from @ref jobs. Requires @ref mutex to be held.
+    void reclaim();
+
+    /// The loop of the writer thread.
+    void run();
+
+    /// The maximal number of pending writes.
+    size_t capacity;
+
+    /// The number of writes at the front of @ref jobs that are completed.
+    size_t done = 0;
+
+    /// Set to stop the writer thread.
+    bool stopping = false;
+
+    std::mutex mutex;
+
+    /// Signaled when a write is queued or the writer is stopping.
+    std::condition_variable jobQueued;
+
+    /// Signaled when a write is completed.
+    std::condition_variable jobDone;
+
+    std::thread worker;
+#endif  // MULTITHREAD
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_ASYNC_FILE_WRITER_H_ */
@@ -13,6 +13,23 @@
 
 namespace P4Tools::P4Testgen {
 
+big_int ConcolicCache::lookup(Key key,
+                              const std::function<big_int(const std::vector<char> &)> &compute) {
+    auto cached = results.find(key);
+    if (cached != results.end()) {
+        hits++;
+        return cached->second;
+    }
+    auto result = compute(key.second);
+    if (results.size() >= MAX_ENTRIES) {
+        results.clear();
+    }
+    results.emplace(std::move(key), result);
+    return result;
+}
+
+uint64_t ConcolicCache::getHits() const { return hits; }
+
 bool ConcolicMethodImpls::matches(const std::vector<cstring> &paramNames,
                                   const IR::Vector<IR::Argument> *args) {
     CHECK_NULL(args);
@@ -39,7 +56,8 @@ bool ConcolicMethodImpls::matches(const std::vector<cstring> &paramNames,
 
 bool ConcolicMethodImpls::exec(cstring concolicMethodName, const IR::ConcolicVariable *var,
                                const ExecutionState &state, const Model &evaluatedModel,
-                               ConcolicVariableMap *resolvedConcolicVariables) const {
+                               ConcolicVariableMap *resolvedConcolicVariables,
+                               ConcolicCache &cache) const {
     if (impls.count(concolicMethodName) == 0) {
         return false;
     }
@@ -66,7 +84,8 @@ bool ConcolicMethodImpls::exec(cstring concolicMethodName, const IR::ConcolicVar
     if (!matchingImpl) {
         return false;
     }
-    (*matchingImpl)(concolicMethodName, var, state, evaluatedModel, resolvedConcolicVariables);
+    (*matchingImpl)(concolicMethodName, var, state, evaluatedModel, resolvedConcolicVariables,
+                    cache);
     return true;
 }
 
@@ -99,7 +118,7 @@ bool ConcolicResolver::preorder(const IR::ConcolicVariable *var) {
     auto concolicReplacment = resolvedConcolicVariables.find(*var);
     if (concolicReplacment == resolvedConcolicVariables.end()) {
         bool found = concolicMethodImpls.exec(concolicMethodName, var, state, evaluatedModel,
-                                              &resolvedConcolicVariables);
+                                              &resolvedConcolicVariables, cache);
         BUG_CHECK(found, "Unknown or unimplemented concolic method: %1%", concolicMethodName);
     }
     return false;
@@ -110,18 +129,24 @@ const ConcolicVariableMap *ConcolicResolver::getResolvedConcolicVariables() cons
 }
 
 ConcolicResolver::ConcolicResolver(const Model &evaluatedModel, const ExecutionState &state,
-                                   const ConcolicMethodImpls &concolicMethodImpls)
-    : state(state), evaluatedModel(evaluatedModel), concolicMethodImpls(concolicMethodImpls) {
+                                   const ConcolicMethodImpls &concolicMethodImpls,
+                                   ConcolicCache &cache)
+    : state(state),
+      evaluatedModel(evaluatedModel),
+      concolicMethodImpls(concolicMethodImpls),
+      cache(cache) {
     visitDagOnce = false;
 }
 
 ConcolicResolver::ConcolicResolver(const Model &evaluatedModel, const ExecutionState &state,
                                    const ConcolicMethodImpls &concolicMethodImpls,
+                                   ConcolicCache &cache,
                                    ConcolicVariableMap resolvedConcolicVariables)
     : state(state),
       evaluatedModel(evaluatedModel),
       resolvedConcolicVariables(std::move(resolvedConcolicVariables)),
-      concolicMethodImpls(concolicMethodImpls) {
+      concolicMethodImpls(concolicMethodImpls),
+      cache(cache) {
     visitDagOnce = false;
 }
 
@@ -3,8 +3,11 @@
 
 #include <sys/types.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <map>
 #include <tuple>
 #include <utility>
 #include <variant>
@@ -14,6 +17,7 @@
 #include "ir/ir.h"
 #include "ir/vector.h"
 #include "ir/visitor.h"
+#include "lib/big_int_util.h"
 #include "lib/cstring.h"
 #include "lib/ordered_map.h"
 
@@ -29,12 +33,37 @@ namespace P4Tools::P4Testgen {
 using ConcolicVariableMap =
     ordered_map<std::variant<IR::ConcolicVariable, const IR::Expression *>, const IR::Expression *>;
 
+/// Memoizes the results of concolic functions on concrete inputs. The tests of different paths
+/// often apply a function, e.g., a checksum, to the same values. The test back end owns the cache,
+/// so it lives for one run of the test generator.
+class ConcolicCache {
+ public:
+    /// A target-defined identifier of the function, and the bytes of its concrete input.
+    using Key = std::pair<int, std::vector<char>>;
+
+    /// The maximum number of results kept. The cache is emptied when it is full.
+    static constexpr size_t MAX_ENTRIES = 1 << 12;
+
+    /// @returns the result of the function for the input in @param key. Only computes it with
+    /// @param compute if it is not cached.
+    big_int lookup(Key key, const std::function<big_int(const std::vector<char> &)> &compute);
+
+    /// @returns the number of lookups that found a cached result.
+    [[nodiscard]] uint64_t getHits() const;
+
+ private:
+    std::map<Key, big_int> results;
+
+    uint64_t hits = 0;
+};
+
 /// Encapsulates a set of concolic method implementations.
 class ConcolicMethodImpls {
  private:
     using MethodImpl = std::function<void(
         cstring concolicMethodName, const IR::ConcolicVariable *var, const ExecutionState &state,
-        const Model &evaluatedModel, ConcolicVariableMap *resolvedConcolicVariables)>;
+        const Model &evaluatedModel, ConcolicVariableMap *resolvedConcolicVariables,
+        ConcolicCache &cache)>;
 
     ordered_map<cstring, ordered_map<uint, std::list<std::pair<std::vector<cstring>, MethodImpl>>>>
         impls;
@@ -49,7 +78,7 @@ class ConcolicMethodImpls {
 
     bool exec(cstring concolicMethodName, const IR::ConcolicVariable *var,
               const ExecutionState &state, const Model &evaluatedModel,
-              ConcolicVariableMap *resolvedConcolicVariables) const;
+              ConcolicVariableMap *resolvedConcolicVariables, ConcolicCache &cache) const;
 
     void add(const ImplList &implList);
 };
@@ -57,10 +86,11 @@ class ConcolicMethodImpls {
 class ConcolicResolver : public Inspector {
  public:
     explicit ConcolicResolver(const Model &evaluatedModel, const ExecutionState &state,
-                              const ConcolicMethodImpls &concolicMethodImpls);
+                              const ConcolicMethodImpls &concolicMethodImpls,
+                              ConcolicCache &cache);
 
     ConcolicResolver(const Model &evaluatedModel, const ExecutionState &state,
-                     const ConcolicMethodImpls &concolicMethodImpls,
+                     const ConcolicMethodImpls &concolicMethodImpls, ConcolicCache &cache,
                      ConcolicVariableMap resolvedConcolicVariables);
 
     const ConcolicVariableMap *getResolvedConcolicVariables() const;
@@ -81,6 +111,9 @@ class ConcolicResolver : public Inspector {
     /// A reference to the list of implemented concolic methods. This is assembled by the
     /// testgen targets.
     const ConcolicMethodImpls &concolicMethodImpls;
+
+    /// The results of concolic functions computed so far.
+    ConcolicCache &cache;
 };
 
 class Concolic {
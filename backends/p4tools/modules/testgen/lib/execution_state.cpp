@@ -1,8 +1,10 @@
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <list>
 #include <map>
 #include <stack>
@@ -20,6 +22,7 @@
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/taint.h"
 #include "backends/p4tools/common/lib/trace_event.h"
+#include "backends/p4tools/common/lib/trace_event_types.h"
 #include "backends/p4tools/common/lib/variables.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
@@ -326,6 +329,15 @@ void ExecutionState::replaceTopBody(std::initializer_list<Continuation::Command>
 
 void ExecutionState::pushPathConstraint(const IR::Expression *e) { pathConstraint.push_back(e); }
 
+std::pair<const Model *, size_t> ExecutionState::getPathModel() const {
+    return {pathModel, pathModelSize};
+}
+
+void ExecutionState::setPathModel(const Model *model) {
+    pathModel = model;
+    pathModelSize = pathConstraint.size();
+}
+
 void ExecutionState::pushBranchDecision(uint64_t bIdx) { selectedBranches.push_back(bIdx); }
 
 const IR::SymbolicVariable *ExecutionState::getInputPacketSizeVar() {
@@ -510,4 +522,146 @@ const IR::SymbolicVariable *ExecutionState::createPacketVariable(const IR::Type
     return variable;
 }
 
+/* =============================================================================================
+ *  State merging
+ * ============================================================================================= */
+
+namespace {
+
+/// @returns true if @param a and @param b consist of the same stack frames.
+bool sameStack(std::stack<std::reference_wrapper<const ExecutionState::StackFrame>> a,
+               std::stack<std::reference_wrapper<const ExecutionState::StackFrame>> b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (; !a.empty(); a.pop(), b.pop()) {
+        if (&a.top().get() != &b.top().get()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @returns true if the values @param a and @param b can be selected by an ite-expression.
+bool isMergeableValue(const IR::Expression *a, const IR::Expression *b) {
+    if (!a->type->is<IR::Type_Bits>() && !a->type->is<IR::Type_Boolean>()) {
+        return false;
+    }
+    return a->type->equiv(*b->type) && !Taint::hasTaint(a) && !Taint::hasTaint(b);
+}
+
+/// @returns the conjunction of the non-empty range of constraints [@param begin, @param end).
+const IR::Expression *conjunction(std::vector<const IR::Expression *>::const_iterator begin,
+                                  std::vector<const IR::Expression *>::const_iterator end) {
+    BUG_CHECK(begin != end, "Conjunction of an empty list of constraints.");
+    const auto *result = *begin;
+    for (auto it = std::next(begin); it != end; ++it) {
+        result = new IR::LAnd(IR::Type_Boolean::get(), result, *it);
+    }
+    return result;
+}
+
+}  // namespace
+
+uint16_t ExecutionState::getMergeCount() const { return mergeCount; }
+
+bool ExecutionState::isMergeableWith(const ExecutionState &other,
+                                     size_t maxDifferingVariables) const {
+    if (namespaces != other.namespaces || !(body == other.body) ||
+        !sameStack(stack, other.stack) || stateProperties != other.stateProperties ||
+        testObjects != other.testObjects || !(parserErrorLabel == other.parserErrorLabel) ||
+        inputPacketCursor != other.inputPacketCursor ||
+        numAllocatedPacketVariables != other.numAllocatedPacketVariables ||
+        reachabilityEngineState != other.reachabilityEngineState) {
+        return false;
+    }
+
+    // Both states need to have their own path constraints, which select between them.
+    auto [it, otherIt] = std::mismatch(pathConstraint.begin(), pathConstraint.end(),
+                                       other.pathConstraint.begin(), other.pathConstraint.end());
+    if (it == pathConstraint.end() || otherIt == other.pathConstraint.end()) {
+        return false;
+    }
+
+    // Variables that are only bound in one of the states have not been declared on the path of
+    // the other state, so the other state can not read them. They keep their value.
+    const auto &values = env.getValues();
+    const auto &otherValues = other.env.getValues();
+    size_t differingVariables = 0;
+    for (size_t id = 0; id < std::min(values.size(), otherValues.size()); id++) {
+        const auto *value = values[id];
+        const auto *otherValue = otherValues[id];
+        if (value == nullptr || otherValue == nullptr || value == otherValue ||
+            value->equiv(*otherValue)) {
+            continue;
+        }
+        if (!isMergeableValue(value, otherValue) ||
+            ++differingVariables > maxDifferingVariables) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The number of variables created by all merges so far. Unrelated merges may produce states with
+/// the same merge count, so the variables are numbered across the process to keep their names
+/// unique.
+static std::atomic<uint64_t> numMergedVariables = 0;
+
+ExecutionState &ExecutionState::merge(const ExecutionState &other) const {
+    auto &merged = clone();
+    merged.mergeCount = mergeCount + other.mergeCount + 1;
+
+    // The path constraints of each state after the common prefix select the value of a differing
+    // variable.
+    auto [it, otherIt] = std::mismatch(pathConstraint.begin(), pathConstraint.end(),
+                                       other.pathConstraint.begin(), other.pathConstraint.end());
+    const auto *guard = conjunction(it, pathConstraint.end());
+    const auto *otherGuard = conjunction(otherIt, other.pathConstraint.end());
+    merged.pathConstraint.resize(it - pathConstraint.begin());
+    merged.pathConstraint.push_back(new IR::LOr(IR::Type_Boolean::get(), guard, otherGuard));
+    merged.pathModel = nullptr;
+    merged.pathModelSize = 0;
+
+    const auto &values = env.getValues();
+    const auto &otherValues = other.env.getValues();
+    for (size_t id = 0; id < otherValues.size(); id++) {
+        const auto *otherValue = otherValues[id];
+        if (otherValue == nullptr) {
+            continue;
+        }
+        const auto *value = id < values.size() ? values[id] : nullptr;
+        const auto &var = StateVariableIds::getVariable(id);
+        if (value == nullptr) {
+            merged.env.set(var, otherValue);
+            continue;
+        }
+        if (value == otherValue || value->equiv(*otherValue)) {
+            continue;
+        }
+        const auto *type = otherValue->type;
+        const auto *mergedVar = ToolsVariables::getSymbolicVariable(
+            type, "merged_" + std::to_string(numMergedVariables++));
+        const auto *select = new IR::Mux(type, guard, value, otherValue);
+        merged.pathConstraint.push_back(new IR::Equ(IR::Type_Boolean::get(), mergedVar, select));
+        merged.env.set(var, mergedVar);
+    }
+
+    // Only keep the history and the coverage that both executions share.
+    auto traceEnd = std::mismatch(trace.begin(), trace.end(), other.trace.begin(),
+                                  other.trace.end(), [](const auto &a, const auto &b) {
+                                      return &a.get() == &b.get();
+                                  }).first;
+    merged.trace.erase(merged.trace.begin() + (traceEnd - trace.begin()), merged.trace.end());
+    merged.add(*new TraceEvents::Generic("Merged execution states"));
+    auto branchesEnd = std::mismatch(selectedBranches.begin(), selectedBranches.end(),
+                                     other.selectedBranches.begin(), other.selectedBranches.end())
+                           .first;
+    merged.selectedBranches.resize(branchesEnd - selectedBranches.begin());
+    for (auto node = merged.visitedNodes.begin(); node != merged.visitedNodes.end();) {
+        node = other.visitedNodes.count(*node) == 0 ? merged.visitedNodes.erase(node) : ++node;
+    }
+    return merged;
+}
+
 }  // namespace P4Tools::P4Testgen
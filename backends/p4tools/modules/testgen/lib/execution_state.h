@@ -15,6 +15,7 @@
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/abstract_execution_state.h"
 #include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/namespace_context.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
@@ -122,6 +123,12 @@ class ExecutionState : public AbstractExecutionState {
     /// execution state.
     std::vector<const IR::Expression *> pathConstraint;
 
+    /// The last model found for the path constraints of this state and the number of path
+    /// constraints it satisfies. It is copied into successor states, where it serves as a
+    /// candidate solution for their extended path constraints.
+    const Model *pathModel = nullptr;
+    size_t pathModelSize = 0;
+
     /// List of branch decisions leading into this state.
     std::vector<uint64_t> selectedBranches;
 
@@ -132,6 +139,9 @@ class ExecutionState : public AbstractExecutionState {
     /// Used to create unique symbolic variables in some cases.
     uint16_t numAllocatedPacketVariables = 0;
 
+    /// The number of merges of execution states that this state is the result of.
+    uint16_t mergeCount = 0;
+
     /// Helper function to create a new, unique symbolic packet variable.
     /// Keeps track of the allocated packet variables by incrementing @ref
     /// numAllocatedPacketVariables.
@@ -154,6 +164,13 @@ class ExecutionState : public AbstractExecutionState {
     /// Adds path constraint.
     void pushPathConstraint(const IR::Expression *e);
 
+    /// @returns the last model found for the path constraints, or nullptr if there is none,
+    /// together with the number of path constraints the model satisfies.
+    [[nodiscard]] std::pair<const Model *, size_t> getPathModel() const;
+
+    /// Records that @param model satisfies all current path constraints.
+    void setPathModel(const Model *model);
+
     /// Adds branch decision identifier. Must be called for all branches with more than one
     /// successor. These branch decision identifiers are then used by track branches and
     /// selected (input) branches features.
@@ -382,6 +399,25 @@ class ExecutionState : public AbstractExecutionState {
     /// @returns the current parser error label. Throws a BUG if the label is a nullptr.
     [[nodiscard]] const IR::StateVariable &getCurrentParserErrorLabel() const;
 
+    /* =========================================================================================
+     *  State merging
+     * ========================================================================================= */
+    /// @returns the number of merges of execution states that this state is the result of.
+    [[nodiscard]] uint16_t getMergeCount() const;
+
+    /// @returns whether this state and @param other can be combined by @ref merge. Both states
+    /// need to continue with the same commands and continuation stack, the same properties,
+    /// and the same test objects. At most @param maxDifferingVariables variables may have
+    /// different values, which need to be bit vectors or booleans of the same type.
+    [[nodiscard]] bool isMergeableWith(const ExecutionState &other,
+                                       size_t maxDifferingVariables) const;
+
+    /// @returns a new state that represents the executions of both this state and @param other,
+    /// which must be mergeable. The path constraints after the common prefix of both states are
+    /// replaced by their disjunction. Each differing variable is bound to a fresh symbolic
+    /// variable, which is constrained to the value of either state by an ite-expression.
+    [[nodiscard]] ExecutionState &merge(const ExecutionState &other) const;
+
     /* =========================================================================================
      *  Constructors
      * ========================================================================================= */
@@ -90,6 +90,21 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
         pathConstraint = P4::optimizeExpression(pathConstraint);
         asserts.push_back(pathConstraint);
     }
+    // The concolic assignments usually only fix the concolic variables, which the path
+    // constraints do not depend on. In that case, the final model with the assignments applied
+    // is a solution and we do not need the solver.
+    auto &concolicModel = *new Model(finalModel.get());
+    for (const auto &resolvedConcolicVariable : resolvedConcolicVariables) {
+        const auto *concolicVariable =
+            std::get_if<IR::ConcolicVariable>(&resolvedConcolicVariable.first);
+        if (concolicVariable != nullptr && resolvedConcolicVariable.second->is<IR::Literal>()) {
+            concolicModel.set(concolicVariable->clone(), resolvedConcolicVariable.second);
+        }
+    }
+    if (concolicModel.satisfies(asserts)) {
+        return *new FinalState(solver, state, concolicModel);
+    }
+
     auto solverResult = solver.get().checkSat(asserts);
     if (!solverResult) {
         ::warning("Timed out trying to solve this concolic execution path.");
@@ -107,6 +122,20 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
     return *new FinalState(solver, state, model);
 }
 
+std::optional<std::reference_wrapper<const FinalState>> FinalState::computeVariantState(
+    const std::vector<const Constraint *> &constraints) const {
+    // The path constraints are a common prefix of all variants. An incremental solver only
+    // needs to push and pop the additional constraints.
+    std::vector<const Constraint *> asserts = state.get().getPathConstraint();
+    asserts.insert(asserts.end(), constraints.begin(), constraints.end());
+    auto solverResult = solver.get().checkSat(asserts);
+    if (!solverResult || !*solverResult) {
+        return std::nullopt;
+    }
+    auto &model = processModel(state, *new Model(solver.get().getSymbolicMapping()));
+    return *new FinalState(solver, state, model);
+}
+
 const Model &FinalState::getFinalModel() const { return finalModel; }
 
 AbstractSolver &FinalState::getSolver() const { return solver; }
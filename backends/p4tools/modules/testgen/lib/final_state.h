@@ -59,6 +59,12 @@ class FinalState {
     [[nodiscard]] std::optional<std::reference_wrapper<const FinalState>> computeConcolicState(
         const ConcolicVariableMap &resolvedConcolicVariables) const;
 
+    /// Compute a new final state for the same path by solving the path constraints together with
+    /// @param constraints. Since only the final model is recomputed, this is much cheaper than
+    /// executing the path again. If the constraints are not satisfiable, return std::nullopt.
+    [[nodiscard]] std::optional<std::reference_wrapper<const FinalState>> computeVariantState(
+        const std::vector<const Constraint *> &constraints) const;
+
     /// @returns the model after it was augmented by completions from the symbolic environment.
     [[nodiscard]] const Model &getFinalModel() const;
 
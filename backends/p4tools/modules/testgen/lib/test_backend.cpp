@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <optional>
+#include <vector>
 
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/format_int.h"
@@ -9,6 +10,7 @@
 #include "backends/p4tools/common/lib/taint.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/common/lib/variables.h"
 #include "ir/irutils.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
@@ -23,12 +25,88 @@
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
 #include "backends/p4tools/modules/testgen/lib/packet_vars.h"
+#include "backends/p4tools/modules/testgen/lib/test_spec.h"
 #include "backends/p4tools/modules/testgen/lib/tf.h"
 #include "backends/p4tools/modules/testgen/options.h"
 
 namespace P4Tools::P4Testgen {
 
+namespace {
+
+/// Inserts the symbolic variables of the arguments of @param actionCall into @param variables.
+void collectActionArgVariables(const ActionCall &actionCall, SymbolicSet &variables) {
+    for (const auto &arg : *actionCall.getArgs()) {
+        ToolsVariables::collectSymbolicVariables(arg.getValue(), variables);
+    }
+}
+
+/// Inserts the symbolic variables that the control plane supplies for the entries and the
+/// default action of the table configuration @param config into @param variables.
+void collectControlPlaneVariables(const TableConfig &config, SymbolicSet &variables) {
+    for (const auto &rule : *config.getRules()) {
+        for (const auto &match : *rule.getMatches()) {
+            for (const auto *value : match.second->getMatchValues()) {
+                ToolsVariables::collectSymbolicVariables(value, variables);
+            }
+        }
+        collectActionArgVariables(*rule.getActionCall(), variables);
+    }
+    for (const auto &property : *config.getProperties()) {
+        if (const auto *actionCall = property.second->to<ActionCall>()) {
+            collectActionArgVariables(*actionCall, variables);
+        }
+    }
+}
+
+}  // namespace
+
+const IR::Expression *TestBackEnd::computeControlPlaneBlockingConstraint(
+    const FinalState &state) {
+    SymbolicSet variables;
+    for (const auto &tableConfig :
+         state.getExecutionState()->getTestObjectCategory("tableconfigs")) {
+        collectControlPlaneVariables(*tableConfig.second->checkedTo<TableConfig>(), variables);
+    }
+    const IR::Expression *blockingConstraint = nullptr;
+    for (const auto &[variable, value] : state.getFinalModel().getSymbolicMap()) {
+        if (variables.count(variable) == 0) {
+            continue;
+        }
+        const IR::Expression *differs = new IR::Neq(IR::Type_Boolean::get(), variable, value);
+        blockingConstraint =
+            blockingConstraint == nullptr
+                ? differs
+                : new IR::LOr(IR::Type_Boolean::get(), blockingConstraint, differs);
+    }
+    return blockingConstraint;
+}
+
 bool TestBackEnd::run(const FinalState &state) {
+    bool terminate = runTest(state);
+    // Derive further tests from the final state of this path. Each variant must choose different
+    // control-plane entries than all the tests before it.
+    std::vector<const Constraint *> blockingConstraints;
+    const auto *variantState = &state;
+    for (int64_t variantIdx = 1;
+         !terminate && variantIdx < TestgenOptions::get().controlPlaneVariants; ++variantIdx) {
+        const auto *blockingConstraint = computeControlPlaneBlockingConstraint(*variantState);
+        if (blockingConstraint == nullptr) {
+            break;
+        }
+        blockingConstraints.push_back(blockingConstraint);
+        auto variantOpt = state.computeVariantState(blockingConstraints);
+        if (!variantOpt.has_value()) {
+            break;
+        }
+        variantState = &variantOpt.value().get();
+        printFeature("test_info", 4, "Generating control-plane variant %1% of this path.",
+                     variantIdx);
+        terminate = runTest(*variantState);
+    }
+    return terminate;
+}
+
+bool TestBackEnd::runTest(const FinalState &state) {
     {
         // Evaluate the model and extract the input and output packets.
         const auto *executionState = state.getExecutionState();
@@ -69,7 +147,8 @@ bool TestBackEnd::run(const FinalState &state) {
         // Execute concolic functions that may occur in the output packet, the output port,
         // or any path conditions.
         auto concolicResolver = ConcolicResolver(state.getFinalModel(), *executionState,
-                                                 *programInfo.getConcolicMethodImpls());
+                                                 *programInfo.getConcolicMethodImpls(),
+                                                 concolicCache);
 
         outputPacketExpr->apply(concolicResolver);
         outputPortExpr->apply(concolicResolver);
@@ -234,6 +313,8 @@ void TestBackEnd::printPerformanceReport(bool write) const {
     testWriter->printPerformanceReport(write);
 }
 
+void TestBackEnd::flushTests() { testWriter->flushTests(); }
+
 int64_t TestBackEnd::getTestCount() const { return testCount; }
 
 }  // namespace P4Tools::P4Testgen
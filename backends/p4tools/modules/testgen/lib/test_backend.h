@@ -12,6 +12,7 @@
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/concolic.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
@@ -28,6 +29,13 @@ class TestBackEnd {
     /// Indicates the number of generated tests after which we reset memory.
     static const int64_t RESET_THRESHOLD = 10000;
 
+    /// The results of concolic functions computed for the tests of this run.
+    ConcolicCache concolicCache;
+
+    /// Generates a single test from the final state @param state.
+    /// @returns true if test generation should terminate.
+    bool runTest(const FinalState &state);
+
  protected:
     /// ProgramInfo is used to access some target specific information for test generation.
     const ProgramInfo &programInfo;
@@ -108,7 +116,15 @@ class TestBackEnd {
         const IR::Expression *outputPacketExpr, const IR::Expression *outputPortExpr,
         const std::vector<std::reference_wrapper<const TraceEvent>> *programTraces);
 
-    /// The callback that is executed by the symbolic executor.
+    /// @returns a constraint that excludes the control-plane entries that the model of @param
+    /// state chose for the tables on the path, or nullptr if none of these entries depend on the
+    /// model. Only the symbolic variables in the match values and action arguments of the table
+    /// configurations on the path are considered.
+    [[nodiscard]] static const IR::Expression *computeControlPlaneBlockingConstraint(
+        const FinalState &state);
+
+    /// The callback that is executed by the symbolic executor. Generates a test from @param state
+    /// and, if requested, further tests that only differ in their control-plane entries.
     virtual bool run(const FinalState &state);
 
     /// Print out some performance numbers if logging feature "performance" is enabled.
@@ -116,6 +132,9 @@ class TestBackEnd {
     /// enabled.
     void printPerformanceReport(bool write) const;
 
+    /// Blocks until all tests generated so far have been written out.
+    void flushTests();
+
     /// Accessors.
     [[nodiscard]] int64_t getTestCount() const;
 };
@@ -62,6 +62,8 @@ const IR::Parameter *ActionArg::getActionParam() const { return param; }
 
 cstring ActionArg::getActionParamName() const { return param->controlPlaneName(); }
 
+const IR::Expression *ActionArg::getValue() const { return value; }
+
 const IR::Constant *ActionArg::getEvaluatedValue() const {
     if (const auto *boolVal = value->to<IR::BoolLiteral>()) {
         return IR::convertBoolLiteral(boolVal);
@@ -137,6 +139,8 @@ const Ternary *Ternary::evaluate(const Model &model, bool doComplete) const {
 
 cstring Ternary::getObjectName() const { return "Ternary"; }
 
+std::vector<const IR::Expression *> Ternary::getMatchValues() const { return {value, mask}; }
+
 LPM::LPM(const IR::KeyElement *key, const IR::Expression *value, const IR::Expression *prefixLength)
     : TableMatch(key), value(value), prefixLength(prefixLength) {}
 
@@ -166,6 +170,8 @@ const LPM *LPM::evaluate(const Model &model, bool doComplete) const {
 
 cstring LPM::getObjectName() const { return "LPM"; }
 
+std::vector<const IR::Expression *> LPM::getMatchValues() const { return {value, prefixLength}; }
+
 Exact::Exact(const IR::KeyElement *key, const IR::Expression *val) : TableMatch(key), value(val) {}
 
 const IR::Constant *Exact::getEvaluatedValue() const {
@@ -184,6 +190,8 @@ const Exact *Exact::evaluate(const Model &model, bool doComplete) const {
 
 cstring Exact::getObjectName() const { return "Exact"; }
 
+std::vector<const IR::Expression *> Exact::getMatchValues() const { return {value}; }
+
 TableRule::TableRule(TableMatchMap matches, int priority, ActionCall action, int ttl)
     : matches(std::move(matches)), priority(priority), action(std::move(action)), ttl(ttl) {}
 
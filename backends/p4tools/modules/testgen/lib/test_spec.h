@@ -80,6 +80,9 @@ class ActionArg : public TestObject {
     /// @returns the parameter name associated with the action argument.
     [[nodiscard]] cstring getActionParamName() const;
 
+    /// @returns the argument value as it was supplied, before it is evaluated by a model.
+    [[nodiscard]] const IR::Expression *getValue() const;
+
     /// @returns input argument value, which at this point needs to be a constant.
     /// If the value is a bool, it is converted into a constant.
     /// A BUG is thrown otherwise.
@@ -127,6 +130,10 @@ class TableMatch : public TestObject {
 
     /// @returns the key associated with this object.
     [[nodiscard]] const IR::KeyElement *getKey() const;
+
+    /// @returns the values that the control plane supplies for this match, before they are
+    /// evaluated by a model.
+    [[nodiscard]] virtual std::vector<const IR::Expression *> getMatchValues() const = 0;
 };
 
 using TableMatchMap = std::map<cstring, const TableMatch *>;
@@ -147,6 +154,8 @@ class Ternary : public TableMatch {
 
     [[nodiscard]] cstring getObjectName() const override;
 
+    [[nodiscard]] std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the value of the ternary object, which is matched with the key. At this point the
     /// value needs to be a constant.
     /// A BUG is thrown otherwise.
@@ -174,6 +183,8 @@ class LPM : public TableMatch {
 
     [[nodiscard]] cstring getObjectName() const override;
 
+    [[nodiscard]] std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the value of the LPM object, which is matched with the key. At this point the
     /// value needs to be a constant.
     /// A BUG is thrown otherwise.
@@ -197,6 +208,8 @@ class Exact : public TableMatch {
 
     [[nodiscard]] cstring getObjectName() const override;
 
+    [[nodiscard]] std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the match value. It is expected to be a constant at this point.
     /// A BUG is thrown otherwise.
     [[nodiscard]] const IR::Constant *getEvaluatedValue() const;
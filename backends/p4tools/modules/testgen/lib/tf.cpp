@@ -16,6 +16,22 @@ namespace P4Tools::P4Testgen {
 TF::TF(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
     : basePath(std::move(basePath)), seed(seed) {}
 
+/// The inja environment shared by all test frameworks.
+static inja::Environment &getInjaEnvironment() {
+    static inja::Environment env;
+    return env;
+}
+
+inja::Template TF::parseTemplate(std::string_view templateString) {
+    return getInjaEnvironment().parse(templateString);
+}
+
+std::string TF::renderTemplate(const inja::Template &testTemplate, const inja::json &dataJson) {
+    return getInjaEnvironment().render(testTemplate, dataJson);
+}
+
+void TF::flushTests() { fileWriter.flush(); }
+
 void TF::printPerformanceReport(bool write) const {
     // Do not emit a report if performance logging is not enabled.
     if (!Log::fileLogLevelIsAtLeast("performance", 4)) {
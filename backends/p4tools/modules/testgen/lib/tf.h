@@ -9,6 +9,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "ir/ir.h"
 #include "lib/cstring.h"
 
+#include "backends/p4tools/modules/testgen/lib/async_file_writer.h"
 #include "backends/p4tools/modules/testgen/lib/test_object.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
 
@@ -34,9 +36,20 @@ class TF {
     /// The seed used by the testgen.
     std::optional<unsigned int> seed;
 
+    /// Writes the test files in the background.
+    AsyncFileWriter fileWriter;
+
     /// Creates a generic test framework.
     TF(std::filesystem::path basePath, std::optional<unsigned int> seed);
 
+    /// Parses the inja template @param templateString. Test frameworks parse their templates once
+    /// and render them for every test with @ref renderTemplate.
+    static inja::Template parseTemplate(std::string_view templateString);
+
+    /// @returns @param testTemplate rendered with @param dataJson.
+    static std::string renderTemplate(const inja::Template &testTemplate,
+                                      const inja::json &dataJson);
+
     /// Converts the traces of this test into a string representation and Inja object.
     static inja::json getTrace(const TestSpec *testSpec) {
         inja::json traceList = inja::json::array();
@@ -150,6 +163,9 @@ class TF {
     /// Also log performance numbers to a separate file in the test folder if @param write is
     /// enabled.
     void printPerformanceReport(bool write) const;
+
+    /// Blocks until all tests emitted so far have been written out.
+    void flushTests();
 };
 
 }  // namespace P4Tools::P4Testgen
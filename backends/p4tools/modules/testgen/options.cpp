@@ -27,6 +27,21 @@ const char *TestgenOptions::getIncludePath() {
     P4C_UNIMPLEMENTED("getIncludePath not implemented for P4Testgen.");
 }
 
+std::vector<const char *> *TestgenOptions::process(int argc, char *const argv[]) {
+    auto *remainingArgs = AbstractP4cToolOptions::process(argc, argv);
+    if (remainingArgs == nullptr) {
+        return nullptr;
+    }
+    // Merged states do not follow a single sequence of branch decisions.
+    if (stateMerging && (!selectedBranches.empty() || trackBranches || !pattern.empty())) {
+        ::error(
+            "--state-merging can not be combined with --input-branches, --track-branches, or "
+            "--pattern.");
+        return nullptr;
+    }
+    return remainingArgs;
+}
+
 const std::set<cstring> TestgenOptions::SUPPORTED_STOP_METRICS = {"MAX_STATEMENT_COVERAGE"};
 
 TestgenOptions::TestgenOptions()
@@ -181,6 +196,7 @@ TestgenOptions::TestgenOptions()
                 {"RANDOM_BACKTRACK", PathSelectionPolicy::RandomBacktrack},
                 {"GREEDY_STATEMENT_SEARCH", PathSelectionPolicy::GreedyStmtCoverage},
                 {"RANDOM_STATEMENT_SEARCH", PathSelectionPolicy::RandomMaxStmtCoverage},
+                {"DISTANCE_STATEMENT_SEARCH", PathSelectionPolicy::DistanceStmtCoverage},
             };
             auto selectionString = cstring(arg).toUpper();
             auto it = PATH_SELECTION_OPTIONS.find(selectionString);
@@ -201,8 +217,8 @@ TestgenOptions::TestgenOptions()
             return false;
         },
         "Selects a specific path selection strategy for test generation. Options are: "
-        "DEPTH_FIRST, RANDOM_BACKTRACK, GREEDY_STATEMENT_SEARCH, and RANDOM_STATEMENT_SEARCH. "
-        "Defaults to DEPTH_FIRST.");
+        "DEPTH_FIRST, RANDOM_BACKTRACK, GREEDY_STATEMENT_SEARCH, RANDOM_STATEMENT_SEARCH, and "
+        "DISTANCE_STATEMENT_SEARCH. Defaults to DEPTH_FIRST.");
 
     registerOption(
         "--track-coverage", "coverageItem",
@@ -325,6 +341,57 @@ TestgenOptions::TestgenOptions()
         },
         "Produce only tests that violate the condition defined in assert calls. This will either "
         "produce no tests or only tests that contain counter examples.");
+
+    registerOption(
+        "--constraint-slicing", nullptr,
+        [this](const char * /*arg*/) {
+            constraintSlicing = true;
+            return true;
+        },
+        "Only send the path constraints to the solver that share variables with constraints "
+        "that have not been solved before, instead of all path constraints.");
+
+    registerOption(
+        "--solver-portfolio", nullptr,
+        [this](const char * /*arg*/) {
+            solverPortfolio = true;
+            return true;
+        },
+        "Race alternative solver configurations, each on its own thread, against the default "
+        "configuration on queries that it does not answer quickly. The first answer wins. "
+        "Requires a build with multithreading enabled, otherwise the option only emits a "
+        "warning.");
+
+    registerOption(
+        "--state-merging", nullptr,
+        [this](const char * /*arg*/) {
+            stateMerging = true;
+            return true;
+        },
+        "Merge execution states that reach the same parser state into a single state, instead of "
+        "exploring each parser path separately. Can not be combined with --input-branches, "
+        "--track-branches, or --pattern.");
+
+    registerOption(
+        "--control-plane-variants", "controlPlaneVariants",
+        [this](const char *arg) {
+            try {
+                controlPlaneVariants = std::stoll(arg);
+                if (controlPlaneVariants < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+            } catch (std::invalid_argument &) {
+                ::error(
+                    "Invalid input value %1% for --control-plane-variants. Expected positive "
+                    "integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Generate up to this many tests per explored path [default: 1]. The tests of a path only "
+        "differ in their control-plane table entries and are derived from the final state of the "
+        "path instead of executing the program again.");
 }
 
 }  // namespace P4Tools::P4Testgen
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "backends/p4tools/common/options.h"
 #include "lib/cstring.h"
@@ -74,12 +75,34 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// This will either produce no tests or only tests that contain counter examples.
     bool assertionModeEnabled = false;
 
+    /// Partition the path constraints into independent clusters before solving them, so only
+    /// clusters that were not solved before are sent to the solver.
+    bool constraintSlicing = false;
+
+    /// Race alternative solver configurations against the default one on queries that the
+    /// default configuration does not answer quickly. Requires multithreading.
+    bool solverPortfolio = false;
+
+    /// Merge execution states that reach the same parser state with the same continuation into a
+    /// single state. Values that differ between the merged states are selected by the path taken.
+    bool stateMerging = false;
+
+    /// The maximum number of tests generated from a single final state. Tests after the first
+    /// one only differ in the control-plane entries of the tables on the path. Defaults to 1.
+    int64_t controlPlaneVariants = 1;
+
     /// Specifies, which IR nodes to track for coverage in the targeted P4 program.
     /// Multiple options are possible. Currently supported: STATEMENTS, TABLE_ENTRIES.
     P4::Coverage::CoverageOptions coverageOptions;
 
     const char *getIncludePath() override;
 
+    using AbstractP4cToolOptions::process;
+
+ protected:
+    /// Rejects combinations of options that can not be honoured together.
+    std::vector<const char *> *process(int argc, char *const argv[]) override;
+
  private:
     TestgenOptions();
 };
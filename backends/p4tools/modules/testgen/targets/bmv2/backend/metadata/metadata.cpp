@@ -76,8 +76,8 @@ inja::json Metadata::getVerify(const TestSpec *testSpec) {
     return verifyData;
 }
 
-std::string Metadata::getTestCaseTemplate() {
-    static std::string TEST_CASE(
+const inja::Template &Metadata::getTestCaseTemplate() {
+    static const inja::Template TEST_CASE = parseTemplate(
         R"""(# A P4Testgen-generated test case for {{test_name}}.p4
 
 # Seed used to generate this test.
@@ -138,7 +138,7 @@ void Metadata::computeTraceData(const TestSpec *testSpec, inja::json &dataJson)
 }
 
 void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                            const std::string &testCase, float currentCoverage) {
+                            const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -172,19 +172,15 @@ void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
     }
 
     LOG5("Metadata back end: emitting testcase:" << std::setw(4) << dataJson);
-
-    inja::render_to(metadataFile, testCase, dataJson);
-    metadataFile.flush();
+    auto incrementedbasePath = basePath;
+    incrementedbasePath.concat("_" + std::to_string(testId));
+    incrementedbasePath.replace_extension(".yml");
+    fileWriter.write(incrementedbasePath, renderTemplate(testCase, dataJson));
 }
 
 void Metadata::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                           float currentCoverage) {
-    auto incrementedbasePath = basePath;
-    incrementedbasePath.concat("_" + std::to_string(testId));
-    incrementedbasePath.replace_extension(".yml");
-    metadataFile = std::ofstream(incrementedbasePath);
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, getTestCaseTemplate(), currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
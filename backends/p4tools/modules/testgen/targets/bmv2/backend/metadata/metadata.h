@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -21,9 +20,6 @@ namespace P4Tools::P4Testgen::Bmv2 {
 
 /// Extracts information from the @testSpec to emit a Metadata test case.
 class Metadata : public TF {
-    /// The output file.
-    std::ofstream metadataFile;
-
  public:
     virtual ~Metadata() = default;
 
@@ -52,15 +48,15 @@ class Metadata : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
 
     /// Gets the traces from @param testSpec and populates @param dataJson.
     /// Also retrieves the label and offset for each successful extract call and stores them in a
     /// "offsets" key.
     static void computeTraceData(const TestSpec *testSpec, inja::json &dataJson);
 
-    /// @returns the inja test case template as a string.
-    static std::string getTestCaseTemplate();
+    /// @returns the parsed inja test case template.
+    static const inja::Template &getTestCaseTemplate();
 
     /// Converts the input packet and port into Inja format.
     static inja::json getSend(const TestSpec *testSpec);
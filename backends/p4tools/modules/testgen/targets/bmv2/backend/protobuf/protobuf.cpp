@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -252,8 +251,8 @@ inja::json Protobuf::getVerify(const TestSpec *testSpec) {
     return verifyData;
 }
 
-std::string Protobuf::getTestCaseTemplate() {
-    static std::string TEST_CASE(
+const inja::Template &Protobuf::getTestCaseTemplate() {
+    static const inja::Template TEST_CASE = parseTemplate(
         R"""(# A P4TestGen-generated test case for {{test_name}}.p4
 metadata: "p4testgen seed: {{ default(seed, "none") }}"
 metadata: "Date generated: {{timestamp}}"
@@ -379,7 +378,7 @@ entities : [
 }
 
 void Protobuf::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                            const std::string &testCase, float currentCoverage) {
+                            const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -404,15 +403,12 @@ void Protobuf::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
     auto incrementedbasePath = basePath;
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
-    auto protobufFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(protobufFileStream, testCase, dataJson);
-    protobufFileStream.flush();
+    fileWriter.write(incrementedbasePath, renderTemplate(testCase, dataJson));
 }
 
 void Protobuf::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                           float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, getTestCaseTemplate(), currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
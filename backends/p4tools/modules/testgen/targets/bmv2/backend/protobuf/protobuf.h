@@ -54,10 +54,10 @@ class Protobuf : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
 
-    /// @returns the inja test case template as a string.
-    static std::string getTestCaseTemplate();
+    /// @returns the parsed inja test case template.
+    static const inja::Template &getTestCaseTemplate();
 
     /// Converts all the control plane objects into Inja format.
     static inja::json getControlPlane(const TestSpec *testSpec);
@@ -316,12 +316,11 @@ class AbstractTest(bt.P4RuntimeTest):
         dataJson["seed"] = *seed;
     }
 
-    inja::render_to(ptfFileStream, PREAMBLE, dataJson);
-    ptfFileStream.flush();
+    fileWriter.write(ptfFile, inja::render(PREAMBLE, dataJson));
 }
 
-std::string PTF::getTestCaseTemplate() {
-    static std::string TEST_CASE(
+const inja::Template &PTF::getTestCaseTemplate() {
+    static const inja::Template TEST_CASE = parseTemplate(
         R"""(
 class Test{{test_id}}(AbstractTest):
     # Date generated: {{timestamp}}
@@ -424,7 +423,7 @@ class Test{{test_id}}(AbstractTest):
 }
 
 void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
+                       const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -452,21 +451,18 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
 
     LOG5("PTF backend: emitting testcase:" << std::setw(4) << dataJson);
 
-    inja::render_to(ptfFileStream, testCase, dataJson);
-    ptfFileStream.flush();
+    fileWriter.write(ptfFile, renderTemplate(testCase, dataJson), true);
 }
 
 void PTF::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                      float currentCoverage) {
     if (!preambleEmitted) {
-        auto ptfFile = basePath;
+        ptfFile = basePath;
         ptfFile.replace_extension(".py");
-        ptfFileStream = std::ofstream(ptfFile);
         emitPreamble();
         preambleEmitted = true;
     }
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, getTestCaseTemplate(), currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -3,7 +3,6 @@
 
 #include <cstddef>
 #include <filesystem>
-#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -27,7 +26,7 @@ class PTF : public TF {
     bool preambleEmitted = false;
 
     /// The output file.
-    std::ofstream ptfFileStream;
+    std::filesystem::path ptfFile;
 
  public:
     virtual ~PTF() = default;
@@ -57,10 +56,10 @@ class PTF : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
 
-    /// @returns the inja test case template as a string.
-    static std::string getTestCaseTemplate();
+    /// @returns the parsed inja test case template.
+    static const inja::Template &getTestCaseTemplate();
 
     /// Converts all the control plane objects into Inja format.
     static inja::json getControlPlane(const TestSpec *testSpec);
@@ -1,6 +1,5 @@
 #include "backends/p4tools/modules/testgen/targets/bmv2/backend/stf/stf.h"
 
-#include <fstream>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -209,8 +208,8 @@ inja::json::array_t STF::getClone(const TestObjectMap &cloneSpecs) {
     return cloneJson;
 }
 
-std::string STF::getTestCaseTemplate() {
-    static std::string TEST_CASE(
+const inja::Template &STF::getTestCaseTemplate() {
+    static const inja::Template TEST_CASE = parseTemplate(
         R"""(# p4testgen seed: {{ default(seed, "none") }}
 # Date generated: {{timestamp}}
 ## if length(selected_branches) > 0
@@ -264,7 +263,7 @@ expect {{verify.eg_port}} {{verify.exp_pkt}}$
 }
 
 void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
+                       const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -295,15 +294,12 @@ void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     auto incrementedbasePath = basePath;
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
-    auto stfFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(stfFileStream, testCase, dataJson);
-    stfFileStream.flush();
+    fileWriter.write(incrementedbasePath, renderTemplate(testCase, dataJson));
 }
 
 void STF::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                      float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, getTestCaseTemplate(), currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -47,7 +47,8 @@ std::vector<char> Bmv2Concolic::convertBigIntToBytes(big_int &dataInt, int targe
 
 big_int Bmv2Concolic::computeChecksum(const std::vector<const IR::Expression *> &exprList,
                                       const Model &finalModel, int algo,
-                                      Model::ExpressionMap *resolvedExpressions) {
+                                      Model::ExpressionMap *resolvedExpressions,
+                                      ConcolicCache &cache) {
     // Pick a checksum according to the algorithm value.
     ChecksumFunction checksumFun = nullptr;
     switch (algo) {
@@ -104,7 +105,9 @@ big_int Bmv2Concolic::computeChecksum(const std::vector<const IR::Expression *>
             IR::getBigIntFromLiteral(finalModel.evaluate(concatExpr, true, resolvedExpressions));
         bytes = convertBigIntToBytes(dataInt, concatWidth);
     }
-    return checksumFun(bytes.data(), bytes.size());
+    return cache.lookup({algo, std::move(bytes)}, [checksumFun](const std::vector<char> &input) {
+        return checksumFun(input.data(), input.size());
+    });
 }
 
 const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
@@ -127,7 +130,7 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
      {"result", "algo", "base", "data", "max"},
      [](cstring /*concolicMethodName*/, const IR::ConcolicVariable *var,
         const ExecutionState & /*state*/, const Model &finalModel,
-        ConcolicVariableMap *resolvedConcolicVariables) {
+        ConcolicVariableMap *resolvedConcolicVariables, ConcolicCache &cache) {
          const auto *args = var->arguments;
          const auto *checksumVar = args->at(0)->expression;
          if (!(checksumVar->is<IR::Member>() || checksumVar->is<IR::PathExpression>())) {
@@ -159,7 +162,8 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
          if (maxHashInt == 0) {
              computedResult = baseInt;
          } else {
-             computedResult = computeChecksum(exprList, finalModel, algo, &resolvedExpressions);
+             computedResult =
+                 computeChecksum(exprList, finalModel, algo, &resolvedExpressions, cache);
              // Behavioral model uses this technique to limit the hash output.
              computedResult = (baseInt + (computedResult % maxHashInt));
          }
@@ -192,7 +196,7 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
      {"result", "algo", "data"},
      [](cstring /*concolicMethodName*/, const IR::ConcolicVariable *var,
         const ExecutionState & /*state*/, const Model &finalModel,
-        ConcolicVariableMap *resolvedConcolicVariables) {
+        ConcolicVariableMap *resolvedConcolicVariables, ConcolicCache &cache) {
          // Assign arguments to concrete variables and perform type checking.
          const auto *args = var->arguments;
          const auto *checksumVar = args->at(0)->expression;
@@ -214,7 +218,8 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
          Model::ExpressionMap resolvedExpressions;
          big_int computedResult = 0;
          // If max is 0, the value written to computedResult will always be base.
-         computedResult = computeChecksum(exprList, finalModel, algo, &resolvedExpressions);
+         computedResult =
+             computeChecksum(exprList, finalModel, algo, &resolvedExpressions, cache);
          // Behavioral model uses this technique to limit the checksum output.
          computedResult = std::min(computedResult, maxHashInt);
          // Assign a value to the @param result using the computed result
@@ -240,7 +245,7 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
      {"result", "algo", "data"},
      [](cstring /*concolicMethodName*/, const IR::ConcolicVariable *var,
         const ExecutionState & /*state*/, const Model &finalModel,
-        ConcolicVariableMap *resolvedConcolicVariables) {
+        ConcolicVariableMap *resolvedConcolicVariables, ConcolicCache &cache) {
          // Assign arguments to concrete variables and perform type checking.
          const auto *args = var->arguments;
          const auto *checksumVar = args->at(0)->expression;
@@ -268,7 +273,8 @@ const ConcolicMethodImpls::ImplList Bmv2Concolic::BMV2_CONCOLIC_METHOD_IMPLS{
 
          big_int computedResult = 0;
          // If max is 0, the value written to computedResult will always be base.
-         computedResult = computeChecksum(exprList, finalModel, algo, &resolvedExpressions);
+         computedResult =
+             computeChecksum(exprList, finalModel, algo, &resolvedExpressions, cache);
          // Behavioral model uses this technique to limit the checksum output.
          computedResult = std::min(computedResult, maxHashInt);
          // Assign a value to the @param result using the computed result
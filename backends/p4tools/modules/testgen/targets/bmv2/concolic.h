@@ -41,10 +41,12 @@ class Bmv2Concolic : public Concolic {
     static const ConcolicMethodImpls::ImplList BMV2_CONCOLIC_METHOD_IMPLS;
 
     /// Call into a behavioral model helper function to compute the appropriate checksum. The
-    /// checksum is determined by @param algo.
+    /// checksum is determined by @param algo. Checksums of inputs seen before are taken from
+    /// @param cache.
     static big_int computeChecksum(const std::vector<const IR::Expression *> &exprList,
                                    const Model &finalModel, int algo,
-                                   Model::ExpressionMap *resolvedExpressions);
+                                   Model::ExpressionMap *resolvedExpressions,
+                                   ConcolicCache &cache);
 
     /// Compute a payload using the provided model and update the resolved concolic variables. Then
     /// return the computed payload expression. If the payload did not previously exist, a random
@@ -272,6 +272,8 @@ const Optional *Optional::evaluate(const Model &model, bool doComplete) const {
 
 cstring Optional::getObjectName() const { return "Optional"; }
 
+std::vector<const IR::Expression *> Optional::getMatchValues() const { return {value}; }
+
 bool Optional::addAsExactMatch() const { return addMatch; }
 
 Range::Range(const IR::KeyElement *key, const IR::Expression *low, const IR::Expression *high)
@@ -328,4 +330,6 @@ void MetadataCollection::addMetaDataField(cstring name, const IR::Literal *metad
 
 cstring Range::getObjectName() const { return "Range"; }
 
+std::vector<const IR::Expression *> Range::getMatchValues() const { return {low, high}; }
+
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -320,6 +320,8 @@ class Optional : public TableMatch {
 
     [[nodiscard]] cstring getObjectName() const override;
 
+    [[nodiscard]] std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the match value. It is expected to be a constant at this point.
     /// A BUG is thrown otherwise.
     [[nodiscard]] const IR::Constant *getEvaluatedValue() const;
@@ -344,6 +346,8 @@ class Range : public TableMatch {
 
     [[nodiscard]] cstring getObjectName() const override;
 
+    [[nodiscard]] std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the inclusive start of the range. It is expected to be a constant at this point.
     /// A BUG is thrown otherwise.
     [[nodiscard]] const IR::Constant *getEvaluatedLow() const;
@@ -185,6 +185,8 @@ class Optional : public TableMatch {
 
     cstring getObjectName() const override;
 
+    std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the match value. It is expected to be a constant at this point.
     /// A BUG is thrown otherwise.
     const IR::Constant *getEvaluatedValue() const;
@@ -209,6 +211,8 @@ class Range : public TableMatch {
 
     cstring getObjectName() const override;
 
+    std::vector<const IR::Expression *> getMatchValues() const override;
+
     /// @returns the inclusive start of the range. It is expected to be a constant at this point.
     /// A BUG is thrown otherwise.
     const IR::Constant *getEvaluatedLow() const;
@@ -0,0 +1,56 @@
+#include "backends/p4tools/modules/testgen/lib/async_file_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::AsyncFileWriter;
+
+class AsyncFileWriterTest : public P4ToolsTest {};
+
+std::string readFile(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/// Writes are executed in order, also when the queue is full, and flush waits for all of them.
+TEST_F(AsyncFileWriterTest, WritesInOrder) {
+    auto dir = std::filesystem::temp_directory_path() / "async_file_writer_test";
+    std::filesystem::create_directories(dir);
+    auto appended = dir / "appended.txt";
+    std::string expected = "preamble\n";
+    {
+        AsyncFileWriter writer(2);
+        writer.write(appended, "stale content\n");
+        writer.write(appended, expected);
+        for (int i = 0; i < 100; i++) {
+            auto line = std::to_string(i) + "\n";
+            writer.write(appended, line, true);
+            writer.write(dir / ("test_" + std::to_string(i) + ".txt"), line);
+            expected += line;
+        }
+        writer.flush();
+        EXPECT_EQ(readFile(appended), expected);
+        EXPECT_EQ(readFile(dir / "test_42.txt"), "42\n");
+
+        // Destroying the writer waits for the pending writes.
+        writer.write(appended, "last\n", true);
+    }
+    EXPECT_EQ(readFile(appended), expected + "last\n");
+    std::filesystem::remove_all(dir);
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -0,0 +1,46 @@
+#include "backends/p4tools/common/lib/model.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::Model;
+using P4Tools::SymbolicMapping;
+
+class ModelTest : public P4ToolsTest {};
+
+/// A model only satisfies constraints it can evaluate on its own.
+TEST_F(ModelTest, Satisfies) {
+    const auto *type = IR::getBitType(8);
+    const auto *bound = P4Tools::ToolsVariables::getSymbolicVariable(type, "bound");
+    const auto *unbound = P4Tools::ToolsVariables::getSymbolicVariable(type, "unbound");
+    Model model(SymbolicMapping{{bound, IR::getConstant(type, 1)}});
+
+    const auto *isOne = new IR::Equ(IR::Type_Boolean::get(), bound, IR::getConstant(type, 1));
+    const auto *isTwo = new IR::Equ(IR::Type_Boolean::get(), bound, IR::getConstant(type, 2));
+    const auto *isUnbound = new IR::Equ(IR::Type_Boolean::get(), unbound, bound);
+    EXPECT_TRUE(model.satisfies({isOne}));
+    EXPECT_FALSE(model.satisfies({isOne, isTwo}));
+    EXPECT_FALSE(model.satisfies({isOne, isUnbound}));
+    // Constraints before the given index are not checked.
+    EXPECT_TRUE(model.satisfies({isTwo, isOne}, 1));
+
+    // Binding a variable makes constraints over it decidable.
+    model.set(unbound, IR::getConstant(type, 1));
+    EXPECT_TRUE(model.satisfies({isOne, isUnbound}));
+}
+
+}  // namespace
+
+}  // namespace Test
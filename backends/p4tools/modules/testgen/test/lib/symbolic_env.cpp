@@ -0,0 +1,54 @@
+#include "backends/p4tools/common/lib/symbolic_env.h"
+
+#include <gtest/gtest.h>
+
+#include "ir/ir.h"
+#include "ir/irutils.h"
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::StateVariableIds;
+using P4Tools::SymbolicEnv;
+
+class SymbolicEnvTest : public P4ToolsTest {};
+
+const IR::Member *mkMember(const char *header, const char *field) {
+    return new IR::Member(IR::getBitType(8), new IR::PathExpression(header), field);
+}
+
+/// Equal state variables share their ID and their value, also if they are different IR nodes.
+TEST_F(SymbolicEnvTest, InternedVariables) {
+    const IR::StateVariable hdrA(mkMember("h", "a"));
+    const IR::StateVariable hdrB(mkMember("h", "b"));
+    EXPECT_EQ(StateVariableIds::get(hdrA),
+              StateVariableIds::get(IR::StateVariable(mkMember("h", "a"))));
+    EXPECT_NE(StateVariableIds::get(hdrA), StateVariableIds::get(hdrB));
+    EXPECT_TRUE(StateVariableIds::getVariable(StateVariableIds::get(hdrB)) == hdrB);
+
+    SymbolicEnv env;
+    const IR::StateVariable hdrC(mkMember("h", "c"));
+    EXPECT_FALSE(env.exists(hdrC));
+    env.set(hdrB, IR::getConstant(IR::getBitType(8), 2));
+    env.set(IR::StateVariable(mkMember("h", "a")), IR::getConstant(IR::getBitType(8), 1));
+    EXPECT_TRUE(env.exists(hdrA));
+    EXPECT_FALSE(env.exists(hdrC));
+    EXPECT_TRUE(env.get(hdrA)->equiv(*IR::getConstant(IR::getBitType(8), 1)));
+
+    // The copy of an environment is independent of the original.
+    SymbolicEnv copy = env;
+    copy.set(hdrA, IR::getConstant(IR::getBitType(8), 3));
+    EXPECT_TRUE(env.get(hdrA)->equiv(*IR::getConstant(IR::getBitType(8), 1)));
+
+    // The map of the environment is ordered by variable.
+    auto map = env.getInternalMap();
+    ASSERT_EQ(map.size(), 2U);
+    EXPECT_TRUE(map.begin()->first == hdrA);
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -0,0 +1,91 @@
+#include "backends/p4tools/modules/testgen/lib/concolic.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "backends/p4tools/common/lib/model.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "lib/big_int_util.h"
+
+#include "backends/p4tools/modules/testgen/lib/continuation.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/targets/bmv2/concolic.h"
+#include "backends/p4tools/modules/testgen/test/small-step/util.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::Model;
+using P4Tools::SymbolicMapping;
+using P4Tools::P4Testgen::ConcolicCache;
+using P4Tools::P4Testgen::ConcolicMethodImpls;
+using P4Tools::P4Testgen::ConcolicVariableMap;
+using P4Tools::P4Testgen::Bmv2::Bmv2Concolic;
+
+/// Results are only computed for inputs that have not been seen before.
+TEST_F(SmallStepTest, ConcolicCache01) {
+    ConcolicCache cache;
+    int computed = 0;
+    auto sum = [&computed](const std::vector<char> &input) {
+        computed++;
+        big_int result = 0;
+        for (auto byte : input) {
+            result += byte;
+        }
+        return result;
+    };
+
+    EXPECT_EQ(cache.lookup({0, {1, 2}}, sum), 3);
+    EXPECT_EQ(cache.lookup({0, {1, 2}}, sum), 3);
+    EXPECT_EQ(computed, 1);
+    EXPECT_EQ(cache.getHits(), 1U);
+
+    // The function identifier is part of the key.
+    EXPECT_EQ(cache.lookup({1, {1, 2}}, sum), 3);
+    EXPECT_EQ(cache.lookup({0, {2, 2}}, sum), 4);
+    EXPECT_EQ(computed, 3);
+    EXPECT_EQ(cache.getHits(), 1U);
+}
+
+/// Resolving two checksums over the same data computes the checksum once.
+TEST_F(SmallStepTest, ConcolicCache02) {
+    const auto *type = IR::getBitType(16);
+    const auto *result = new IR::PathExpression(type, new IR::Path("result"));
+    // The value of csum16 in the algorithms of the behavioral model.
+    const auto *algo = IR::getConstant(IR::getBitType(32), 6);
+    IR::IndexedVector<IR::NamedExpression> components;
+    components.push_back(new IR::NamedExpression("a", IR::getConstant(type, 0x1234)));
+    components.push_back(new IR::NamedExpression("b", IR::getConstant(type, 0x5678)));
+    const auto *data = new IR::StructExpression(IR::Type_Unknown::get(), nullptr, components);
+    auto *arguments = new IR::Vector<IR::Argument>();
+    arguments->push_back(new IR::Argument(result));
+    arguments->push_back(new IR::Argument(algo));
+    arguments->push_back(new IR::Argument(data));
+    const auto *first = new IR::ConcolicVariable(type, "*method_checksum", arguments, 0, 0);
+    const auto *second = new IR::ConcolicVariable(type, "*method_checksum", arguments, 1, 0);
+
+    ExecutionState state = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    Model model(SymbolicMapping{});
+    ConcolicMethodImpls impls(*Bmv2Concolic::getBmv2ConcolicMethodImpls());
+    ConcolicCache cache;
+    ConcolicVariableMap resolvedConcolicVariables;
+    ASSERT_TRUE(impls.exec("*method_checksum", first, state, model, &resolvedConcolicVariables,
+                           cache));
+    EXPECT_EQ(cache.getHits(), 0U);
+    ASSERT_TRUE(impls.exec("*method_checksum", second, state, model, &resolvedConcolicVariables,
+                           cache));
+    EXPECT_EQ(cache.getHits(), 1U);
+
+    const auto *firstValue = resolvedConcolicVariables.at(*first);
+    const auto *secondValue = resolvedConcolicVariables.at(*second);
+    EXPECT_TRUE(firstValue->equiv(*secondValue));
+    // The ones' complement of 0x1234 + 0x5678.
+    EXPECT_TRUE(firstValue->equiv(*IR::getConstant(type, 0x9753)));
+}
+
+}  // anonymous namespace
+
+}  // namespace Test
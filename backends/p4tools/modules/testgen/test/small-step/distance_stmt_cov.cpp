@@ -0,0 +1,117 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/distance_stmt_cov.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "ir/ir.h"
+#include "midend/coverage.h"
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/test/small-step/util.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::DistanceStmtSelection;
+using P4Tools::P4Testgen::FinalState;
+using P4Tools::P4Testgen::PathSelectionPolicy;
+using P4Tools::P4Testgen::TestgenOptions;
+
+/// After the first test, every test covers a statement that no test before it covered: rolling
+/// back always picks a branch that is about to execute an uncovered statement.
+TEST_F(SmallStepTest, DistanceStmtSelection01) {
+    auto source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H {
+  bit<8> a;
+  bit<8> b;
+  bit<8> c;
+  bit<8> d;
+}
+
+struct Headers {
+  H h;
+}
+
+struct Metadata { }
+
+parser parse(packet_in pkt,
+             out Headers hdr,
+             inout Metadata metadata,
+             inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.h);
+      transition accept;
+  }
+}
+
+control mau(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {
+    if (hdr.h.a == 1) {
+      hdr.h.d = 1;
+    }
+    if (hdr.h.b == 1) {
+      hdr.h.d = 2;
+    }
+    if (hdr.h.c == 1) {
+      hdr.h.d = 3;
+    }
+  }
+}
+
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.h);
+  }
+}
+
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+V1Switch(parse(), verifyChecksum(), mau(), mau(), computeChecksum(), deparse()) main;)");
+    auto testCase = P4ToolsTestCase::create_16("bmv2", "v1model", source);
+    ASSERT_TRUE(testCase);
+
+    // The DCG and the coverable statements are collected with the program information.
+    auto &options = TestgenOptions::get();
+    auto previousPolicy = options.pathSelectionPolicy;
+    auto previousCoverage = options.coverageOptions;
+    options.pathSelectionPolicy = PathSelectionPolicy::DistanceStmtCoverage;
+    options.coverageOptions.coverStatements = true;
+    const auto *progInfo = TestgenTarget::initProgram(testCase->program);
+    options.pathSelectionPolicy = previousPolicy;
+    options.coverageOptions = previousCoverage;
+    ASSERT_TRUE(progInfo);
+    ASSERT_TRUE(progInfo->dcg);
+    const auto &coverableNodes = progInfo->getCoverableNodes();
+    ASSERT_FALSE(coverableNodes.empty());
+
+    Z3Solver solver;
+    DistanceStmtSelection symbex(solver, *progInfo);
+    size_t tests = 0;
+    symbex.run([&](const FinalState &finalState) {
+        tests++;
+        size_t covered = symbex.getVisitedNodes().size();
+        symbex.updateVisitedNodes(finalState.getVisited());
+        EXPECT_GT(symbex.getVisitedNodes().size(), covered) << "Test " << tests;
+        return symbex.getVisitedNodes().size() == coverableNodes.size();
+    });
+    EXPECT_EQ(symbex.getVisitedNodes().size(), coverableNodes.size());
+    // The first test, and at most one more test per assignment.
+    EXPECT_LE(tests, 4U);
+}
+
+}  // anonymous namespace
+
+}  // namespace Test
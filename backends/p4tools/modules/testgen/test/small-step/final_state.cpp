@@ -0,0 +1,171 @@
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+
+#include "backends/p4tools/modules/testgen/lib/concolic.h"
+#include "backends/p4tools/modules/testgen/lib/continuation.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/test_backend.h"
+#include "backends/p4tools/modules/testgen/lib/test_spec.h"
+#include "backends/p4tools/modules/testgen/test/small-step/util.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::ActionArg;
+using P4Tools::P4Testgen::ActionCall;
+using P4Tools::P4Testgen::ConcolicVariableMap;
+using P4Tools::P4Testgen::FinalState;
+using P4Tools::P4Testgen::TableConfig;
+using P4Tools::P4Testgen::TableMatchMap;
+using P4Tools::P4Testgen::TableRule;
+using P4Tools::P4Testgen::Ternary;
+using P4Tools::P4Testgen::TestBackEnd;
+
+/// Collects the labels of the variables that a blocking constraint excludes.
+void collectBlockedLabels(const IR::Expression *constraint, std::set<cstring> &labels) {
+    if (const auto *lOr = constraint->to<IR::LOr>()) {
+        collectBlockedLabels(lOr->left, labels);
+        collectBlockedLabels(lOr->right, labels);
+        return;
+    }
+    labels.insert(constraint->checkedTo<IR::Neq>()->left->checkedTo<IR::SymbolicVariable>()->label);
+}
+
+/// Variants of a final state enumerate the solutions of the path constraints without executing
+/// the path again.
+TEST_F(SmallStepTest, FinalStateVariant01) {
+    const auto *type = IR::getBitType(8);
+    const auto *entry = P4Tools::ToolsVariables::getSymbolicVariable(type, "table_key_entry");
+
+    ExecutionState state = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    state.pushPathConstraint(new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)));
+
+    Z3Solver solver;
+    ASSERT_EQ(solver.checkSat(state.getPathConstraint()), true);
+    const auto *finalState = new FinalState(solver, state);
+
+    // Every variant must choose a different value than all the variants before it.
+    std::set<big_int> values;
+    std::vector<const P4Tools::Constraint *> blockingConstraints;
+    for (int idx = 0; idx < 3; ++idx) {
+        const auto *value = finalState->getFinalModel().evaluate(entry, true);
+        ASSERT_TRUE(value->is<IR::Constant>());
+        EXPECT_TRUE(values.insert(value->checkedTo<IR::Constant>()->value).second);
+        blockingConstraints.push_back(new IR::Neq(IR::Type_Boolean::get(), entry, value));
+        auto variantOpt = finalState->computeVariantState(blockingConstraints);
+        ASSERT_EQ(variantOpt.has_value(), idx < 2);
+        if (variantOpt.has_value()) {
+            finalState = &variantOpt.value().get();
+            EXPECT_EQ(finalState->getExecutionState(), &state);
+        }
+    }
+}
+
+/// The blocking constraint of a final state only excludes the variables that the table
+/// configurations on its path supply through the control plane, whatever their labels are.
+TEST_F(SmallStepTest, FinalStateBlockingConstraint01) {
+    const auto *type = IR::getBitType(8);
+    const auto *value = P4Tools::ToolsVariables::getSymbolicVariable(type, "value");
+    const auto *mask = P4Tools::ToolsVariables::getSymbolicVariable(type, "mask");
+    const auto *arg = P4Tools::ToolsVariables::getSymbolicVariable(type, "arg");
+    const auto *other = P4Tools::ToolsVariables::getSymbolicVariable(type, "t_key_other");
+
+    ExecutionState state = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    for (const auto *variable : {value, mask, arg, other}) {
+        state.pushPathConstraint(
+            new IR::Leq(IR::Type_Boolean::get(), variable, IR::getConstant(type, 2)));
+    }
+    TableMatchMap matches;
+    matches.emplace("k", new Ternary(nullptr, value, mask));
+    std::vector<TableRule> rules;
+    rules.emplace_back(matches, 0, ActionCall("a", nullptr, {ActionArg(nullptr, arg)}), 0);
+    state.addTestObject("tableconfigs", "t", new TableConfig(nullptr, rules));
+
+    Z3Solver solver;
+    ASSERT_EQ(solver.checkSat(state.getPathConstraint()), true);
+    FinalState finalState(solver, state);
+    const auto *blockingConstraint = TestBackEnd::computeControlPlaneBlockingConstraint(finalState);
+    ASSERT_NE(blockingConstraint, nullptr);
+    std::set<cstring> labels;
+    collectBlockedLabels(blockingConstraint, labels);
+    EXPECT_EQ(labels, (std::set<cstring>{"value", "mask", "arg"}));
+}
+
+/// If the path constraints do not depend on the concolic variables, the final model with the
+/// concolic assignments applied is the concolic model and the solver is not invoked.
+TEST_F(SmallStepTest, FinalStateConcolic01) {
+    const auto *type = IR::getBitType(8);
+    const auto *entry = P4Tools::ToolsVariables::getSymbolicVariable(type, "table_key_entry");
+    const auto *checksum =
+        new IR::ConcolicVariable(type, "checksum", new IR::Vector<IR::Argument>(), 0, 0);
+
+    ExecutionState state = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    state.pushPathConstraint(new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)));
+
+    CountingSolver solver;
+    ASSERT_EQ(solver.checkSat(state.getPathConstraint()), true);
+    const auto *finalState = new FinalState(solver, state);
+    const auto *entryValue = finalState->getFinalModel().evaluate(entry, true);
+    solver.calls = 0;
+
+    ConcolicVariableMap resolvedConcolicVariables;
+    resolvedConcolicVariables.emplace(*checksum, IR::getConstant(type, 7));
+    auto concolicState = finalState->computeConcolicState(resolvedConcolicVariables);
+    ASSERT_TRUE(concolicState.has_value());
+    EXPECT_EQ(solver.calls, 0U);
+    const auto &concolicModel = concolicState.value().get().getFinalModel();
+    EXPECT_TRUE(concolicModel.evaluate(checksum, true)->equiv(*IR::getConstant(type, 7)));
+    EXPECT_TRUE(concolicModel.evaluate(entry, true)->equiv(*entryValue));
+}
+
+/// If the path constraints depend on a concolic variable and the final model contradicts its
+/// assignment, the solver computes a new model.
+TEST_F(SmallStepTest, FinalStateConcolic02) {
+    const auto *type = IR::getBitType(8);
+    const auto *entry = P4Tools::ToolsVariables::getSymbolicVariable(type, "table_key_entry");
+    const auto *checksum =
+        new IR::ConcolicVariable(type, "checksum", new IR::Vector<IR::Argument>(), 0, 0);
+
+    ExecutionState state = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    state.pushPathConstraint(new IR::Equ(IR::Type_Boolean::get(), entry, checksum));
+    state.pushPathConstraint(new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 4)));
+
+    CountingSolver solver;
+    ASSERT_EQ(solver.checkSat(state.getPathConstraint()), true);
+    const auto *finalState = new FinalState(solver, state);
+    const auto *checksumValue = finalState->getFinalModel().evaluate(checksum, true);
+    solver.calls = 0;
+
+    // No model of the path assigns 7 to the checksum, so the path is infeasible.
+    ConcolicVariableMap resolvedConcolicVariables;
+    resolvedConcolicVariables.emplace(*checksum, IR::getConstant(type, 7));
+    EXPECT_FALSE(finalState->computeConcolicState(resolvedConcolicVariables).has_value());
+    EXPECT_EQ(solver.calls, 1U);
+
+    // Any other value up to 4 is feasible, but the entry has to follow it.
+    const auto *assignment =
+        IR::getConstant(type, checksumValue->equiv(*IR::getConstant(type, 3)) ? 4 : 3);
+    resolvedConcolicVariables.clear();
+    resolvedConcolicVariables.emplace(*checksum, assignment);
+    auto concolicState = finalState->computeConcolicState(resolvedConcolicVariables);
+    ASSERT_TRUE(concolicState.has_value());
+    EXPECT_EQ(solver.calls, 2U);
+    const auto &concolicModel = concolicState.value().get().getFinalModel();
+    EXPECT_TRUE(concolicModel.evaluate(entry, true)->equiv(*assignment));
+}
+
+}  // anonymous namespace
+
+}  // namespace Test
@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/core/small_step/state_merger.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
+#include "backends/p4tools/modules/testgen/lib/continuation.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/test/small-step/util.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::DepthFirstSearch;
+using P4Tools::P4Testgen::FinalState;
+using P4Tools::P4Testgen::StateMerger;
+using P4Tools::P4Testgen::TestgenOptions;
+
+/// A clone of @param base that assigns @param value to @param var after constraining the
+/// symbolic @param input to it.
+ExecutionState &mkAssigningState(const ExecutionState &base, const IR::StateVariable &var,
+                                 const IR::Expression *input, int value) {
+    const auto *type = input->type;
+    auto &state = base.clone();
+    state.pushPathConstraint(
+        new IR::Equ(IR::Type_Boolean::get(), input, IR::getConstant(type, value)));
+    state.set(var, IR::getConstant(type, value));
+    return state;
+}
+
+/// Runs the depth-first executor over @param program. @returns the number of final states, and
+/// the number of merges if state merging was enabled.
+std::pair<size_t, std::optional<uint64_t>> runExecutor(const IR::P4Program *program,
+                                                        bool stateMerging) {
+    auto &options = TestgenOptions::get();
+    options.stateMerging = stateMerging;
+    const auto *progInfo = TestgenTarget::initProgram(program);
+    EXPECT_TRUE(progInfo);
+    if (progInfo == nullptr) {
+        options.stateMerging = false;
+        return {0, std::nullopt};
+    }
+
+    Z3Solver solver;
+    DepthFirstSearch symbex(solver, *progInfo);
+    options.stateMerging = false;
+    size_t finalStates = 0;
+    symbex.run([&finalStates](const FinalState & /*finalState*/) {
+        finalStates++;
+        return false;
+    });
+    std::optional<uint64_t> merges;
+    if (const auto *stateMerger = symbex.getStateMerger()) {
+        merges = stateMerger->getStats().merged;
+    }
+    return {finalStates, merges};
+}
+
+/// Merging two states that assign different values to a variable keeps both executions, each
+/// with its own value.
+TEST_F(SmallStepTest, StateMerging01) {
+    const auto *type = IR::getBitType(8);
+    const auto *input = P4Tools::ToolsVariables::getSymbolicVariable(type, "input");
+    const IR::StateVariable var(new IR::Member(type, new IR::PathExpression("h"), "f"));
+
+    ExecutionState base = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    base.set(var, IR::getConstant(type, 0));
+    base.pushPathConstraint(
+        new IR::Leq(IR::Type_Boolean::get(), input, IR::getConstant(type, 100)));
+
+    auto &taken = base.clone();
+    taken.pushPathConstraint(new IR::Equ(IR::Type_Boolean::get(), input, IR::getConstant(type, 1)));
+    taken.set(var, IR::getConstant(type, 10));
+    auto &notTaken = base.clone();
+    notTaken.pushPathConstraint(
+        new IR::Neq(IR::Type_Boolean::get(), input, IR::getConstant(type, 1)));
+    notTaken.set(var, IR::getConstant(type, 20));
+
+    // The base state has no path constraints of its own to select its values.
+    ASSERT_FALSE(taken.isMergeableWith(base, 1));
+    ASSERT_FALSE(taken.isMergeableWith(notTaken, 0));
+    ASSERT_TRUE(taken.isMergeableWith(notTaken, 1));
+
+    auto &merged = taken.merge(notTaken);
+    EXPECT_EQ(merged.getMergeCount(), 1);
+    EXPECT_EQ(merged.getBody(), base.getBody());
+    const auto *value = merged.getSymbolicEnv().get(var);
+    ASSERT_TRUE(value->is<IR::SymbolicVariable>());
+
+    Z3Solver solver;
+    for (auto [inputValue, expected] : std::vector<std::pair<int, int>>{{1, 10}, {2, 20}}) {
+        auto constraints = merged.getPathConstraint();
+        constraints.push_back(
+            new IR::Equ(IR::Type_Boolean::get(), input, IR::getConstant(type, inputValue)));
+        auto matching = constraints;
+        matching.push_back(
+            new IR::Equ(IR::Type_Boolean::get(), value, IR::getConstant(type, expected)));
+        EXPECT_EQ(solver.checkSat(matching), true);
+        constraints.push_back(
+            new IR::Neq(IR::Type_Boolean::get(), value, IR::getConstant(type, expected)));
+        EXPECT_EQ(solver.checkSat(constraints), false);
+    }
+}
+
+/// Independent merges with the same merge count create variables with distinct names.
+TEST_F(SmallStepTest, StateMergingFreshNames) {
+    const auto *type = IR::getBitType(8);
+    const IR::StateVariable first(new IR::Member(type, new IR::PathExpression("h"), "f"));
+    const IR::StateVariable second(new IR::Member(type, new IR::PathExpression("h"), "g"));
+
+    std::vector<cstring> labels;
+    for (const auto *name : {"input1", "input2"}) {
+        const auto *input = P4Tools::ToolsVariables::getSymbolicVariable(type, name);
+        ExecutionState base = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+        base.set(first, IR::getConstant(type, 0));
+        base.set(second, IR::getConstant(type, 0));
+        auto &taken = mkAssigningState(base, first, input, 10);
+        taken.set(second, IR::getConstant(type, 11));
+        auto &notTaken = mkAssigningState(base, first, input, 20);
+        notTaken.set(second, IR::getConstant(type, 21));
+
+        ASSERT_TRUE(taken.isMergeableWith(notTaken, 2));
+        auto &merged = taken.merge(notTaken);
+        EXPECT_EQ(merged.getMergeCount(), 1);
+        for (const auto &var : {first, second}) {
+            const auto *value = merged.getSymbolicEnv().get(var)->to<IR::SymbolicVariable>();
+            ASSERT_NE(value, nullptr);
+            labels.push_back(value->label);
+        }
+    }
+    std::sort(labels.begin(), labels.end());
+    EXPECT_EQ(std::unique(labels.begin(), labels.end()), labels.end());
+}
+
+/// The merger parks the first state at a parser state, merges compatible states into it and
+/// lets a released state execute its parser state.
+TEST_F(SmallStepTest, StateMerger01) {
+    const auto *type = IR::getBitType(8);
+    const auto *input = P4Tools::ToolsVariables::getSymbolicVariable(type, "input");
+    const IR::StateVariable var(new IR::Member(type, new IR::PathExpression("h"), "f"));
+    const auto *parserState = new IR::ParserState("join", nullptr);
+    const auto *otherState = new IR::ParserState("other", nullptr);
+
+    ExecutionState base = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    base.set(var, IR::getConstant(type, 0));
+
+    StateMerger merger;
+    EXPECT_EQ(merger.release(), nullptr);
+    auto &first = mkAssigningState(base, var, input, 10);
+    EXPECT_TRUE(merger.arrive(first, parserState));
+    EXPECT_TRUE(merger.arrive(mkAssigningState(base, var, input, 20), parserState));
+    EXPECT_TRUE(merger.arrive(mkAssigningState(base, var, input, 30), otherState));
+    EXPECT_EQ(merger.getStats().parked, 2U);
+    EXPECT_EQ(merger.getStats().merged, 1U);
+
+    // The merged state replaces the parked one and executes its parser state once released.
+    auto *released = merger.release();
+    ASSERT_NE(released, nullptr);
+    EXPECT_NE(released, &first);
+    EXPECT_EQ(released->getMergeCount(), 1);
+    EXPECT_FALSE(merger.arrive(*released, parserState));
+    ASSERT_NE(merger.release(), nullptr);
+    EXPECT_EQ(merger.release(), nullptr);
+
+    // A state that was merged too often is not parked again.
+    auto *merged = &mkAssigningState(base, var, input, 0);
+    for (int value = 1; value <= StateMerger::MAX_MERGES; value++) {
+        merged = &merged->merge(mkAssigningState(base, var, input, value));
+    }
+    EXPECT_FALSE(merger.arrive(*merged, parserState));
+    EXPECT_EQ(merger.release(), nullptr);
+}
+
+/// Two parser paths that join in one parser state are explored once past the join when state
+/// merging is enabled.
+TEST_F(SmallStepTest, StateMergingExecutor) {
+    auto source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H {
+  bit<8> a;
+  bit<8> b;
+}
+
+struct Headers {
+  H h;
+}
+
+struct Metadata { }
+
+parser parse(packet_in pkt,
+             out Headers hdr,
+             inout Metadata metadata,
+             inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.h);
+      transition select(hdr.h.a) {
+          1: one;
+          default: other;
+      }
+  }
+  state one {
+      hdr.h.b = 10;
+      transition join;
+  }
+  state other {
+      hdr.h.b = 20;
+      transition join;
+  }
+  state join {
+      transition select(hdr.h.b) {
+          10: accept;
+          default: reject;
+      }
+  }
+}
+
+control mau(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply { }
+}
+
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.h);
+  }
+}
+
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+V1Switch(parse(), verifyChecksum(), mau(), mau(), computeChecksum(), deparse()) main;)");
+    auto testCase = P4ToolsTestCase::create_16("bmv2", "v1model", source);
+    ASSERT_TRUE(testCase);
+
+    auto [plainFinalStates, plainMerges] = runExecutor(testCase->program, false);
+    EXPECT_FALSE(plainMerges.has_value());
+    auto [mergedFinalStates, merges] = runExecutor(testCase->program, true);
+    ASSERT_TRUE(merges.has_value());
+    EXPECT_GT(*merges, 0U);
+    EXPECT_GT(mergedFinalStates, 0U);
+    EXPECT_LT(mergedFinalStates, plainFinalStates);
+}
+
+}  // anonymous namespace
+
+}  // namespace Test
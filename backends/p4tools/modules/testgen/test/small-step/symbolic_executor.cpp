@@ -0,0 +1,207 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/model.h"
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "test/gtest/helpers.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/lib/continuation.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+#include "backends/p4tools/modules/testgen/test/small-step/util.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::Model;
+using P4Tools::P4Testgen::ExecutionStateReference;
+using P4Tools::P4Testgen::FinalState;
+using P4Tools::P4Testgen::ProgramInfo;
+using P4Tools::P4Testgen::SymbolicExecutor;
+
+/// Exposes the branch evaluation of the symbolic executor.
+class BranchEvaluator : public SymbolicExecutor {
+ public:
+    using SymbolicExecutor::evaluateBranch;
+    using SymbolicExecutor::SymbolicExecutor;
+
+    /// The states execution was started from.
+    std::vector<const ExecutionState *> startStates;
+
+    void runImpl(const Callback & /*callBack*/, ExecutionStateReference executionState) override {
+        startStates.push_back(&executionState.get());
+    }
+};
+
+/// A solver whose first queries time out.
+class TimingOutSolver : public CountingSolver {
+ public:
+    size_t timeouts = 0;
+
+    std::optional<bool> checkSat(const std::vector<const P4Tools::Constraint *> &asserts) override {
+        if (timeouts > 0) {
+            timeouts--;
+            calls++;
+            return std::nullopt;
+        }
+        return CountingSolver::checkSat(asserts);
+    }
+};
+
+const ProgramInfo *mkProgramInfo() {
+    auto source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H {
+  bit<8> a;
+}
+
+struct Headers {
+  H h;
+}
+
+struct Metadata { }
+
+parser parse(packet_in pkt,
+             out Headers hdr,
+             inout Metadata metadata,
+             inout standard_metadata_t sm) {
+  state start {
+      pkt.extract(hdr.h);
+      transition accept;
+  }
+}
+
+control mau(inout Headers hdr, inout Metadata meta, inout standard_metadata_t sm) {
+  apply {}
+}
+
+control deparse(packet_out pkt, in Headers hdr) {
+  apply {
+    pkt.emit(hdr.h);
+  }
+}
+
+control verifyChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+control computeChecksum(inout Headers hdr, inout Metadata meta) {
+  apply {}
+}
+
+V1Switch(parse(), verifyChecksum(), mau(), mau(), computeChecksum(), deparse()) main;)");
+    auto testCase = P4ToolsTestCase::create_16("bmv2", "v1model", source);
+    if (!testCase) {
+        return nullptr;
+    }
+    return TestgenTarget::initProgram(testCase->program);
+}
+
+/// Branches whose constraints the model of the parent state satisfies are decided without the
+/// solver. All other branches are checked by the solver.
+TEST_F(SmallStepTest, EvaluateBranch01) {
+    const auto *progInfo = mkProgramInfo();
+    ASSERT_TRUE(progInfo);
+
+    const auto *type = IR::getBitType(8);
+    const auto *entry = P4Tools::ToolsVariables::getSymbolicVariable(type, "entry");
+    ExecutionState parent = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+    parent.pushPathConstraint(
+        new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)));
+
+    CountingSolver solver;
+    BranchEvaluator symbex(solver, *progInfo);
+    ASSERT_EQ(solver.checkSat(parent.getPathConstraint()), true);
+    const auto *parentModel = new Model(solver.getSymbolicMapping());
+    parent.setPathModel(parentModel);
+    const auto *entryValue = parentModel->evaluate(entry, true);
+    solver.calls = 0;
+
+    // The parent model satisfies a weaker constraint.
+    auto &weaker = parent.clone();
+    EXPECT_TRUE(symbex.evaluateBranch(
+        SymbolicExecutor::Branch(
+            new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 5)), parent, weaker),
+        solver));
+    EXPECT_EQ(solver.calls, 0U);
+    EXPECT_EQ(symbex.getBranchCheckStats().modelHits, 1U);
+    EXPECT_EQ(symbex.getBranchCheckStats().solverQueries, 0U);
+    EXPECT_EQ(weaker.getPathModel().first, parentModel);
+
+    // The parent model violates a constraint that excludes its own value, the solver finds
+    // another one.
+    auto &other = parent.clone();
+    EXPECT_TRUE(symbex.evaluateBranch(
+        SymbolicExecutor::Branch(new IR::Neq(IR::Type_Boolean::get(), entry, entryValue), parent,
+                                 other),
+        solver));
+    EXPECT_EQ(solver.calls, 1U);
+    EXPECT_EQ(symbex.getBranchCheckStats().modelHits, 1U);
+    EXPECT_EQ(symbex.getBranchCheckStats().solverQueries, 1U);
+    const auto *otherModel = other.getPathModel().first;
+    ASSERT_NE(otherModel, nullptr);
+    EXPECT_NE(otherModel, parentModel);
+    EXPECT_FALSE(otherModel->evaluate(entry, true)->equiv(*entryValue));
+
+    // Infeasible branches are rejected by the solver.
+    auto &infeasible = parent.clone();
+    EXPECT_FALSE(symbex.evaluateBranch(
+        SymbolicExecutor::Branch(
+            new IR::Grt(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)), parent,
+            infeasible),
+        solver));
+    EXPECT_EQ(solver.calls, 2U);
+    EXPECT_EQ(symbex.getBranchCheckStats().modelHits, 1U);
+    EXPECT_EQ(symbex.getBranchCheckStats().solverQueries, 2U);
+}
+
+/// Branches whose check timed out are retried once all other branches have been explored.
+TEST_F(SmallStepTest, EvaluateBranch02) {
+    const auto *progInfo = mkProgramInfo();
+    ASSERT_TRUE(progInfo);
+
+    const auto *type = IR::getBitType(8);
+    const auto *entry = P4Tools::ToolsVariables::getSymbolicVariable(type, "entry");
+    ExecutionState parent = SmallStepTest::mkState(Body({Return(IR::getConstant(type, 0))}));
+
+    TimingOutSolver solver;
+    BranchEvaluator symbex(solver, *progInfo);
+    solver.timeouts = 2;
+    auto &dropped = parent.clone();
+    EXPECT_FALSE(symbex.evaluateBranch(
+        SymbolicExecutor::Branch(
+            new IR::Grt(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)), parent,
+            dropped),
+        solver));
+    auto &expensive = parent.clone();
+    EXPECT_FALSE(symbex.evaluateBranch(
+        SymbolicExecutor::Branch(
+            new IR::Leq(IR::Type_Boolean::get(), entry, IR::getConstant(type, 2)), parent,
+            expensive),
+        solver));
+    EXPECT_EQ(symbex.getBranchCheckStats().solverTimeouts, 2U);
+
+    // The first deferred branch times out again and is dropped, the second one is feasible.
+    solver.timeouts = 1;
+    symbex.run([](const FinalState & /*finalState*/) { return false; });
+    ASSERT_EQ(symbex.startStates.size(), 2U);
+    EXPECT_EQ(symbex.startStates.back(), &expensive);
+    EXPECT_NE(expensive.getPathModel().first, nullptr);
+    EXPECT_EQ(symbex.getBranchCheckStats().solverQueries, 4U);
+    EXPECT_EQ(symbex.getBranchCheckStats().solverTimeouts, 3U);
+    EXPECT_EQ(symbex.getBranchCheckStats().recoveredBranches, 1U);
+}
+
+}  // anonymous namespace
+
+}  // namespace Test
@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <stack>
@@ -44,6 +45,17 @@ class SmallStepTest : public P4ToolsTest {
     static ExecutionState mkState(Body body) { return ExecutionState(std::move(body)); }
 };
 
+/// A solver that counts its invocations.
+class CountingSolver : public Z3Solver {
+ public:
+    size_t calls = 0;
+
+    std::optional<bool> checkSat(const std::vector<const P4Tools::Constraint *> &asserts) override {
+        calls++;
+        return Z3Solver::checkSat(asserts);
+    }
+};
+
 namespace SmallStepUtil {
 
 /// Creates a test case with the given header fields for
@@ -33,6 +33,16 @@ class Z3SolverAccessor {
     /// Gets checkpoints that have been made. Used by GTests only.
     std::vector<size_t> &getCheckpoints() { return solver.checkpoints; }
 
+    /// Gets the number of constraints whose variables are memoized. Used by GTests only.
+    size_t getConstraintVariablesSize() { return solver.constraintVariables.size(); }
+
+    /// Gets the number of structural hashes computed for the translation cache. Used by GTests
+    /// only.
+    size_t getTranslationHashCount() { return solver.translationHashes.computedCount(); }
+
+    /// Whether the solver portfolio is enabled. Used by GTests only.
+    bool isPortfolioEnabled() { return solver.portfolio; }
+
  private:
     /// Pointer to a solver.
     Z3Solver &solver;
@@ -12,12 +12,15 @@
 
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/model.h"
+#include "backends/p4tools/common/lib/variables.h"
 #include "ir/declaration.h"
 #include "ir/indexed_vector.h"
 #include "ir/ir.h"
+#include "ir/irutils.h"
 #include "lib/big_int_util.h"
 #include "lib/cstring.h"
 #include "lib/enumerator.h"
+#include "lib/error.h"
 #include "lib/exceptions.h"
 #include "lib/log.h"
 #include "test/gtest/helpers.h"
@@ -206,6 +209,145 @@ TEST_F(Z3SolverTest, Assertion2Model) {
     ASSERT_TRUE((intA1 + intAddToA) % 16 < intB1);
 }
 
+/// Structurally equal assertions reuse the cached translation and still declare their variables.
+TEST_F(Z3SolverTest, TranslationCache) {
+    ASSERT_TRUE(opLss);
+
+    Z3Solver solver;
+    std::vector<const P4Tools::Constraint *> asserts{opLss};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    auto stats = solver.getTranslationCacheStats();
+    EXPECT_GT(stats.misses, 0U);
+
+    // A copy is a different node with the same structure.
+    const auto *copy =
+        new IR::Lss(opLss->srcInfo, opLss->type, opLss->left->clone(), opLss->right->clone());
+    asserts = {copy};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_GT(solver.getTranslationCacheStats().hits, stats.hits);
+    EXPECT_EQ(solver.getTranslationCacheStats().misses, stats.misses);
+    EXPECT_EQ(solver.getSymbolicMapping().size(), 2U);
+}
+
+/// Translating a long conjunction hashes each of its subexpressions once.
+TEST_F(Z3SolverTest, TranslationHashesSubexpressionsOnce) {
+    const int conjuncts = 500;
+    const auto *type = IR::Type_Bits::get(8);
+    const IR::Expression *chain = new IR::BoolLiteral(true);
+    for (int i = 0; i < conjuncts; i++) {
+        const auto *var =
+            P4Tools::ToolsVariables::getSymbolicVariable(type, "var" + std::to_string(i));
+        chain = new IR::LAnd(chain, new IR::Neq(var, IR::getConstant(type, i)));
+    }
+
+    Z3Solver solver;
+    Z3SolverAccessor solverAccessor(solver);
+    std::vector<const P4Tools::Constraint *> asserts{chain};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    // Each conjunct adds four nodes and the types are shared, while rehashing the children on
+    // each lookup would take quadratically many hashes.
+    EXPECT_LT(solverAccessor.getTranslationHashCount(), 5U * conjuncts);
+}
+
+/// Only the clusters of independent assertions that were not solved before are sent to Z3.
+TEST_F(Z3SolverTest, ConstraintSlicing) {
+    ASSERT_TRUE(opLss);
+
+    Z3Solver solver;
+    solver.setConstraintSlicing(true);
+    Z3SolverAccessor solverAccessor(solver);
+    std::vector<const P4Tools::Constraint *> asserts{opLss};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    auto symbolMap = solver.getSymbolicMapping();
+    ASSERT_EQ(symbolMap.size(), 2U);
+
+    // An assertion on an unrelated variable forms its own cluster.
+    const auto *type = IR::Type_Bits::get(8);
+    const auto *varC = P4Tools::ToolsVariables::getSymbolicVariable(type, "c");
+    const auto *eqC = new IR::Equ(IR::Type_Boolean::get(), varC, IR::getConstant(type, 3));
+    asserts.push_back(eqC);
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(solverAccessor.getP4Assertions().size(), 1U);
+    auto slicedMap = solver.getSymbolicMapping();
+    ASSERT_EQ(slicedMap.size(), 3U);
+    EXPECT_EQ(slicedMap.at(varC)->checkedTo<IR::Constant>()->value, 3);
+    for (const auto &[var, value] : symbolMap) {
+        EXPECT_TRUE(slicedMap.at(var)->equiv(*value));
+    }
+
+    // A contradiction in the new cluster does not need the cached one.
+    asserts.push_back(new IR::Neq(IR::Type_Boolean::get(), varC, IR::getConstant(type, 3)));
+    ASSERT_EQ(solver.checkSat(asserts), false);
+    EXPECT_EQ(solverAccessor.getP4Assertions().size(), 2U);
+}
+
+/// The variables of popped assertions are forgotten, the model still follows the new assertions.
+TEST_F(Z3SolverTest, ConstraintSlicingPop) {
+    ASSERT_TRUE(opLss);
+
+    Z3Solver solver;
+    solver.setConstraintSlicing(true);
+    Z3SolverAccessor solverAccessor(solver);
+    const auto *type = IR::Type_Bits::get(8);
+    const auto *varC = P4Tools::ToolsVariables::getSymbolicVariable(type, "c");
+    const auto *eqC3 = new IR::Equ(IR::Type_Boolean::get(), varC, IR::getConstant(type, 3));
+    const auto *eqC4 = new IR::Equ(IR::Type_Boolean::get(), varC, IR::getConstant(type, 4));
+    std::vector<const P4Tools::Constraint *> asserts{eqC3};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(solverAccessor.getConstraintVariablesSize(), 1U);
+
+    // Solving a different path pops eqC3.
+    asserts = {eqC4};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(solverAccessor.getConstraintVariablesSize(), 1U);
+    EXPECT_EQ(solver.getSymbolicMapping().at(varC)->checkedTo<IR::Constant>()->value, 4);
+
+    // Only the unsolved cluster of opLss is sent to Z3, which pops eqC4.
+    asserts = {opLss, eqC4};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(solverAccessor.getConstraintVariablesSize(), 1U);
+    EXPECT_EQ(solver.getSymbolicMapping().at(varC)->checkedTo<IR::Constant>()->value, 4);
+
+    solver.reset();
+    EXPECT_EQ(solverAccessor.getConstraintVariablesSize(), 0U);
+}
+
+/// Queries that the default configuration answers quickly do not start the portfolio. Without
+/// MULTITHREAD, enabling the portfolio only emits a warning.
+TEST_F(Z3SolverTest, SolverPortfolio) {
+    ASSERT_TRUE(opLss);
+
+    Z3Solver solver;
+    Z3SolverAccessor solverAccessor(solver);
+    auto diagnostics = ::diagnosticCount();
+    solver.setPortfolio(true);
+#ifdef MULTITHREAD
+    EXPECT_TRUE(solverAccessor.isPortfolioEnabled());
+    EXPECT_EQ(::diagnosticCount(), diagnostics);
+#else
+    EXPECT_FALSE(solverAccessor.isPortfolioEnabled());
+    EXPECT_EQ(::diagnosticCount(), diagnostics + 1);
+#endif  // MULTITHREAD
+
+    std::vector<const P4Tools::Constraint *> asserts{opLss};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    Model model(solver.getSymbolicMapping());
+    EXPECT_TRUE(model.evaluate(opLss, true)->checkedTo<IR::BoolLiteral>()->value);
+    asserts.push_back(new IR::LNot(IR::Type_Boolean::get(), opLss));
+    ASSERT_EQ(solver.checkSat(asserts), false);
+
+    // A timeout within the delay of the portfolio is left to the default configuration.
+    solver.timeout(100);
+    asserts.pop_back();
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(solver.getPortfolioStats().races, 0U);
+    EXPECT_EQ(solver.getPortfolioStats().alternativeWins, 0U);
+    EXPECT_EQ(solver.getPortfolioStats().unknowns, 0U);
+
+    solver.setPortfolio(false);
+    EXPECT_FALSE(solverAccessor.isPortfolioEnabled());
+}
+
 }  // anonymous namespace
 
 }  // namespace Test
@@ -1,5 +1,6 @@
 #include "backends/p4tools/modules/testgen/testgen.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -16,6 +17,7 @@
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/distance_stmt_cov.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_stmt_cov.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/max_stmt_cov.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
@@ -45,6 +47,9 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
     if (pathSelectionPolicy == PathSelectionPolicy::RandomBacktrack) {
         return new RandomBacktrack(solver, *programInfo);
     }
+    if (pathSelectionPolicy == PathSelectionPolicy::DistanceStmtCoverage) {
+        return new DistanceStmtSelection(solver, *programInfo);
+    }
     if (pathSelectionPolicy == PathSelectionPolicy::RandomMaxStmtCoverage) {
         return new RandomMaxStmtCoverage(solver, *programInfo, testgenOptions.saddlePoint);
     }
@@ -77,6 +82,7 @@ int generateAbstractTests(const TestgenOptions &testgenOptions, const ProgramInf
     };
 
     symbex.run(callBack);
+    testBackend->flushTests();
 
     // Emit a performance report, if desired.
     testBackend->printPerformanceReport(true);
@@ -117,9 +123,36 @@ int Testgen::mainImpl(const IR::P4Program *program) {
 
     // Need to declare the solver here to ensure its lifetime.
     Z3Solver solver;
+    solver.setConstraintSlicing(testgenOptions.constraintSlicing);
+    solver.setPortfolio(testgenOptions.solverPortfolio);
     auto *symbex = pickExecutionEngine(testgenOptions, programInfo, solver);
 
-    return generateAbstractTests(testgenOptions, programInfo, *symbex);
+    auto result = generateAbstractTests(testgenOptions, programInfo, *symbex);
+    const auto &cacheStats = solver.getTranslationCacheStats();
+    printFeature("performance", 4,
+                 "Z3 translation cache: %1% hits, %2% misses, %3% ms of translation saved",
+                 cacheStats.hits, cacheStats.misses,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(cacheStats.saved).count());
+    const auto &branchStats = symbex->getBranchCheckStats();
+    printFeature("performance", 4,
+                 "Branch checks: %1% satisfied by the parent model, %2% solver queries, %3% "
+                 "timeouts, %4% deferred branches recovered",
+                 branchStats.modelHits, branchStats.solverQueries, branchStats.solverTimeouts,
+                 branchStats.recoveredBranches);
+    if (testgenOptions.solverPortfolio) {
+        const auto &portfolioStats = solver.getPortfolioStats();
+        printFeature("performance", 4,
+                     "Solver portfolio: %1% races, %2% won by alternative configurations, %3% "
+                     "unanswered",
+                     portfolioStats.races, portfolioStats.alternativeWins,
+                     portfolioStats.unknowns);
+    }
+    if (const auto *stateMerger = symbex->getStateMerger()) {
+        const auto &mergeStats = stateMerger->getStats();
+        printFeature("performance", 4, "State merging: %1% states parked, %2% states merged",
+                     mergeStats.parked, mergeStats.merged);
+    }
+    return result;
 }
 
 }  // namespace P4Tools::P4Testgen
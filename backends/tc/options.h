@@ -64,6 +64,7 @@ class TCOptions : public CompilerOptions {
                 return true;
             },
             "Write introspection json to the given file");
+        for (auto option : {"-o", "-c", "-i"}) registerOutputOption(option);
         registerOption(
             "--trace", nullptr,
             [this](const char *) {
@@ -17,6 +17,7 @@ and limitations under the License.
 #include "backend.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileStats.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "ir/ir.h"
@@ -25,6 +26,7 @@ and limitations under the License.
 #include "lib/gc.h"
 #include "lib/log.h"
 #include "lib/nullstream.h"
+#include "lib/timer.h"
 #include "midend.h"
 #include "options.h"
 #include "version.h"
@@ -43,12 +45,9 @@ int main(int argc, char *const argv[]) {
         return 1;
     }
     auto hook = options.getDebugHook();
-    auto chkprogram = P4::parseP4File(options);
-    if (chkprogram == nullptr || ::errorCount() > 0) {
-        return 1;
-    }
-
-    const IR::P4Program *program = chkprogram;
+    const IR::P4Program *program = nullptr;
+    P4::CompileStatsWriter statsWriter(options, program);
+    Util::withTimer("parse", [&] { program = P4::parseP4File(options); });
     if (program == nullptr || ::errorCount() > 0) {
         return 1;
     }
@@ -56,7 +55,7 @@ int main(int argc, char *const argv[]) {
         P4::P4COptionPragmaParser optionsPragmaParser;
         program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
         P4::FrontEnd frontend(hook);
-        program = frontend.run(options, program);
+        Util::withTimer("frontend", [&] { program = frontend.run(options, program); });
     } catch (const Util::P4CExceptionBase &bug) {
         std::cerr << bug.what() << std::endl;
         return 1;
@@ -71,7 +70,7 @@ int main(int argc, char *const argv[]) {
     TC::MidEnd midEnd;
     midEnd.addDebugHook(hook);
     try {
-        toplevel = midEnd.run(options, program);
+        Util::withTimer("midend", [&] { toplevel = midEnd.run(options, program); });
         if (::errorCount() > 1 || toplevel == nullptr) {
             return 1;
         }
@@ -89,7 +88,9 @@ int main(int argc, char *const argv[]) {
         return 1;
     }
     TC::Backend backend(toplevel, &midEnd.refMap, &midEnd.typeMap, options);
-    if (!backend.process()) return 1;
+    bool processed = false;
+    Util::withTimer("backend", [&] { processed = backend.process(); });
+    if (!processed) return 1;
 
     if (!options.introspecFile.isNullOrEmpty()) {
         std::ostream *outIntro = openFile(options.introspecFile, false);
@@ -18,6 +18,7 @@ limitations under the License.
 #include <google/protobuf/text_format.h>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/json_util.h>
 
 #include <algorithm>
@@ -111,6 +112,13 @@ static bool writeTo(const Message &message, std::ostream *destination) {
     return true;
 }
 
+/// Serialize the protobuf @message to @destination in the binary protocol
+/// buffers format, preceded by its size as a varint.
+static bool writeDelimitedTo(const Message &message, std::ostream *destination) {
+    CHECK_NULL(destination);
+    return google::protobuf::util::SerializeDelimitedToOstream(message, destination);
+}
+
 /// Serialize the protobuf @message to @destination in the JSON protocol buffers
 /// format. This is intended for debugging and testing.
 static bool writeJsonTo(const Message &message, std::ostream *destination) {
@@ -506,13 +514,15 @@ class P4RuntimeAnalyzer {
      * handles architecture-specific constructs (e.g. externs).
      * @param arch  The name of the P4_16 architecture the program was written
      * against.
+     * @param entriesBatchSize, entriesSink  See P4RuntimeSerializer::generateP4Runtime.
      * @return a P4Info message representing the program's control plane API.
      *         Never returns null.
      */
     static P4RuntimeAPI analyze(const IR::P4Program *program,
                                 const IR::ToplevelBlock *evaluatedProgram, ReferenceMap *refMap,
                                 TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler,
-                                cstring arch);
+                                cstring arch, size_t entriesBatchSize,
+                                const P4RuntimeEntriesSink &entriesSink);
 
     void addAction(const IR::P4Action *actionDeclaration) {
         if (isHidden(actionDeclaration)) return;
@@ -977,15 +987,27 @@ class P4RuntimeEntriesConverter {
  private:
     friend class P4RuntimeAnalyzer;
 
-    explicit P4RuntimeEntriesConverter(const P4RuntimeSymbolTable &symbols)
-        : entries(new p4v1::WriteRequest), symbols(symbols) {}
+    P4RuntimeEntriesConverter(const P4RuntimeSymbolTable &symbols, size_t batchSize,
+                              const P4RuntimeEntriesSink &sink)
+        : entries(new p4v1::WriteRequest), symbols(symbols), batchSize(batchSize), sink(sink) {
+        BUG_CHECK(!sink || batchSize > 0, "Invalid batch size for P4Runtime static table entries");
+    }
 
     /// @return the P4Runtime WriteRequest message generated by this analyzer.
+    /// When the entries are passed to a sink, this holds the entries that
+    /// were not passed on yet.
     const p4v1::WriteRequest *getEntries() const {
         BUG_CHECK(entries != nullptr, "Didn't produce a P4Runtime WriteRequest object?");
         return entries;
     }
 
+    /// Passes the entries converted so far to the sink, if any.
+    void flush() {
+        if (!sink || entries->updates_size() == 0) return;
+        sink(*entries);
+        entries->Clear();
+    }
+
     /// Appends the 'const entries' for the table to the WriteRequest message.
     void addTableEntries(const IR::TableBlock *tableBlock, ReferenceMap *refMap, TypeMap *typeMap,
                          P4RuntimeArchHandlerIface *archHandler) {
@@ -1038,6 +1060,7 @@ class P4RuntimeEntriesConverter {
                           "nor of the P4Runtime specification, and will be ignored",
                           e);
             }
+            if (sink && static_cast<size_t>(entries->updates_size()) >= batchSize) flush();
         }
     }
 
@@ -1328,13 +1351,18 @@ class P4RuntimeEntriesConverter {
     p4v1::WriteRequest *entries;
     /// The symbols used in the API and their ids.
     const P4RuntimeSymbolTable &symbols;
+    /// If set, 'entries' is passed to 'sink' and cleared whenever it holds
+    /// 'batchSize' updates.
+    size_t batchSize;
+    const P4RuntimeEntriesSink &sink;
 };
 
 /* static */ P4RuntimeAPI P4RuntimeAnalyzer::analyze(const IR::P4Program *program,
                                                      const IR::ToplevelBlock *evaluatedProgram,
                                                      ReferenceMap *refMap, TypeMap *typeMap,
                                                      P4RuntimeArchHandlerIface *archHandler,
-                                                     cstring arch) {
+                                                     cstring arch, size_t entriesBatchSize,
+                                                     const P4RuntimeEntriesSink &entriesSink) {
     using namespace ControlPlaneAPI;
 
     CHECK_NULL(archHandler);
@@ -1379,12 +1407,13 @@ class P4RuntimeEntriesConverter {
 
     analyzer.addPkgInfo(evaluatedProgram, arch);
 
-    P4RuntimeEntriesConverter entriesConverter(*symbols);
+    P4RuntimeEntriesConverter entriesConverter(*symbols, entriesBatchSize, entriesSink);
     Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block *block) {
         if (block->is<IR::TableBlock>())
             entriesConverter.addTableEntries(block->to<IR::TableBlock>(), refMap, typeMap,
                                              archHandler);
     });
+    entriesConverter.flush();
 
     auto *p4Info = analyzer.getP4Info();
     auto *p4Entries = entriesConverter.getEntries();
@@ -1393,7 +1422,9 @@ class P4RuntimeEntriesConverter {
 
 }  // namespace ControlPlaneAPI
 
-P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program, cstring arch) {
+P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program, cstring arch,
+                                                    size_t entriesBatchSize,
+                                                    const P4RuntimeEntriesSink &entriesSink) {
     using namespace ControlPlaneAPI;
 
     auto archHandlerBuilderIt = archHandlerBuilders.find(arch);
@@ -1426,7 +1457,7 @@ P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program
     auto archHandler = (*archHandlerBuilderIt->second)(&refMap, &typeMap, evaluatedProgram);
 
     return P4RuntimeAnalyzer::analyze(p4RuntimeProgram, evaluatedProgram, &refMap, &typeMap,
-                                      archHandler, arch);
+                                      archHandler, arch, entriesBatchSize, entriesSink);
 }
 
 void P4RuntimeAPI::serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat format) const {
@@ -1469,6 +1500,28 @@ void P4RuntimeAPI::serializeEntriesTo(std::ostream *destination, P4RuntimeFormat
                 "Failed to serialize the P4Runtime static table entries to the output");
 }
 
+void P4RuntimeAPI::serializeEntryBatchesTo(std::ostream *destination, size_t batchSize) const {
+    using namespace ControlPlaneAPI;
+    BUG_CHECK(batchSize > 0, "Invalid batch size for P4Runtime static table entries");
+
+    // P4RuntimeEntriesConverter only fills in the updates, so the batches do not need to
+    // carry any other field of the WriteRequest.
+    bool success = true;
+    auto count = static_cast<size_t>(entries->updates_size());
+    for (size_t start = 0; success && start < count; start += batchSize) {
+        p4v1::WriteRequest batch;
+        size_t end = std::min(count, start + batchSize);
+        batch.mutable_updates()->Reserve(static_cast<int>(end - start));
+        for (size_t i = start; i < end; i++)
+            *batch.add_updates() = entries->updates(static_cast<int>(i));
+        success = writers::writeDelimitedTo(batch, destination);
+    }
+    if (success) destination->flush();
+    if (!success || !destination->good())
+        ::error(ErrorType::ERR_IO,
+                "Failed to serialize the P4Runtime static table entries to the output");
+}
+
 static bool parseFileNames(cstring fileNameVector, std::vector<cstring> &files,
                            std::vector<P4::P4RuntimeFormat> &formats) {
     for (auto current = fileNameVector; current;) {
@@ -1504,6 +1557,82 @@ static bool parseFileNames(cstring fileNameVector, std::vector<cstring> &files,
     return true;
 }
 
+/// Collects the P4Info files requested by @options and their formats.
+static bool p4InfoFiles(const CompilerOptions &options, std::vector<cstring> &files,
+                        std::vector<P4::P4RuntimeFormat> &formats) {
+    if (!options.p4RuntimeFile.isNullOrEmpty()) {
+        files.push_back(options.p4RuntimeFile);
+        formats.push_back(options.p4RuntimeFormat);
+    }
+    return parseFileNames(options.p4RuntimeFiles, files, formats);
+}
+
+/// Collects the static entries files requested by @options and their formats.
+static bool entriesFiles(const CompilerOptions &options, std::vector<cstring> &files,
+                         std::vector<P4::P4RuntimeFormat> &formats) {
+    if (!options.p4RuntimeEntriesFile.isNullOrEmpty()) {
+        files.push_back(options.p4RuntimeEntriesFile);
+        formats.push_back(options.p4RuntimeFormat);
+    }
+    return parseFileNames(options.p4RuntimeEntriesFiles, files, formats);
+}
+
+/// Writes the P4Info files requested by @options; @returns false if the file
+/// names are invalid.
+static bool serializeP4InfoIfRequired(const P4RuntimeAPI &p4Runtime,
+                                      const CompilerOptions &options) {
+    std::vector<cstring> files;
+    std::vector<P4::P4RuntimeFormat> formats;
+    if (!p4InfoFiles(options, files, formats)) return false;
+    for (unsigned i = 0; i < files.size(); i++) {
+        cstring file = files.at(i);
+        P4::P4RuntimeFormat format = formats.at(i);
+        std::ostream *out = openFile(file, false);
+        if (!out) {
+            ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime API file: %1%", file);
+            continue;
+        }
+        p4Runtime.serializeP4InfoTo(out, format);
+    }
+    return true;
+}
+
+/// Generates the P4Runtime API of @program and writes the static entries to the
+/// binary entries @files as they are converted, in batches of
+/// --p4runtime-entries-batch-size updates, so that the entries of the whole
+/// program are never held in memory at once.
+static P4RuntimeAPI generateStreamingEntries(P4RuntimeSerializer *serializer,
+                                             const IR::P4Program *program, cstring arch,
+                                             const CompilerOptions &options,
+                                             const std::vector<cstring> &files) {
+    using namespace ControlPlaneAPI;
+
+    std::vector<std::pair<cstring, std::ostream *>> outputs;
+    for (auto file : files) {
+        if (auto *out = openFile(file, false))
+            outputs.emplace_back(file, out);
+        else
+            ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime static entries file: %1%", file);
+    }
+    std::set<cstring> failed;
+    auto sink = [&](const p4v1::WriteRequest &batch) {
+        for (auto &output : outputs) {
+            if (!failed.count(output.first) && !writers::writeDelimitedTo(batch, output.second))
+                failed.insert(output.first);
+        }
+    };
+    auto p4Runtime =
+        serializer->generateP4Runtime(program, arch, options.p4RuntimeEntriesBatchSize, sink);
+    for (auto &output : outputs) {
+        output.second->flush();
+        if (failed.count(output.first) || !output.second->good())
+            ::error(ErrorType::ERR_IO,
+                    "%1%: Failed to serialize the P4Runtime static table entries to the output",
+                    output.first);
+    }
+    return p4Runtime;
+}
+
 void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const IR::P4Program *program,
                                                        const CompilerOptions &options) {
     std::vector<cstring> files;
@@ -1518,53 +1647,48 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const IR::P4Program *prog
     auto arch = P4RuntimeSerializer::resolveArch(options);
     if (Log::verbose())
         std::cout << "Generating P4Runtime output for architecture " << arch << std::endl;
-    auto p4Runtime = get()->generateP4Runtime(program, arch);
+
+    // Static entries can only be streamed when all the entries files are binary;
+    // the other formats need a single WriteRequest.
+    if (options.p4RuntimeEntriesBatchSize != 0) {
+        if (!entriesFiles(options, files, formats)) return;
+        bool allBinary = std::all_of(formats.begin(), formats.end(), [](P4RuntimeFormat format) {
+            return format == P4RuntimeFormat::BINARY;
+        });
+        if (!files.empty() && allBinary) {
+            auto p4Runtime = generateStreamingEntries(this, program, arch, options, files);
+            serializeP4InfoIfRequired(p4Runtime, options);
+            return;
+        }
+    }
+    auto p4Runtime = generateP4Runtime(program, arch);
     serializeP4RuntimeIfRequired(p4Runtime, options);
 }
 
 void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Runtime,
                                                        const CompilerOptions &options) {
+    if (!serializeP4InfoIfRequired(p4Runtime, options)) return;
+
     std::vector<cstring> files;
     std::vector<P4::P4RuntimeFormat> formats;
-
-    if (!options.p4RuntimeFile.isNullOrEmpty()) {
-        files.push_back(options.p4RuntimeFile);
-        formats.push_back(options.p4RuntimeFormat);
-    }
-    if (!parseFileNames(options.p4RuntimeFiles, files, formats)) return;
-
-    if (!files.empty()) {
-        for (unsigned i = 0; i < files.size(); i++) {
-            cstring file = files.at(i);
-            P4::P4RuntimeFormat format = formats.at(i);
-            std::ostream *out = openFile(file, false);
-            if (!out) {
-                ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime API file: %1%", file);
-                continue;
-            }
-            p4Runtime.serializeP4InfoTo(out, format);
+    if (!entriesFiles(options, files, formats)) return;
+    for (unsigned i = 0; i < files.size(); i++) {
+        cstring file = files.at(i);
+        P4::P4RuntimeFormat format = formats.at(i);
+        std::ostream *out = openFile(file, false);
+        if (!out) {
+            ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime static entries file: %1%", file);
+            continue;
         }
-    }
-
-    // Do the same for the entries files
-    files.clear();
-    formats.clear();
-    if (!options.p4RuntimeEntriesFile.isNullOrEmpty()) {
-        files.push_back(options.p4RuntimeEntriesFile);
-        formats.push_back(options.p4RuntimeFormat);
-    }
-
-    if (!parseFileNames(options.p4RuntimeEntriesFiles, files, formats)) return;
-    if (!files.empty()) {
-        for (unsigned i = 0; i < files.size(); i++) {
-            cstring file = files.at(i);
-            P4::P4RuntimeFormat format = formats.at(i);
-            std::ostream *out = openFile(file, false);
-            if (!out) {
-                ::error(ErrorType::ERR_IO, "Couldn't open P4Runtime static entries file: %1%",
-                        options.p4RuntimeEntriesFile);
-                continue;
-            }
+        if (options.p4RuntimeEntriesBatchSize == 0) {
+            p4Runtime.serializeEntriesTo(out, format);
+        } else if (format == P4::P4RuntimeFormat::BINARY) {
+            p4Runtime.serializeEntryBatchesTo(out, options.p4RuntimeEntriesBatchSize);
+        } else {
+            ::warning(ErrorType::WARN_UNSUPPORTED,
+                      "%1%: '--p4runtime-entries-batch-size' only applies to the binary "
+                      "format; writing a single WriteRequest",
+                      file);
             p4Runtime.serializeEntriesTo(out, format);
         }
     }
@@ -1597,8 +1721,10 @@ void P4RuntimeSerializer::registerArch(
     archHandlerBuilders[archName] = builder;
 }
 
-P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch) {
-    return P4RuntimeSerializer::get()->generateP4Runtime(program, arch);
+P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch,
+                               size_t entriesBatchSize, const P4RuntimeEntriesSink &entriesSink) {
+    return P4RuntimeSerializer::get()->generateP4Runtime(program, arch, entriesBatchSize,
+                                                         entriesSink);
 }
 
 void serializeP4RuntimeIfRequired(const IR::P4Program *program, const CompilerOptions &options) {
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef CONTROL_PLANE_P4RUNTIMESERIALIZER_H_
 #define CONTROL_PLANE_P4RUNTIMESERIALIZER_H_
 
+#include <functional>
 #include <iosfwd>
 #include <unordered_map>
 
@@ -44,6 +45,10 @@ namespace P4 {
 /// P4Runtime serialization formats.
 enum class P4RuntimeFormat { BINARY, JSON, TEXT };
 
+/// Receives the static table entries of a program in batches while they are
+/// converted; see P4RuntimeSerializer::generateP4Runtime.
+using P4RuntimeEntriesSink = std::function<void(const ::p4::v1::WriteRequest &batch)>;
+
 /// A P4 program's control-plane API, represented in terms of P4Runtime's data
 /// structures. Can be inspected or serialized.
 struct P4RuntimeAPI {
@@ -53,6 +58,12 @@ struct P4RuntimeAPI {
     /// Serialize the WriteRequest message containing all the table entries to
     /// the @destination stream in the requested protobuf serialization @format.
     void serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format) const;
+    /// Serialize the table entries to the @destination stream as a sequence of
+    /// length-delimited binary WriteRequest messages, each holding at most
+    /// @batchSize updates, so that readers can process them incrementally.
+    /// The entries are already in memory here; to bound the memory used by
+    /// the entries, pass a sink to generateP4Runtime instead.
+    void serializeEntryBatchesTo(std::ostream *destination, size_t batchSize) const;
 
     /// A P4Runtime P4Info message, which encodes the control-plane API of the
     /// program. Never null.
@@ -84,9 +95,15 @@ class P4RuntimeSerializer {
      *
      * @param program  The program to construct the control-plane API from. All
      *                 frontend passes must have already run.
+     * @param entriesBatchSize, entriesSink  If @entriesSink is set, the static
+     *                 table entries are passed to it while they are converted,
+     *                 as WriteRequest messages of at most @entriesBatchSize
+     *                 updates, and the 'entries' of the result are empty.
      * @return the generated P4Runtime API.
      */
-    P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch);
+    P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch,
+                                   size_t entriesBatchSize = 0,
+                                   const P4RuntimeEntriesSink &entriesSink = {});
 
     /**
      * A convenience wrapper for P4::generateP4Runtime() which generates the
@@ -123,7 +140,9 @@ class P4RuntimeSerializer {
 
 /// Calls @ref P4RuntimeSerializer::generateP4Runtime on the @ref
 /// P4RuntimeSerializer singleton.
-P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch = "v1model");
+P4RuntimeAPI generateP4Runtime(const IR::P4Program *program, cstring arch = "v1model",
+                               size_t entriesBatchSize = 0,
+                               const P4RuntimeEntriesSink &entriesSink = {});
 
 /// Calls @ref P4RuntimeSerializer::serializeP4RuntimeIfRequired on the @ref
 /// P4RuntimeSerializer singleton.
@@ -0,0 +1,113 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/compileStats.h"
+
+#include <sys/resource.h>
+
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/compile_server.h"
+#include "lib/error.h"
+#include "lib/gc.h"
+#include "lib/nullstream.h"
+#include "lib/timer.h"
+
+namespace P4 {
+
+namespace {
+
+/// Counts the nodes of a program per IR class; shared nodes are counted once.
+class CountNodes : public Inspector {
+ public:
+    std::map<cstring, size_t> counts;
+    size_t total = 0;
+
+    bool preorder(const IR::Node *node) override {
+        counts[node->node_type_name()]++;
+        total++;
+        return true;
+    }
+};
+
+}  // namespace
+
+Util::JsonObject *compileStats(const ParserOptions &options, const IR::Node *program) {
+    auto *stats = new Util::JsonObject();
+    stats->emplace("compilerVersion",
+                   options.compilerVersion.isNullOrEmpty() ? "" : options.compilerVersion);
+    stats->emplace("program", options.file.isNullOrEmpty() ? "" : options.file);
+    stats->emplace("errors", ::errorCount());
+
+    auto *timers = new Util::JsonObject();
+    for (const auto &timer : Util::getTimers()) {
+        // Nested timers are named "outer.inner", with a tab per nesting level.
+        auto name = timer.timerName;
+        name.erase(0, name.find_first_not_of('\t'));
+        timers->emplace(name.empty() ? "total" : name, timer.milliseconds);
+    }
+    stats->emplace("timersMs", timers);
+
+    auto *counters = new Util::JsonObject();
+    for (const auto &counter : Util::getCounters())
+        counters->emplace(counter.first, counter.second);
+    stats->emplace("counters", counters);
+
+    auto *memory = new Util::JsonObject();
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // The peak is that of the process. A compile server compiles many programs in one
+        // process, so there the peak is not that of this compilation.
+        auto peakRss = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+        memory->emplace(CompileServer::isRunning() ? "serverPeakRssBytes" : "peakRssBytes",
+                        peakRss);
+    }
+    size_t gcHeapSize = 0;
+    size_t gcInUse = gc_mem_inuse(&gcHeapSize);  // triggers gc
+    memory->emplace("gcHeapBytes", gcHeapSize);
+    memory->emplace("gcInUseBytes", gcInUse);
+    stats->emplace("memory", memory);
+
+    if (program != nullptr) {
+        CountNodes count;
+        program->apply(count);
+        auto *nodes = new Util::JsonObject();
+        nodes->emplace("total", count.total);
+        auto *byClass = new Util::JsonObject();
+        for (const auto &c : count.counts) byClass->emplace(c.first, c.second);
+        nodes->emplace("byClass", byClass);
+        stats->emplace("irNodes", nodes);
+    }
+    return stats;
+}
+
+void writeCompileStats(const ParserOptions &options, const IR::Node *program) {
+    if (options.statsJsonFile.isNullOrEmpty()) return;
+    auto *out = openFile(options.statsJsonFile, false);
+    if (out == nullptr) return;
+    compileStats(options, program)->serialize(*out);
+    *out << std::endl;
+    out->flush();
+    if (!*out)
+        ::warning(ErrorType::WARN_FAILED, "%1%: could not write compile statistics",
+                  options.statsJsonFile);
+}
+
+CompileStatsWriter::~CompileStatsWriter() { writeCompileStats(options, program); }
+
+}  // namespace P4
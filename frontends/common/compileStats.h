@@ -0,0 +1,63 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_COMPILESTATS_H_
+#define FRONTENDS_COMMON_COMPILESTATS_H_
+
+#include "frontends/common/parser_options.h"
+#include "lib/json.h"
+
+namespace IR {
+class Node;
+class P4Program;
+}  // namespace IR
+
+namespace P4 {
+
+/**
+ * Collects the statistics of a compilation: the timers and counters of
+ * lib/timer.h (compilation phases, passes run, type inference runs), the
+ * number of errors reported, the peak resident set size and garbage
+ * collected heap size of the compiler, and the number of IR nodes of
+ * @program per IR class.  @program may be null, e.g. when the compilation
+ * failed before a program was parsed; the IR node counts are then omitted.
+ *
+ * The peak resident set size is that of the process.  In a compile server,
+ * which compiles many programs in one process, it is reported as
+ * serverPeakRssBytes instead of peakRssBytes: it is the peak of all the
+ * compilations of the server so far, not of this one.
+ */
+Util::JsonObject *compileStats(const ParserOptions &options, const IR::Node *program);
+
+/// Writes the compileStats() as JSON to the file of --stats-json, if any.
+void writeCompileStats(const ParserOptions &options, const IR::Node *program);
+
+/// Calls writeCompileStats() with the current value of @program when it goes
+/// out of scope, so that a driver also writes the statistics when it returns
+/// early because the compilation failed.
+class CompileStatsWriter {
+    const ParserOptions &options;
+    const IR::P4Program *const &program;
+
+ public:
+    CompileStatsWriter(const ParserOptions &options, const IR::P4Program *const &program)
+        : options(options), program(program) {}
+    CompileStatsWriter(const CompileStatsWriter &) = delete;
+    CompileStatsWriter &operator=(const CompileStatsWriter &) = delete;
+    ~CompileStatsWriter();
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_COMPILESTATS_H_ */
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "options.h"
 
+#include <charconv>
+#include <cstring>
+
 #include "frontends/p4/frontend.h"
 
 CompilerOptions::CompilerOptions() : ParserOptions() {
@@ -113,6 +116,20 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
         "Write static table entries as a P4Runtime WriteRequest message\n"
         "to the specified files (comma-separated list); the file format is\n"
         "inferred from the suffix. Legal suffixes are .json, .txt and .bin");
+    registerOption(
+        "--p4runtime-entries-batch-size", "count",
+        [this](const char *arg) {
+            const char *end = arg + strlen(arg);
+            auto [ptr, ec] = std::from_chars(arg, end, p4RuntimeEntriesBatchSize);
+            if (ec != std::errc() || ptr != end || p4RuntimeEntriesBatchSize == 0) {
+                ::error(ErrorType::ERR_INVALID, "Illegal batch size %1%", arg);
+                return false;
+            }
+            return true;
+        },
+        "Write static table entries in binary format as a stream of\n"
+        "length-delimited WriteRequest messages, each holding at most\n"
+        "the specified number of updates.");
     registerOption(
         "--p4runtime-format", "{binary,json,text}",
         [this](const char *arg) {
@@ -152,6 +169,10 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
             return true;
         },
         "Unrolling all parser's loops");
+    for (auto option : {"--toJSON", "--p4runtime-file", "--p4runtime-entries-file",
+                        "--p4runtime-files", "--p4runtime-entries-files",
+                        "--p4runtime-entries-batch-size", "--p4runtime-format"})
+        registerOutputOption(option);
 }
 
 bool CompilerOptions::enable_intrinsic_metadata_fix() { return true; }
@@ -67,6 +67,9 @@ class CompilerOptions : public ParserOptions {
     // Write static table entries as a P4Runtime WriteRequest message to the
     // specified files.
     cstring p4RuntimeEntriesFiles = nullptr;
+    // When non-zero, write static table entries in binary format as a stream of
+    // length-delimited WriteRequest messages holding at most this many updates.
+    unsigned p4RuntimeEntriesBatchSize = 0;
     // Choose format for P4Runtime API description.
     P4::P4RuntimeFormat p4RuntimeFormat = P4::P4RuntimeFormat::BINARY;
     // Pretty-print the program in the specified file.
@@ -18,9 +18,11 @@ limitations under the License.
 #define FRONTENDS_COMMON_PARSEINPUT_H_
 
 #include "frontends/common/options.h"
+#include "frontends/common/preludeCache.h"
 #include "frontends/p4/fromv1.0/converters.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/parsers/parserDriver.h"
+#include "lib/compile_server.h"
 #include "lib/error.h"
 #include "lib/source_file.h"
 
@@ -77,9 +79,13 @@ const IR::P4Program *parseP4File(ParserOptions &options) {
         if (::errorCount() > 0 || in == nullptr) return nullptr;
     }
 
-    auto result = options.isv1()
-                      ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
-                      : P4ParserDriver::parse(in, options.file);
+    const IR::P4Program *result = nullptr;
+    if (options.isv1())
+        result = parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook());
+    else if ((options.preludeCacheDir || CompileServer::isRunning()) && !options.doNotPreprocess)
+        result = parseWithPreludeCache(in, options);
+    else
+        result = P4ParserDriver::parse(in, options.file);
     options.closeInput(in);
 
     if (::errorCount() > 0) {
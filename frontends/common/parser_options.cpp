@@ -291,6 +291,34 @@ ParserOptions::ParserOptions() : Util::Options(defaultMessage) {
             return true;
         },
         "[Compiler debugging] If true do not generate #include statements\n");
+    registerOption(
+        "--prelude-cache", "dir",
+        [this](const char *arg) {
+            preludeCacheDir = arg;
+            return true;
+        },
+        "Cache the parsed declarations of the standard include files (core.p4 and the\n"
+        "architecture file) in the given directory, and reuse them when a later\n"
+        "compilation includes the same files with the same definitions.");
+    registerOption(
+        "--pass-cache", "dir",
+        [this](const char *arg) {
+            passCacheDir = arg;
+            return true;
+        },
+        "Cache the IR produced by the front-end and mid-end in the given directory, and\n"
+        "reuse it when a later compilation of the same program has the same options.");
+    registerOption(
+        "--stats-json", "file",
+        [this](const char *arg) {
+            statsJsonFile = arg;
+            return true;
+        },
+        "Write statistics of the compilation to the given file as JSON: the time of each\n"
+        "compilation phase, the number of passes and type inference runs, the peak memory\n"
+        "use and the number of IR nodes of each class in the compiled program.");
+    for (auto option : {"--dump", "--prelude-cache", "--pass-cache", "--stats-json"})
+        registerOutputOption(option);
     registerUsage(
         "loglevel format is: \"sourceFile:level,...,sourceFile:level\"\n"
         "where 'sourceFile' is a compiler source file and "
@@ -358,6 +386,30 @@ std::vector<const char *> *ParserOptions::process(int argc, char *const argv[])
                          {"p4_14include", "../p4_14include", "../../p4_14include"},
                          exename(argv[0]));
 
+    commandLine.clear();
+    for (int i = 0; i < argc; i++) {
+        cstring arg = argv[i];
+        if (i > 0 && arg.startsWith("-")) {
+            // Find the option name, and whether its argument is in the same word.
+            cstring name = arg;
+            bool attached = false;
+            if (arg.startsWith("--")) {
+                if (auto eq = arg.find('=')) {
+                    name = arg.before(eq);
+                    attached = true;
+                }
+            } else if (!options.count(arg) && arg.size() > 2) {
+                name = arg.substr(0, 2);
+                attached = true;
+            }
+            if (outputOptions.count(name)) {
+                if (!attached) i++;
+                continue;
+            }
+        }
+        commandLine += argv[i];
+        commandLine += '\0';
+    }
     auto remainingOptions = Util::Options::process(argc, argv);
     validateOptions();
     return remainingOptions;
@@ -365,6 +417,12 @@ std::vector<const char *> *ParserOptions::process(int argc, char *const argv[])
 
 void ParserOptions::validateOptions() const {}
 
+std::string ParserOptions::passCacheContext() const {
+    std::string context = compilerVersion ? compilerVersion.c_str() : "";
+    context += '\0';
+    return context + commandLine;
+}
+
 const char *ParserOptions::getIncludePath() {
     cstring path = "";
     // the p4c driver sets environment variables for include
@@ -20,6 +20,7 @@ limitations under the License.
 #define FRONTENDS_COMMON_PARSER_OPTIONS_H_
 
 #include <set>
+#include <string>
 #include <unordered_map>
 
 #include "ir/configuration.h"
@@ -43,7 +44,13 @@ class ParserOptions : public Util::Options {
     // annotation names that are to be ignored by the compiler
     std::set<cstring> disabledAnnotations;
 
+    // options left out of passCacheContext()
+    std::set<cstring> outputOptions;
+
  protected:
+    // Marks @option, which takes an argument such as the name of an output file, as not
+    // changing the IR produced by the passes: it is left out of passCacheContext().
+    void registerOutputOption(const char *option) { outputOptions.emplace(option); }
     // Function that is returned by getDebugHook.
     void dumpPass(const char *manager, unsigned seq, const char *pass, const IR::Node *node) const;
     // Checks if parsed options make sense with respect to each-other.
@@ -95,6 +102,21 @@ class ParserOptions : public Util::Options {
     /// If true do not generate #include statements.
     /// Used for debugging.
     bool noIncludes = false;
+    // If set, directory where the parsed declarations of the standard include
+    // files are cached between compilations.
+    cstring preludeCacheDir = nullptr;
+    // If set, directory where the IR produced by the front-end and mid-end is cached
+    // between compilations.
+    cstring passCacheDir = nullptr;
+    // If set, file where statistics of the compilation are written as JSON.
+    cstring statsJsonFile = nullptr;
+    // The command line of the compiler, with NUL separated arguments, without the
+    // options that only name output files.
+    std::string commandLine;
+    // Returns what the IR produced by the passes depends on besides their input IR: the
+    // compiler version and the command line.  Compilations that only differ in their
+    // output files share their cached results.
+    std::string passCacheContext() const;
 };
 
 /// A compilation context which exposes compiler options and a compiler
@@ -0,0 +1,255 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "preludeCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "frontends/parsers/parserDriver.h"
+#include "ir/binary_ir.h"
+#include "lib/compile_server.h"
+#include "lib/error.h"
+#include "lib/input_buffer.h"
+#include "lib/log.h"
+#include "lib/path.h"
+#include "lib/source_file.h"
+
+namespace P4 {
+
+namespace {
+
+/// If @line is a preprocessor line marker (# <line> "<file>" ...), sets @file and @lineNo and
+/// returns true.
+bool parseLineMarker(std::string_view line, std::string_view &file, unsigned &lineNo) {
+    size_t i = 0;
+    auto skipSpaces = [&]() {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) i++;
+    };
+    if (line.empty() || line[0] != '#') return false;
+    i = 1;
+    skipSpaces();
+    if (line.substr(i, 4) == "line") i += 4;
+    skipSpaces();
+    size_t digits = i;
+    while (i < line.size() && isdigit(static_cast<unsigned char>(line[i]))) i++;
+    if (i == digits) return false;
+    std::from_chars(line.data() + digits, line.data() + i, lineNo);
+    skipSpaces();
+    if (i == line.size() || line[i] != '"') return false;
+    size_t end = line.find('"', i + 1);
+    if (end == std::string_view::npos) return false;
+    file = line.substr(i + 1, end - i - 1);
+    return true;
+}
+
+/// Returns true if @line only contains comments and whitespace.  @inComment tracks
+/// block comments spanning several lines.
+bool onlyComments(std::string_view line, bool &inComment) {
+    for (size_t i = 0; i < line.size(); i++) {
+        if (inComment) {
+            if (line.substr(i, 2) == "*/") {
+                inComment = false;
+                i++;
+            }
+        } else if (line.substr(i, 2) == "/*") {
+            inComment = true;
+            i++;
+        } else if (line.substr(i, 2) == "//") {
+            return true;
+        } else if (!isspace(static_cast<unsigned char>(line[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 64 bit FNV-1a hash.
+uint64_t hash(std::string_view data, uint64_t h = 14695981039346656037ULL) {
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t cacheKey(const std::string &prelude, const ParserOptions &options) {
+    uint64_t key = hash(prelude);
+    key = hash(options.compilerVersion ? options.compilerVersion.c_str() : "", key);
+    return hash(std::to_string(binaryIRVersion), key);
+}
+
+cstring cacheFileName(uint64_t key, const ParserOptions &options) {
+    char name[32];
+    snprintf(name, sizeof(name), "prelude-%016llx.p4ir", static_cast<unsigned long long>(key));
+    return Util::PathName(options.preludeCacheDir).join(name).toString();
+}
+
+/// Rebuilds the input sources that parsing the prelude @text builds: the lexer appends all the
+/// text and maps the line of each line marker to the file and line the marker names.
+const Util::InputSources *preludeSources(const std::string &text, cstring file) {
+    auto *sources = new Util::InputSources;
+    sources->reserve(text.size());
+    sources->mapLine(file, 1);
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        eol = eol == std::string::npos ? text.size() : eol + 1;
+        std::string line = text.substr(pos, eol - pos);
+        std::string_view markerFile;
+        unsigned markerLine = 0;
+        if (parseLineMarker(line, markerFile, markerLine))
+            sources->mapLine(cstring(std::string(markerFile)), markerLine);
+        sources->appendText(line.c_str());
+        pos = eol;
+    }
+    return sources;
+}
+
+/// Loads the prelude cached in @fileName, with the source positions of its declarations in
+/// the prelude @text, so that diagnostics on them are the same as without the cache.
+const IR::P4Program *loadPrelude(cstring fileName, const std::string &text,
+                                 const ParserOptions &options) {
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0) return nullptr;
+    std::vector<const Util::InputSources *> sources = {preludeSources(text, options.file)};
+    auto *node = loadBinaryIR(fileName, true, &sources);
+    if (node == nullptr) return nullptr;
+    auto *prelude = node->to<IR::P4Program>();
+    if (prelude == nullptr || !P4ParserDriver::isPrelude(prelude)) {
+        ::warning(ErrorType::WARN_INVALID, "%1%: ignoring invalid prelude cache entry", fileName);
+        return nullptr;
+    }
+    return prelude;
+}
+
+/// The most preludes kept in memory by a compile server.
+constexpr size_t MAX_PRELUDES_IN_MEMORY = 16;
+
+/// The preludes parsed or loaded by earlier compilations of a compile server, by cache key.
+std::unordered_map<uint64_t, const IR::P4Program *> &preludesInMemory() {
+    static std::unordered_map<uint64_t, const IR::P4Program *> preludes;
+    return preludes;
+}
+
+void storePrelude(cstring fileName, const IR::P4Program *prelude) {
+    // Write to a temporary file first, so concurrent compilations never see a partial entry.
+    auto tmpName = fileName + "." + std::to_string(getpid()) + ".tmp";
+    {
+        // The declarations of a prelude all come from the input sources of its parse.
+        auto sources = inputSourcesOf(prelude);
+        std::ofstream out(tmpName.c_str(), std::ios::binary);
+        if (out) writeBinaryIR(out, prelude, true, &sources);
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "%1%: could not write prelude cache entry", tmpName);
+            return;
+        }
+    }
+    if (rename(tmpName.c_str(), fileName.c_str()) != 0) {
+        ::warning(ErrorType::WARN_FAILED, "%1%: could not write prelude cache entry", fileName);
+        unlink(tmpName.c_str());
+    }
+}
+
+}  // namespace
+
+size_t splitPrelude(std::string_view text, cstring includePath, std::string &prelude) {
+    prelude.clear();
+    std::string includeDir = includePath + "/";
+    bool inInclude = false;
+    bool inComment = false;
+    size_t lastMarker = 0;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t eol = text.find('\n', pos);
+        eol = eol == std::string::npos ? text.size() : eol + 1;
+        std::string_view line(text.data() + pos, eol - pos);
+        std::string_view file;
+        unsigned lineNo = 0;
+        if (parseLineMarker(line, file, lineNo)) {
+            inInclude = file.substr(0, includeDir.size()) == includeDir;
+            lastMarker = pos;
+            if (inInclude) prelude.append(line);
+        } else if (inInclude) {
+            prelude.append(line);
+        } else if (!onlyComments(line, inComment)) {
+            // The rest of the program starts with the line marker of the current file.
+            return prelude.empty() ? 0 : lastMarker;
+        }
+        pos = eol;
+    }
+    // The program only consists of included files.
+    return 0;
+}
+
+const IR::P4Program *parseWithPreludeCache(FILE *in, const ParserOptions &options) {
+    Util::InputBuffer input(in);
+    auto text = input.contents();
+
+    std::string preludeText;
+    size_t restStart = splitPrelude(text, p4includePath, preludeText);
+    if (restStart == 0) {
+        Util::MemoryInputStream stream(text);
+        return P4ParserDriver::parse(stream, options.file);
+    }
+
+    // A compile server keeps the preludes in memory; the IR is never modified in place, so
+    // later compilations can share the declarations.
+    uint64_t key = cacheKey(preludeText, options);
+    auto &inMemory = preludesInMemory();
+    const IR::P4Program *prelude = nullptr;
+    if (CompileServer::isRunning()) {
+        auto it = inMemory.find(key);
+        if (it != inMemory.end()) {
+            prelude = it->second;
+            LOG2("Using prelude kept in memory");
+        }
+    }
+    if (prelude == nullptr && options.preludeCacheDir) {
+        auto fileName = cacheFileName(key, options);
+        prelude = loadPrelude(fileName, preludeText, options);
+        if (prelude != nullptr) LOG2("Using cached prelude " << fileName);
+    }
+    if (prelude == nullptr) {
+        Util::MemoryInputStream stream(preludeText);
+        prelude = P4ParserDriver::parse(stream, options.file);
+        if (prelude == nullptr) return nullptr;
+        if (!P4ParserDriver::isPrelude(prelude)) {
+            LOG2("Included files have declarations that cannot be cached");
+            Util::MemoryInputStream full(text);
+            return P4ParserDriver::parse(full, options.file);
+        }
+        if (options.preludeCacheDir) {
+            auto fileName = cacheFileName(key, options);
+            LOG2("Caching prelude in " << fileName);
+            storePrelude(fileName, prelude);
+        }
+    }
+    if (CompileServer::isRunning()) {
+        if (inMemory.size() >= MAX_PRELUDES_IN_MEMORY && !inMemory.count(key)) inMemory.clear();
+        inMemory.emplace(key, prelude);
+    }
+
+    Util::MemoryInputStream rest(text.substr(restStart));
+    return P4ParserDriver::parse(rest, options.file, 1, prelude);
+}
+
+}  // namespace P4
@@ -0,0 +1,62 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef FRONTENDS_COMMON_PRELUDECACHE_H_
+#define FRONTENDS_COMMON_PRELUDECACHE_H_
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "frontends/common/parser_options.h"
+#include "lib/cstring.h"
+
+namespace IR {
+class P4Program;
+}  // namespace IR
+
+namespace P4 {
+
+/**
+ * Splits the preprocessed program @text into its prelude and the rest of the
+ * program.  The prelude is made of the lines that come from the include files
+ * in @includePath (e.g. core.p4 and the architecture file) before the first
+ * line of the program itself that is not a comment.  Lines of the program
+ * that precede the prelude are only comments and are dropped, so the prelude
+ * only depends on the included files and the preprocessor definitions.
+ *
+ * @param prelude  Set to the text of the prelude.
+ * @return the offset in @text where the rest of the program starts, or 0 if
+ * the program has no prelude.
+ */
+size_t splitPrelude(std::string_view text, cstring includePath, std::string &prelude);
+
+/**
+ * Parses the preprocessed P4-16 program read from @in, taking the parsed
+ * declarations of its prelude from the cache in options.preludeCacheDir.
+ * Preludes missing from the cache are parsed and added to it.  Cache entries
+ * are keyed by the prelude text, so a different include path, a different
+ * definition that changes the included files or a different compiler version
+ * selects a different entry.  Cached declarations keep their source positions,
+ * so diagnostics on them do not change.  A compile server also keeps the
+ * preludes in memory for its later requests, with or without a cache directory.
+ *
+ * @return the program, or null on failure.  If failure occurs, an error will
+ * also be reported.
+ */
+const IR::P4Program *parseWithPreludeCache(FILE *in, const ParserOptions &options);
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_PRELUDECACHE_H_ */
@@ -21,6 +21,7 @@ limitations under the License.
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "frontends/common/options.h"
+#include "lib/iterator_range.h"
 
 namespace P4 {
 
@@ -44,58 +45,67 @@ const std::vector<const IR::IDeclaration *> *ResolutionContext::lookup(
     LOG2("Trying to resolve in " << current->toString());
 
     if (auto gen = current->to<IR::IGeneralNamespace>()) {
-        Util::Enumerator<const IR::IDeclaration *> *decls = gen->getDeclsByName(name);
-        switch (type) {
-            case P4::ResolutionType::Any:
-                break;
-            case P4::ResolutionType::Type: {
-                std::function<bool(const IR::IDeclaration *)> kindFilter =
-                    [](const IR::IDeclaration *d) { return d->is<IR::Type>(); };
-                decls = decls->where(kindFilter);
-                break;
-            }
-            case P4::ResolutionType::TypeVariable: {
-                std::function<bool(const IR::IDeclaration *)> kindFilter =
-                    [](const IR::IDeclaration *d) { return d->is<IR::Type_Var>(); };
-                decls = decls->where(kindFilter);
-                break;
+        // The declarations of a program are indexed by name; most lookups end up there.
+        const std::vector<const IR::IDeclaration *> *decls = nullptr;
+        if (auto *program = current->to<IR::P4Program>())
+            decls = &program->getDeclarationsByName(name);
+        else
+            decls = gen->getDeclsByName(name)->toVector();
+
+        auto isVisible = [this, name, type](const IR::IDeclaration *d) {
+            switch (type) {
+                case P4::ResolutionType::Any:
+                    break;
+                case P4::ResolutionType::Type:
+                    if (!d->is<IR::Type>()) return false;
+                    break;
+                case P4::ResolutionType::TypeVariable:
+                    if (!d->is<IR::Type_Var>()) return false;
+                    break;
+                default:
+                    BUG("Unexpected enumeration value %1%", static_cast<int>(type));
             }
-            default:
-                BUG("Unexpected enumeration value %1%", static_cast<int>(type));
-        }
 
-        if (!anyOrder && name.srcInfo.isValid()) {
-            std::function<bool(const IR::IDeclaration *)> locationFilter =
-                [this, name, type](const IR::IDeclaration *d) {
-                    if (d->is<IR::Type_Var>() || d->is<IR::ParserState>())
-                        // type vars and parser states may be used before their definitions
-                        return true;
-                    Util::SourceInfo nsi = name.srcInfo;
-                    Util::SourceInfo dsi = d->getNode()->srcInfo;
-                    bool before = dsi <= nsi;
-                    LOG3("\tPosition test:" << dsi << "<=" << nsi << "=" << before);
-
-                    if (type == ResolutionType::Type) {
-                        if (auto *type_decl = findContext<IR::Type_Declaration>())
-                            if (type_decl->getNode() == d->getNode()) {
-                                ::error(ErrorType::ERR_UNSUPPORTED,
-                                        "Self-referencing types not supported: '%1%' within '%2%'",
-                                        name, d->getNode());
-                            }
-                    } else if (type == ResolutionType::Any) {
-                        if (auto *decl_ctxt = findContext<IR::Declaration>())
-                            if (decl_ctxt->getNode() == d->getNode()) before = false;
+            if (anyOrder || !name.srcInfo.isValid()) return true;
+            if (d->is<IR::Type_Var>() || d->is<IR::ParserState>())
+                // type vars and parser states may be used before their definitions
+                return true;
+            Util::SourceInfo nsi = name.srcInfo;
+            Util::SourceInfo dsi = d->getNode()->srcInfo;
+            bool before = dsi <= nsi;
+            LOG3("\tPosition test:" << dsi << "<=" << nsi << "=" << before);
+
+            if (type == ResolutionType::Type) {
+                if (auto *type_decl = findContext<IR::Type_Declaration>())
+                    if (type_decl->getNode() == d->getNode()) {
+                        ::error(ErrorType::ERR_UNSUPPORTED,
+                                "Self-referencing types not supported: '%1%' within '%2%'", name,
+                                d->getNode());
                     }
+            } else if (type == ResolutionType::Any) {
+                if (auto *decl_ctxt = findContext<IR::Declaration>())
+                    if (decl_ctxt->getNode() == d->getNode()) before = false;
+            }
 
-                    return before;
-                };
-            decls = decls->where(locationFilter);
+            return before;
+        };
+
+        // Only copy the declarations if some of them are not visible here.
+        std::vector<const IR::IDeclaration *> *visible = nullptr;
+        for (size_t i = 0; i < decls->size(); i++) {
+            const auto *d = decls->at(i);
+            if (isVisible(d)) {
+                if (visible != nullptr) visible->push_back(d);
+            } else if (visible == nullptr) {
+                visible = new std::vector<const IR::IDeclaration *>(decls->begin(),
+                                                                    decls->begin() + i);
+            }
         }
+        if (visible != nullptr) decls = visible;
 
-        auto vector = decls->toVector();
-        if (!vector->empty()) {
+        if (!decls->empty()) {
             LOG3("Resolved in " << dbp(current->getNode()));
-            return vector;
+            return decls;
         }
     } else if (auto simple = current->to<IR::ISimpleNamespace>()) {
         auto decl = simple->getDeclByName(name);
@@ -206,13 +216,12 @@ const IR::IDeclaration *ResolutionContext::resolveUnique(IR::ID name, P4::Resolu
     // Check overloaded symbols.
     const IR::Vector<IR::Argument> *arguments;
     if (decls->size() > 1 && (arguments = methodArguments(name))) {
-        decls = Util::Enumerator<const IR::IDeclaration *>::createEnumerator(*decls)
-                    ->where([arguments](const IR::IDeclaration *d) {
-                        auto func = d->to<IR::IFunctional>();
-                        if (func == nullptr) return true;
-                        return func->callMatches(arguments);
-                    })
-                    ->toVector();
+        auto matching = Util::filter(*decls, [arguments](const IR::IDeclaration *d) {
+            auto func = d->to<IR::IFunctional>();
+            if (func == nullptr) return true;
+            return func->callMatches(arguments);
+        });
+        decls = new std::vector<const IR::IDeclaration *>(matching.begin(), matching.end());
     }
 
     if (decls->empty()) {
@@ -297,52 +306,53 @@ const IR::IDeclaration *ResolveReferences::resolvePath(const IR::Path *path, boo
 void ResolveReferences::checkShadowing(const IR::INamespace *ns) const {
     if (!checkShadow) return;
     std::map<cstring, const IR::Node *> prev_in_scope;  // check for shadowing within a scope
-    auto decls = ns->getDeclarations();
-    if (auto nest = ns->to<IR::INestedNamespace>()) {
-        // boost bug -- trying to iterate with an adaptor over an unnamed temp crashes
-        auto temp = nest->getNestedNamespaces();
-        for (auto nn : boost::adaptors::reverse(temp)) decls = nn->getDeclarations()->concat(decls);
-    }
-    for (auto *decl : *decls) {
-        const IR::Node *node = decl->getNode();
-        if (node->is<IR::StructField>()) continue;
-
-        if (node->is<IR::Parameter>() && findContext<IR::Method>() != nullptr)
-            // do not give shadowing warnings for parameters of extern methods
-            continue;
-
-        if (prev_in_scope.count(decl->getName()))
-            ::warning(ErrorType::WARN_SHADOWING, "'%1%' shadows '%2%'", node,
-                      prev_in_scope.at(decl->getName()));
-        else if (!node->is<IR::Method>() && !node->is<IR::Function>())
-            prev_in_scope[decl->getName()] = node;
-        auto prev = resolve(decl->getName(), ResolutionType::Any);
-        if (prev->empty()) continue;
-
-        for (auto p : *prev) {
-            const IR::Node *pnode = p->getNode();
-            if (pnode == node) continue;
-            if ((pnode->is<IR::Method>() || pnode->is<IR::Type_Extern>() ||
-                 pnode->is<IR::P4Program>()) &&
-                (node->is<IR::Method>() || node->is<IR::Function>() || node->is<IR::P4Control>() ||
-                 node->is<IR::P4Parser>() || node->is<IR::Type_Package>()))
-                // These can overload each other.
-                // Also, the constructor is supposed to have the same name as the class.
-                continue;
-            if (pnode->is<IR::Attribute>() && node->is<IR::AttribLocal>())
-                // attribute locals often match attributes
+    // The declarations of the nested namespaces come first.
+    std::vector<const IR::INamespace *> namespaces;
+    if (auto nest = ns->to<IR::INestedNamespace>()) namespaces = nest->getNestedNamespaces();
+    namespaces.push_back(ns);
+    for (auto *scope : namespaces) {
+        for (auto *decl : *scope->getDeclarations()) {
+            const IR::Node *node = decl->getNode();
+            if (node->is<IR::StructField>()) continue;
+
+            if (node->is<IR::Parameter>() && findContext<IR::Method>() != nullptr)
+                // do not give shadowing warnings for parameters of extern methods
                 continue;
 
-            // parameter shadowing
-            if (node->is<IR::Declaration>() && !node->is<IR::Parameter>()) {
-                auto *decl_node = node->to<IR::Declaration>();
-                if (auto *param = pnode->to<IR::Parameter>())
-                    if (decl_node->name.name == param->name.name)
-                        ::error(ErrorType::WARN_SHADOWING,
-                                "declaration of '%1%' shadows a parameter '%2%'", node, pnode);
-            }
+            if (prev_in_scope.count(decl->getName()))
+                ::warning(ErrorType::WARN_SHADOWING, "'%1%' shadows '%2%'", node,
+                          prev_in_scope.at(decl->getName()));
+            else if (!node->is<IR::Method>() && !node->is<IR::Function>())
+                prev_in_scope[decl->getName()] = node;
+            auto prev = resolve(decl->getName(), ResolutionType::Any);
+            if (prev->empty()) continue;
+
+            for (auto p : *prev) {
+                const IR::Node *pnode = p->getNode();
+                if (pnode == node) continue;
+                if ((pnode->is<IR::Method>() || pnode->is<IR::Type_Extern>() ||
+                     pnode->is<IR::P4Program>()) &&
+                    (node->is<IR::Method>() || node->is<IR::Function>() ||
+                     node->is<IR::P4Control>() || node->is<IR::P4Parser>() ||
+                     node->is<IR::Type_Package>()))
+                    // These can overload each other.
+                    // Also, the constructor is supposed to have the same name as the class.
+                    continue;
+                if (pnode->is<IR::Attribute>() && node->is<IR::AttribLocal>())
+                    // attribute locals often match attributes
+                    continue;
+
+                // parameter shadowing
+                if (node->is<IR::Declaration>() && !node->is<IR::Parameter>()) {
+                    auto *decl_node = node->to<IR::Declaration>();
+                    if (auto *param = pnode->to<IR::Parameter>())
+                        if (decl_node->name.name == param->name.name)
+                            ::error(ErrorType::WARN_SHADOWING,
+                                    "declaration of '%1%' shadows a parameter '%2%'", node, pnode);
+                }
 
-            ::warning(ErrorType::WARN_SHADOWING, "'%1%' shadows '%2%'", node, pnode);
+                ::warning(ErrorType::WARN_SHADOWING, "'%1%' shadows '%2%'", node, pnode);
+            }
         }
     }
 }
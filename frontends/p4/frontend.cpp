@@ -25,6 +25,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/bindVariables.h"
 #include "frontends/p4/typeMap.h"
 #include "ir/ir.h"
+#include "ir/pass_result_cache.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
 // Passes
@@ -264,6 +265,14 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     passes.setName("FrontEnd");
     passes.setStopOnError(true);
     passes.addDebugHooks(hooks, true);
+    // The passes only leave state in the IR, so the cached IR is a complete result; dumps of
+    // the intermediate programs would be missing on a hit though.
+    if (options.passCacheDir && options.top4.empty() &&
+        options.prettyPrintFile.isNullOrEmpty()) {
+        auto context = options.passCacheContext() + (skipSideEffectOrdering ? "1" : "0");
+        passes.cacheResults(new PassResultCache(options.passCacheDir), "FrontEndLast",
+                            std::move(context));
+    }
     const IR::P4Program *result = program->apply(passes);
     return result;
 }
@@ -24,6 +24,7 @@ limitations under the License.
 #include "frontends/p4/toP4/toP4.h"
 #include "lib/algorithm.h"
 #include "lib/log.h"
+#include "lib/timer.h"
 #include "syntacticEquivalence.h"
 #include "typeConstraints.h"
 #include "typeSubstitution.h"
@@ -151,6 +152,7 @@ Visitor::profile_t TypeInference::init_apply(const IR::Node *node) {
     if (node->is<IR::P4Program>()) {
         LOG3("Reference map for type checker:" << std::endl << refMap);
         LOG2("TypeInference for " << dbp(node));
+        Util::incrementCounter("typeInferenceRuns");
     }
     initialNode = node;
     refMap->validateMap(node);
@@ -2133,18 +2135,22 @@ const IR::Node *TypeInference::postorder(IR::Entry *entry) {
         return entry;
     }
 
-    TypeVariableSubstitution *tvs =
-        unifyCast(entry, keyTuple, entryKeyType,
-                  "Table entry has type '%1%' which is not the expected type '%2%'",
-                  {keyTuple, entryKeyType});
-    if (tvs == nullptr) return entry;
-    ConstantTypeSubstitution cts(tvs, refMap, typeMap, this);
-    auto ks = cts.convert(keyset);
-    if (::errorCount() > 0) return entry;
+    auto ks = convertLiteralKeys(keyTuple, keyset);
+    if (ks == nullptr) {
+        TypeVariableSubstitution *tvs =
+            unifyCast(entry, keyTuple, entryKeyType,
+                      "Table entry has type '%1%' which is not the expected type '%2%'",
+                      {keyTuple, entryKeyType});
+        if (tvs == nullptr) return entry;
+        ConstantTypeSubstitution cts(tvs, refMap, typeMap, this);
+        auto converted = cts.convert(keyset);
+        if (::errorCount() > 0) return entry;
+        ks = converted->to<IR::ListExpression>();
+    }
 
     if (ks != keyset)
         entry = new IR::Entry(entry->srcInfo, entry->annotations, entry->isConst, entry->priority,
-                              ks->to<IR::ListExpression>(), entry->action, entry->singleton);
+                              ks, entry->action, entry->singleton);
 
     auto actionRef = entry->getAction();
     auto ale = validateActionInitializer(actionRef);
@@ -2159,6 +2165,45 @@ const IR::Node *TypeInference::postorder(IR::Entry *entry) {
     return entry;
 }
 
+const IR::ListExpression *TypeInference::convertLiteralKeys(const IR::Type *keyTuple,
+                                                             const IR::ListExpression *keyset) {
+    auto tuple = keyTuple->to<IR::Type_BaseList>();
+    if (tuple == nullptr || tuple->components.size() != keyset->components.size())
+        return nullptr;
+    IR::Vector<IR::Expression> keys;
+    IR::Vector<IR::Type> types;
+    bool changed = false;
+    for (size_t i = 0; i < keyset->components.size(); i++) {
+        auto ke = keyset->components.at(i);
+        auto keyType = tuple->components.at(i);
+        auto type = typeMap->getType(ke);
+        if (type == nullptr) return nullptr;
+        auto cst = ke->to<IR::Constant>();
+        if (cst != nullptr && type->is<IR::Type_InfInt>() && keyType->is<IR::Type_Bits>()) {
+            // Same conversion, and overflow checks, as ConstantTypeSubstitution.
+            cst = new IR::Constant(cst->srcInfo, keyType, cst->value, cst->base);
+            setType(cst, keyType);
+            setCompileTimeConstant(cst);
+            keys.push_back(cst);
+            types.push_back(keyType);
+            changed = true;
+        } else if (type->is<IR::Type_Dontcare>() ||
+                   (cst != nullptr && typeMap->equivalent(type, keyType))) {
+            keys.push_back(ke);
+            types.push_back(type);
+        } else {
+            return nullptr;
+        }
+    }
+    if (!changed) return keyset;
+    auto type = canonicalize(new IR::Type_List(keyset->srcInfo, types));
+    if (type == nullptr) return nullptr;
+    auto result = new IR::ListExpression(keyset->srcInfo, keys);
+    setType(result, type);
+    setCompileTimeConstant(result);
+    return result;
+}
+
 const IR::Node *TypeInference::postorder(IR::ListExpression *expression) {
     if (done()) return expression;
     bool constant = true;
@@ -193,6 +193,11 @@ class TypeInference : public Transform {
     /// on success.
     const IR::ActionListElement *validateActionInitializer(const IR::Expression *actionCall);
     bool containsActionEnum(const IR::Type *type) const;
+    /// Fast path for the keys of table entries, which in large constant entry lists are
+    /// mostly integer literals: gives untyped literals the type of their key element
+    /// directly, without type unification.  Returns nullptr if some key needs unification.
+    const IR::ListExpression *convertLiteralKeys(const IR::Type *keyTuple,
+                                                 const IR::ListExpression *keyset);
 
     //////////////////////////////////////////////////////////////
 
@@ -16,54 +16,20 @@
 #include "frontends/parsers/v1/v1lexer.hpp"
 #include "frontends/parsers/v1/v1parser.hpp"
 #include "lib/error.h"
+#include "lib/input_buffer.h"
 
-#ifdef HAVE_LIBBOOST_IOSTREAMS
-
-#include <boost/iostreams/device/file_descriptor.hpp>
-#include <boost/iostreams/stream.hpp>
+namespace P4 {
 
 namespace {
 
-/// A RAII helper class that provides an istream wrapper for a stdio FILE*. This
-/// is the efficient implementation for users with boost::iostreams installed.
-struct AutoStdioInputStream {
-    explicit AutoStdioInputStream(FILE *in)
-        : source(fileno(in), boost::iostreams::never_close_handle),
-          buffer(source),
-          stream(&buffer) {}
-
-    std::istream &get() { return stream; }
-
- private:
-    AutoStdioInputStream(const AutoStdioInputStream &) = delete;
-    AutoStdioInputStream(AutoStdioInputStream &&) = delete;
-
-    boost::iostreams::file_descriptor_source source;
-    boost::iostreams::stream_buffer<boost::iostreams::file_descriptor_source> buffer;
-    std::istream stream;
-};
-
-}  // anonymous namespace
-
-#else
-
-/// A RAII helper class that provides an istream wrapper for a stdio FILE*. This
-/// is an inefficient fallback implementation.
-struct AutoStdioInputStream {
-    explicit AutoStdioInputStream(FILE *in) {
-        char buffer[512];
-        while (fgets(buffer, sizeof(buffer), in)) stream << buffer;
-    }
-
-    std::istream &get() { return stream; }
-
- private:
-    std::stringstream stream;
-};
-
-#endif
+/// Sizes the text of @p sources for the rest of @p in when it is known, e.g. for a
+/// Util::MemoryInputStream, so that the text is not reallocated while it is lexed.
+void reserveInput(Util::InputSources *sources, std::istream &in) {
+    auto available = in.rdbuf()->in_avail();
+    if (available > 0) sources->reserve(available);
+}
 
-namespace P4 {
+}  // namespace
 
 AbstractParserDriver::AbstractParserDriver() : sources(new Util::InputSources) {}
 
@@ -137,6 +103,7 @@ bool P4ParserDriver::parse(AbstractP4Lexer &lexer, const char *sourceFile,
     LOG1("Parsing P4-16 program " << sourceFile);
 
     P4ParserDriver driver;
+    reserveInput(driver.sources, in);
     P4Lexer lexer(in);
     if (!driver.parse(lexer, sourceFile, sourceLine)) return nullptr;
     return new IR::P4Program(driver.nodes->srcInfo, *driver.nodes);
@@ -144,8 +111,95 @@ bool P4ParserDriver::parse(AbstractP4Lexer &lexer, const char *sourceFile,
 
 /* static */ const IR::P4Program *P4ParserDriver::parse(FILE *in, const char *sourceFile,
                                                         unsigned sourceLine /* = 1 */) {
-    AutoStdioInputStream inputStream(in);
-    return parse(inputStream.get(), sourceFile, sourceLine);
+    Util::InputBuffer input(in);
+    Util::MemoryInputStream stream(input.contents());
+    return parse(stream, sourceFile, sourceLine);
+}
+
+/* static */ const IR::P4Program *P4ParserDriver::parse(std::istream &in, const char *sourceFile,
+                                                        unsigned sourceLine,
+                                                        const IR::P4Program *prelude) {
+    LOG1("Parsing P4-16 program " << sourceFile << " after a prelude of "
+                                  << prelude->objects.size() << " declarations");
+    BUG_CHECK(isPrelude(prelude), "%1%: not a valid prelude", sourceFile);
+
+    P4ParserDriver driver;
+    driver.declarePrelude(prelude);
+    reserveInput(driver.sources, in);
+    P4Lexer lexer(in);
+    if (!driver.parse(lexer, sourceFile, sourceLine)) return nullptr;
+    return new IR::P4Program(driver.nodes->srcInfo, *driver.nodes);
+}
+
+/* static */ bool P4ParserDriver::isPrelude(const IR::P4Program *program) {
+    for (auto node : program->objects) {
+        if (!node->is<IR::Type_Error>() && !node->is<IR::Declaration_MatchKind>() &&
+            !node->is<IR::Type_Extern>() && !node->is<IR::Type_ArchBlock>() &&
+            !node->is<IR::Type_StructLike>() && !node->is<IR::Type_Enum>() &&
+            !node->is<IR::Type_SerEnum>() && !node->is<IR::Type_Typedef>() &&
+            !node->is<IR::Type_Newtype>() && !node->is<IR::Method>() &&
+            !node->is<IR::Function>() && !node->is<IR::Declaration_Constant>() &&
+            !node->is<IR::Declaration_Instance>() && !node->is<IR::P4Action>())
+            return false;
+    }
+    return true;
+}
+
+void P4ParserDriver::declarePrelude(const IR::P4Program *prelude) {
+    // Mirrors the symbol table updates done by the grammar actions for each of
+    // the declarations accepted by isPrelude().
+    auto declareFunction = [this](IR::ID name, const IR::Type_Method *type) {
+        structure->declareObject(name, type->returnType ? type->returnType->toString() : "void");
+        if (!type->typeParameters->empty()) structure->markAsTemplate(name);
+        structure->pushNamespace(name.srcInfo, false);
+        structure->declareTypes(&type->typeParameters->parameters);
+        structure->declareParameters(&type->parameters->parameters);
+        structure->pop();
+    };
+
+    for (auto node : prelude->objects) {
+        if (auto error = node->to<IR::Type_Error>()) {
+            // Error declarations of the program are merged into this one.
+            onReadErrorDeclaration(error->clone());
+            continue;
+        }
+        nodes->push_back(node);
+        if (auto ext = node->to<IR::Type_Extern>()) {
+            structure->pushContainerType(ext->name, true);
+            if (!ext->typeParameters->empty()) structure->markAsTemplate(ext->name);
+            structure->declareTypes(&ext->typeParameters->parameters);
+            for (auto method : ext->methods) {
+                if (method->name != ext->name) declareFunction(method->name, method->type);
+            }
+            structure->pop();
+        } else if (auto block = node->to<IR::Type_ArchBlock>()) {
+            // Like the grammar, only parser and control types may be declared more than once.
+            structure->pushContainerType(block->name, !block->is<IR::Type_Package>());
+            if (!block->typeParameters->empty()) structure->markAsTemplate(block->name);
+            structure->declareTypes(&block->typeParameters->parameters);
+            if (auto package = block->to<IR::Type_Package>())
+                structure->declareParameters(&package->constructorParams->parameters);
+            else if (auto apply = block->to<IR::IApply>())
+                structure->declareParameters(&apply->getApplyParameters()->parameters);
+            structure->pop();
+        } else if (auto st = node->to<IR::Type_StructLike>()) {
+            structure->pushContainerType(st->name, true);
+            structure->markAsTemplate(st->name);
+            structure->declareTypes(&st->typeParameters->parameters);
+            structure->pop();
+        } else if (node->is<IR::Type_Enum>() || node->is<IR::Type_SerEnum>() ||
+                   node->is<IR::Type_Typedef>() || node->is<IR::Type_Newtype>()) {
+            structure->declareType(node->to<IR::Type_Declaration>()->name);
+        } else if (auto method = node->to<IR::Method>()) {
+            declareFunction(method->name, method->type);
+        } else if (auto function = node->to<IR::Function>()) {
+            declareFunction(function->name, function->type);
+        } else if (auto constant = node->to<IR::Declaration_Constant>()) {
+            structure->declareObject(constant->name, constant->type->toString());
+        } else if (auto instance = node->to<IR::Declaration_Instance>()) {
+            structure->declareObject(instance->name, instance->type->toString());
+        }
+    }
 }
 
 template <typename T>
@@ -289,6 +343,7 @@ V1ParserDriver::V1ParserDriver() : global(new IR::V1Program) {}
 
     // Create and configure the parser and lexer.
     V1ParserDriver driver;
+    P4::reserveInput(driver.sources, in);
     V1Lexer lexer(in);
     V1Parser parser(driver, lexer);
 
@@ -306,8 +361,9 @@ V1ParserDriver::V1ParserDriver() : global(new IR::V1Program) {}
 
 /* static */ const IR::V1Program *V1ParserDriver::parse(FILE *in, const char *sourceFile,
                                                         unsigned sourceLine /* = 1 */) {
-    AutoStdioInputStream inputStream(in);
-    return parse(inputStream.get(), sourceFile, sourceLine);
+    Util::InputBuffer input(in);
+    Util::MemoryInputStream stream(input.contents());
+    return parse(stream, sourceFile, sourceLine);
 }
 
 IR::Constant *V1ParserDriver::constantFold(IR::Expression *expr) {
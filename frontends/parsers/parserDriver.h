@@ -113,6 +113,22 @@ class P4ParserDriver final : public AbstractParserDriver {
                                       unsigned sourceLine = 1);
     static const IR::P4Program *parse(FILE *in, const char *sourceFile, unsigned sourceLine = 1);
 
+    /**
+     * Parse the rest of a P4-16 program whose leading declarations were parsed
+     * separately, e.g. the declarations of the standard include files.
+     *
+     * @param prelude  The leading declarations; must satisfy isPrelude().
+     * @returns a P4Program object holding the declarations of @prelude followed
+     * by the ones read from @in if parsing was successful, or null otherwise.
+     */
+    static const IR::P4Program *parse(std::istream &in, const char *sourceFile,
+                                      unsigned sourceLine, const IR::P4Program *prelude);
+
+    /// @returns true if @program only contains top-level declarations whose
+    /// effect on the parser state can be recreated from the IR, so that it
+    /// can be used as the prelude of another parse.
+    static bool isPrelude(const IR::P4Program *program);
+
     /**
      * Parses a P4-16 annotation body.
      *
@@ -204,6 +220,9 @@ class P4ParserDriver final : public AbstractParserDriver {
     /// Common functionality for parsing.
     bool parse(AbstractP4Lexer &lexer, const char *sourceFile, unsigned sourceLine = 1);
 
+    /// Adds the declarations of @prelude as if they had just been parsed.
+    void declarePrelude(const IR::P4Program *prelude);
+
     /// Common functionality for parsing annotation bodies.
     template <typename T>
     const T *parse(P4AnnotationLexer::Type type, const Util::SourceInfo &srcInfo,
@@ -0,0 +1,282 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_GENERATOR_H_
+#define IR_BINARY_GENERATOR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir/id.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+struct UnparsedConstant;
+
+/// Writes IR nodes in the binary IR format, the binary counterpart of JSONGenerator.  The
+/// fields of each IR class are written by the toBinary method that tools/ir-generator
+/// generates for it, in declaration order and without any field names; BinaryLoader reads
+/// them back with the matching generated constructor.
+///
+/// Integers are LEB128 varints, zigzag encoded if signed.  Strings are written once and
+/// later referred to by their index: 0 is a null string, 1 is followed by the length and
+/// bytes of a new string, and k + 2 refers to the k-th string written.  A node is either 0
+/// (null), 1 followed by its type name, its fields and, with dumpSourceInfo, its source
+/// info, or 2 followed by the index of a node already written, in the order nodes were
+/// first written.
+class BinaryGenerator {
+    std::ostream &out;
+    bool dumpSourceInfo;
+    /// Output not written to 'out' yet.
+    std::string buffer;
+    std::unordered_map<cstring, uint64_t> strings;
+    std::unordered_map<const IR::Node *, uint64_t> nodes;
+    /// Whether ids are written; otherwise the loaded nodes get fresh ones.
+    bool nodeIds;
+
+    template <typename T>
+    class has_toBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::toBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+ public:
+    enum NodeTag : unsigned char { NULL_NODE = 0, NODE = 1, NODE_REF = 2 };
+
+    explicit BinaryGenerator(std::ostream &out, bool dumpSourceInfo = false, bool nodeIds = true)
+        : out(out), dumpSourceInfo(dumpSourceInfo), nodeIds(nodeIds) {}
+    ~BinaryGenerator() { flush(); }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    void putByte(unsigned char byte) { buffer.push_back(static_cast<char>(byte)); }
+    void putBytes(const char *data, size_t size) { buffer.append(data, size); }
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            putByte(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        putByte(static_cast<unsigned char>(value));
+    }
+
+    template <typename T>
+    void generate(const safe_vector<T> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename T>
+    void generate(const std::vector<T> &v) {
+        putVarint(v.size());
+        for (const T &el : v) generate(el);
+    }
+
+    template <typename T, typename U>
+    void generate(const std::pair<T, U> &v) {
+        generate(v.first);
+        generate(v.second);
+    }
+
+    template <typename T>
+    void generate(const std::optional<T> &v) {
+        generate(v.has_value());
+        if (v) generate(*v);
+    }
+
+    template <typename T, class COMP, class ALLOC>
+    void generate(const std::set<T, COMP, ALLOC> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename T, class COMP, class ALLOC>
+    void generate(const ordered_set<T, COMP, ALLOC> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void generate(const std::map<K, V, COMP, ALLOC> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void generate(const std::multimap<K, V, COMP, ALLOC> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void generate(const ordered_map<K, V, COMP, ALLOC> &v) {
+        putVarint(v.size());
+        for (auto &el : v) generate(el);
+    }
+
+    void generate(bool v) { putByte(v ? 1 : 0); }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type generate(T v) {
+        if constexpr (std::is_signed<T>::value) {
+            auto value = static_cast<int64_t>(v);
+            putVarint((static_cast<uint64_t>(value) << 1) ^ (value < 0 ? ~0ULL : 0));
+        } else {
+            putVarint(v);
+        }
+    }
+    /// Writes an id of a node, i.e., its Node::id or a number it gets from a counter of its
+    /// class, like declid; -1 if ids are not written.
+    void generateId(long id) { generate(nodeIds ? id : -1L); }
+    void generate(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int i = 0; i < 8; i++) putByte(static_cast<unsigned char>(bits >> (8 * i)));
+    }
+    /// Values that fit in 64 bits are written as a varint, others as decimal text.
+    template <typename T>
+    typename std::enable_if<std::is_same<T, big_int>::value>::type generate(const T &v) {
+        if (v >= std::numeric_limits<int64_t>::min() && v <= std::numeric_limits<int64_t>::max()) {
+            putByte(0);
+            generate(static_cast<int64_t>(v));
+        } else {
+            putByte(1);
+            generateText(v.str());
+        }
+    }
+
+    void generate(cstring v) {
+        if (!v) {
+            putVarint(0);
+            return;
+        }
+        auto [it, inserted] = strings.emplace(v, strings.size());
+        if (!inserted) {
+            putVarint(it->second + 2);
+            return;
+        }
+        putVarint(1);
+        putVarint(v.size());
+        putBytes(v.c_str(), v.size());
+    }
+    void generate(const IR::ID &v) {
+        generate(v.name);
+        generate(v.originalName);
+    }
+
+    /// Writes a string that is not worth interning.
+    void generateText(const std::string &v) {
+        putVarint(v.size());
+        putBytes(v.data(), v.size());
+    }
+    template <typename T>
+    typename std::enable_if<std::is_same<T, LTBitMatrix>::value ||
+                            std::is_same<T, bitvec>::value>::type
+    generate(const T &v) {
+        std::stringstream text;
+        text << v;
+        generateText(text.str());
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type generate(T v) {
+        generate(static_cast<typename std::underlying_type<T>::type>(v));
+    }
+
+    void generate(const match_t &v) {
+        generate(v.word0);
+        generate(v.word1);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_same<T, UnparsedConstant>::value>::type generate(const T *v) {
+        generate(v != nullptr);
+        if (v) *this << v->text << v->skip << v->base << v->hasWidth;
+    }
+
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T &v) {
+        v.toBinary(*this);
+    }
+
+    void generate(const IR::Node &v) {
+        auto [it, inserted] = nodes.emplace(&v, nodes.size());
+        if (!inserted) {
+            putByte(NODE_REF);
+            putVarint(it->second);
+            return;
+        }
+        putByte(NODE);
+        generate(v.node_type_name());
+        v.toBinary(*this);
+        if (dumpSourceInfo) v.sourceInfoToBinary(*this);
+        if (buffer.size() >= (1 << 16)) flush();
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type generate(const T *v) {
+        if (v)
+            generate(*v->getNode());
+        else
+            putByte(NULL_NODE);
+    }
+
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T *v) {
+        generate(v != nullptr);
+        if (v) generate(*v);
+    }
+
+    template <typename T, size_t N>
+    void generate(const T (&v)[N]) {
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename T>
+    BinaryGenerator &operator<<(const T &v) {
+        generate(v);
+        return *this;
+    }
+};
+
+#endif /* IR_BINARY_GENERATOR_H_ */
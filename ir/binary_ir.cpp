@@ -0,0 +1,183 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/binary_ir.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
+#include "ir/visitor.h"
+#include "lib/error.h"
+#include "lib/source_file.h"
+
+namespace {
+
+const char magic[8] = {'P', '4', 'I', 'R', 'B', 'I', 'N', '\0'};
+/// The flag set when the nodes are followed by their source info.
+const uint64_t withSourceInfo = 1;
+
+/// Lists the nodes of an IR tree in the order in which they are visited, each node once.
+class ListNodes : public Inspector {
+    std::vector<const IR::Node *> &nodes;
+
+    bool preorder(const IR::Node *node) override {
+        nodes.push_back(node);
+        return true;
+    }
+
+ public:
+    explicit ListNodes(std::vector<const IR::Node *> &nodes) : nodes(nodes) {}
+};
+
+std::vector<const IR::Node *> listNodes(const IR::Node *root) {
+    std::vector<const IR::Node *> nodes;
+    ListNodes list(nodes);
+    root->apply(list);
+    return nodes;
+}
+
+void writePositions(BinaryGenerator &out, const IR::Node *root,
+                    const std::vector<const Util::InputSources *> &sources) {
+    auto nodes = listNodes(root);
+    out.putVarint(nodes.size());
+    for (auto *node : nodes) {
+        const auto &srcInfo = node->srcInfo;
+        auto it = srcInfo.isValid()
+                      ? std::find(sources.begin(), sources.end(), srcInfo.getSources())
+                      : sources.end();
+        if (it == sources.end()) {
+            out.putVarint(0);
+            continue;
+        }
+        out.putVarint(it - sources.begin() + 1);
+        out.putVarint(srcInfo.getStart().getLineNumber());
+        out.putVarint(srcInfo.getStart().getColumnNumber());
+        out.putVarint(srcInfo.getEnd().getLineNumber());
+        out.putVarint(srcInfo.getEnd().getColumnNumber());
+    }
+}
+
+/// Gives the nodes of @root, just created by BinaryLoader, the source positions in @data.
+/// @returns false if @data does not hold positions for exactly these nodes.
+bool readPositions(const IR::Node *root, const char *data, size_t size,
+                   const std::vector<const Util::InputSources *> &sources) {
+    auto nodes = listNodes(root);
+    try {
+        BinaryLoader in(data, size);
+        if (in.getVarint() != nodes.size()) return false;
+        for (auto *node : nodes) {
+            auto index = in.getVarint();
+            if (index == 0) continue;
+            if (index > sources.size()) return false;
+            uint64_t startLine = in.getVarint(), startColumn = in.getVarint();
+            uint64_t endLine = in.getVarint(), endColumn = in.getVarint();
+            if (startLine == 0 || endLine == 0) return false;
+            Util::SourcePosition start(startLine, startColumn), end(endLine, endColumn);
+            if (end < start) return false;
+            // The loader just created the node, nothing else refers to it yet.
+            const_cast<IR::Node *>(node)->srcInfo =
+                Util::SourceInfo(sources[index - 1], start, end);
+        }
+        return in.restSize() == 0;
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+}
+
+}  // namespace
+
+void writeBinaryIR(std::ostream &out, const IR::Node *node, bool dumpSourceInfo,
+                   const std::vector<const Util::InputSources *> *sources, bool nodeIds) {
+    BinaryGenerator binary(out, dumpSourceInfo, nodeIds);
+    binary.putBytes(magic, sizeof(magic));
+    for (int i = 0; i < 4; i++)
+        binary.putByte(static_cast<unsigned char>(binaryIRVersion >> (8 * i)));
+    binary.putVarint(dumpSourceInfo ? withSourceInfo : 0);
+    binary << node;
+    if (sources) writePositions(binary, node, *sources);
+    binary.flush();
+}
+
+std::vector<const Util::InputSources *> inputSourcesOf(const IR::Node *node) {
+    std::vector<const Util::InputSources *> sources;
+    for (auto *n : listNodes(node)) {
+        if (!n->srcInfo.isValid()) continue;
+        auto *s = n->srcInfo.getSources();
+        if (std::find(sources.begin(), sources.end(), s) == sources.end()) sources.push_back(s);
+    }
+    return sources;
+}
+
+const IR::Node *readBinaryIR(const char *data, size_t size, bool freshIds,
+                             const std::vector<const Util::InputSources *> *sources) {
+    try {
+        BinaryLoader header(data, size);
+        if (std::memcmp(header.getBytes(sizeof(magic)), magic, sizeof(magic)) != 0)
+            throw std::runtime_error("not a binary IR file");
+        uint32_t version = 0;
+        for (int i = 0; i < 4; i++) version |= static_cast<uint32_t>(header.getByte()) << (8 * i);
+        if (version != binaryIRVersion)
+            throw std::runtime_error("unsupported format version " + std::to_string(version));
+        auto flags = header.getVarint();
+
+        BinaryLoader loader(header.rest(), header.restSize(), flags & withSourceInfo);
+        const IR::Node *node = nullptr;
+        loader >> node;
+        if (node && sources &&
+            !readPositions(node, loader.rest(), loader.restSize(), *sources))
+            return nullptr;
+        if (node && freshIds) {
+            for (auto *n : loader.getNodes()) n->renumber();
+        }
+        return node;
+    } catch (const std::runtime_error &e) {
+        ::error(ErrorType::ERR_INVALID, "malformed binary IR: %1%", e.what());
+        return nullptr;
+    }
+}
+
+const IR::Node *loadBinaryIR(cstring filename, bool freshIds,
+                             const std::vector<const Util::InputSources *> *sources) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ::error(ErrorType::ERR_IO, "Can't open %1%", filename);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::error(ErrorType::ERR_IO, "Can't read %1%", filename);
+        close(fd);
+        return nullptr;
+    }
+    size_t size = st.st_size;
+    void *data = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED) {
+        ::error(ErrorType::ERR_IO, "Can't read %1%", filename);
+        return nullptr;
+    }
+    // The loaded nodes copy everything they need, so the mapping can go away.
+    auto *node = readBinaryIR(static_cast<const char *>(data), size, freshIds, sources);
+    munmap(data, size);
+    return node;
+}
@@ -0,0 +1,83 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_IR_H_
+#define IR_BINARY_IR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "lib/cstring.h"
+
+namespace IR {
+class Node;
+}  // namespace IR
+
+namespace Util {
+class InputSources;
+}  // namespace Util
+
+/**
+The binary IR format holds the same IR classes and fields as --toJSON/--fromJSON: for every IR
+class tools/ir-generator generates a toBinary method that writes its fields, with
+BinaryGenerator, and a constructor that reads them back, with BinaryLoader, next to the
+methods it generates for the JSON format.  Fields are written in declaration order, without
+names or punctuation; integers are varints, strings are written once and then referred to by
+index, and a node reached again is written as the index of its first occurrence.  Loading
+thus creates the nodes straight from the data, without any intermediate tree.
+
+A file starts with the 8 byte magic "P4IRBIN\0", the format version as a little-endian 32
+bit integer and a varint of flags; flag 1 means that the nodes are followed by their source
+info (file, line, column and source fragment, as with --toJSON).  Then comes the root node.
+
+The document may be followed by the source positions of its nodes: the number of nodes, then
+for each node, in the order an Inspector visits them, a varint that is 0 for nodes without a
+position or 1 + the index of their input sources, followed by the start and end line and
+column.
+*/
+
+/// Version of the binary IR format.  Must be bumped whenever the encoding changes.
+static constexpr uint32_t binaryIRVersion = 3;
+
+/// Writes @node to @out in the binary IR format.  With @dumpSourceInfo the nodes only keep the
+/// source info --toJSON writes, which is not enough to report diagnostics on them.
+/// If @sources is given, the positions of the nodes in these input sources are also written,
+/// after the document, so that loadBinaryIR can give them back to the loaded nodes.
+/// Without @nodeIds, the ids of the nodes are not written and the loaded nodes get new ones;
+/// the output then only depends on the contents of the IR.
+void writeBinaryIR(std::ostream &out, const IR::Node *node, bool dumpSourceInfo = false,
+                   const std::vector<const Util::InputSources *> *sources = nullptr,
+                   bool nodeIds = true);
+
+/// Loads the IR in the binary IR image @data, as loadBinaryIR does for a file.  Reports an
+/// error and returns nullptr if the image is malformed or was written with a different
+/// format version.
+const IR::Node *readBinaryIR(const char *data, size_t size, bool freshIds = false,
+                             const std::vector<const Util::InputSources *> *sources = nullptr);
+
+/// Memory maps @filename and loads the IR it contains.  If @freshIds, the loaded nodes get
+/// new ids instead of the ones stored in the file.  Reports an error and returns nullptr on
+/// failure.  If @sources is given, the nodes get back the source positions written with them,
+/// in the input sources with the same index; if the file has no positions, or they do not fit
+/// the loaded IR, nullptr is returned without reporting an error.
+const IR::Node *loadBinaryIR(cstring filename, bool freshIds = false,
+                             const std::vector<const Util::InputSources *> *sources = nullptr);
+
+/// @returns the input sources the source positions of @node and its descendants refer to, in
+/// the order in which writeBinaryIR reaches them.
+std::vector<const Util::InputSources *> inputSourcesOf(const IR::Node *node);
+
+#endif /* IR_BINARY_IR_H_ */
@@ -0,0 +1,396 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_BINARY_LOADER_H_
+#define IR_BINARY_LOADER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ir/binary_generator.h"
+#include "ir/ir.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/map.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+/// Reads IR nodes written by BinaryGenerator, the binary counterpart of JSONLoader.  Nodes
+/// are created by the constructors taking a BinaryLoader that tools/ir-generator generates
+/// for every IR class, which read the fields straight from the data.  Malformed data throws
+/// std::runtime_error.
+class BinaryLoader {
+    const unsigned char *pos;
+    const unsigned char *end;
+    bool withSourceInfo;
+    std::vector<cstring> strings;
+    /// The nodes read so far, in the order they were written; nullptr while being read.
+    std::vector<IR::Node *> nodes;
+
+    template <typename T>
+    class has_fromBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::fromBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    /// Reads a node.  Its type name is looked up in IR::binary_unpacker_table; types that
+    /// are not in the table, i.e. instances of the IR class templates, are only read if they
+    /// are the expected @type, with @factory.
+    IR::Node *getNode(cstring type, BinaryNodeFactoryFn factory) {
+        auto tag = getByte();
+        if (tag == BinaryGenerator::NULL_NODE) return nullptr;
+        if (tag == BinaryGenerator::NODE_REF) {
+            auto index = getVarint();
+            if (index >= nodes.size() || !nodes[index])
+                throw std::runtime_error("invalid node reference");
+            return nodes[index];
+        }
+        if (tag != BinaryGenerator::NODE) throw std::runtime_error("invalid node tag");
+        cstring nodeType;
+        unpack(nodeType);
+        if (!nodeType) throw std::runtime_error("missing node type");
+        auto fn = get(IR::binary_unpacker_table, nodeType);
+        if (!fn && nodeType == type) fn = factory;
+        if (!fn) throw std::runtime_error("unexpected node type " + nodeType);
+        auto index = nodes.size();
+        nodes.push_back(nullptr);
+        auto *node = fn(*this);
+        nodes[index] = node;
+        if (withSourceInfo) {
+            bool hasSourceInfo = false;
+            unpack(hasSourceInfo);
+            if (hasSourceInfo) {
+                cstring filename, fragment;
+                unsigned line = 0, column = 0;
+                *this >> filename >> line >> column >> fragment;
+                node->srcInfo = Util::SourceInfo(filename, line, column, fragment);
+            }
+        }
+        return node;
+    }
+
+    template <typename T>
+    const T *getNode() {
+        IR::Node *node = nullptr;
+        if constexpr (has_fromBinary<T>::value)
+            node = getNode(T::static_type_name(), [](BinaryLoader &binary) -> IR::Node * {
+                return T::fromBinary(binary);
+            });
+        else
+            node = getNode(nullptr, nullptr);
+        if (!node) return nullptr;
+        auto *result = node->to<T>();
+        if (!result) throw std::runtime_error("unexpected node type " + node->node_type_name());
+        return result;
+    }
+
+    template <typename T>
+    void unpack(safe_vector<T> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            T temp;
+            unpack(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+
+    template <typename T>
+    void unpack(std::vector<T> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            T temp;
+            unpack(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+
+    template <typename T, class COMP, class ALLOC>
+    void unpack(std::set<T, COMP, ALLOC> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            T temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename T, class COMP, class ALLOC>
+    void unpack(ordered_set<T, COMP, ALLOC> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            T temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void unpack(std::map<K, V, COMP, ALLOC> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void unpack(std::multimap<K, V, COMP, ALLOC> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename K, typename V, class COMP, class ALLOC>
+    void unpack(ordered_map<K, V, COMP, ALLOC> &v) {
+        for (auto count = getVarint(); count > 0; --count) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+
+    template <typename T, typename U>
+    void unpack(std::pair<T, U> &v) {
+        unpack(v.first);
+        unpack(v.second);
+    }
+
+    template <typename T>
+    void unpack(std::optional<T> &v) {
+        bool isValid = false;
+        unpack(isValid);
+        if (!isValid) {
+            v = std::nullopt;
+            return;
+        }
+        T value;
+        unpack(value);
+        v = std::move(value);
+    }
+
+    void unpack(bool &v) {
+        auto byte = getByte();
+        if (byte > 1) throw std::runtime_error("invalid boolean");
+        v = byte != 0;
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type unpack(T &v) {
+        auto value = getVarint();
+        if constexpr (std::is_signed<T>::value)
+            v = static_cast<T>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+        else
+            v = static_cast<T>(value);
+    }
+    void unpack(double &v) {
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++) bits |= static_cast<uint64_t>(getByte()) << (8 * i);
+        std::memcpy(&v, &bits, sizeof(v));
+    }
+    void unpack(big_int &v) {
+        if (getByte() == 0) {
+            int64_t value = 0;
+            unpack(value);
+            v = value;
+        } else {
+            v = big_int(getText());
+        }
+    }
+    void unpack(cstring &v) {
+        auto index = getVarint();
+        if (index == 0) {
+            v = nullptr;
+        } else if (index == 1) {
+            auto size = getVarint();
+            auto *data = getBytes(size);
+            v = cstring(data, size);
+            strings.push_back(v);
+        } else if (index - 2 < strings.size()) {
+            v = strings[index - 2];
+        } else {
+            throw std::runtime_error("invalid string reference");
+        }
+    }
+    void unpack(IR::ID &v) {
+        unpack(v.name);
+        unpack(v.originalName);
+    }
+
+    std::string getText() {
+        auto size = getVarint();
+        auto *data = getBytes(size);
+        return std::string(data, size);
+    }
+    void unpack(LTBitMatrix &m) {
+        if (!(getText().c_str() >> m)) throw std::runtime_error("invalid bit matrix");
+    }
+    void unpack(bitvec &v) {
+        if (!(getText().c_str() >> v)) throw std::runtime_error("invalid bit vector");
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type unpack(T &v) {
+        typename std::underlying_type<T>::type value;
+        unpack(value);
+        v = static_cast<T>(value);
+    }
+
+    void unpack(match_t &v) {
+        unpack(v.word0);
+        unpack(v.word1);
+    }
+
+    void unpack(UnparsedConstant *&v) {
+        bool present = false;
+        unpack(present);
+        if (!present) {
+            v = nullptr;
+            return;
+        }
+        cstring text("");
+        unsigned skip = 0;
+        unsigned base = 0;
+        bool hasWidth = false;
+        *this >> text >> skip >> base >> hasWidth;
+        v = new UnparsedConstant({text, skip, base, hasWidth});
+    }
+
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T *&v) {
+        bool present = false;
+        unpack(present);
+        v = present ? T::fromBinary(*this) : nullptr;
+    }
+
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T &v) {
+        v = T(*this);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(T &v) {
+        auto *node = getNode<T>();
+        if (!node) throw std::runtime_error("missing node");
+        v = *node;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(const T *&v) {
+        v = getNode<T>();
+    }
+
+    template <typename T, size_t N>
+    void unpack(T (&v)[N]) {
+        for (auto &el : v) unpack(el);
+    }
+
+ public:
+    BinaryLoader(const char *data, size_t size, bool withSourceInfo = false)
+        : pos(reinterpret_cast<const unsigned char *>(data)),
+          end(pos + size),
+          withSourceInfo(withSourceInfo) {}
+
+    /// The data not read yet.
+    const char *rest() const { return reinterpret_cast<const char *>(pos); }
+    size_t restSize() const { return end - pos; }
+    /// All the nodes read.
+    const std::vector<IR::Node *> &getNodes() const { return nodes; }
+
+    unsigned char getByte() {
+        if (pos == end) throw std::runtime_error("unexpected end of data");
+        return *pos++;
+    }
+    const char *getBytes(uint64_t size) {
+        if (size > static_cast<uint64_t>(end - pos)) throw std::runtime_error("truncated data");
+        auto *data = reinterpret_cast<const char *>(pos);
+        pos += size;
+        return data;
+    }
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            unsigned char byte = getByte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("invalid varint");
+    }
+
+    /// Reads an id written by BinaryGenerator::generateId.  Keeps the fresh id @id was
+    /// initialized with if none was written.
+    void unpackId(long &id) {
+        long stored = -1;
+        unpack(stored);
+        if (stored >= 0) id = stored;
+    }
+
+    template <typename T>
+    BinaryLoader &operator>>(T &v) {
+        unpack(v);
+        return *this;
+    }
+};
+
+template <class T>
+IR::Vector<T>::Vector(BinaryLoader &binary) : VectorBase(binary) {
+    binary >> vec;
+}
+template <class T>
+IR::Vector<T> *IR::Vector<T>::fromBinary(BinaryLoader &binary) {
+    return new Vector<T>(binary);
+}
+template <class T>
+IR::IndexedVector<T>::IndexedVector(BinaryLoader &binary) : Vector<T>(binary) {
+    binary >> declarations;
+}
+template <class T>
+IR::IndexedVector<T> *IR::IndexedVector<T>::fromBinary(BinaryLoader &binary) {
+    return new IndexedVector<T>(binary);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC>::NameMap(BinaryLoader &binary) : Node(binary) {
+    binary >> symbols;
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC> *IR::NameMap<T, MAP, COMP, ALLOC>::fromBinary(
+    BinaryLoader &binary) {
+    return new IR::NameMap<T, MAP, COMP, ALLOC>(binary);
+}
+
+#endif /* IR_BINARY_LOADER_H_ */
@@ -0,0 +1,83 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_DECLARATION_INDEX_H_
+#define IR_DECLARATION_INDEX_H_
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "ir/declaration.h"
+#include "ir/vector.h"
+#include "lib/cstring.h"
+
+namespace IR {
+
+/// An index of the declarations among the objects of a namespace, by name. The index is built
+/// by the first lookup and kept with the namespace node, so later lookups neither scan the
+/// objects nor allocate. Copies of an index start out empty: the clone of a node never uses the
+/// index of the original node.
+///
+/// Nodes may still be modified while they are created or transformed. The index is rebuilt when
+/// the revision of the objects changed since it was built, which any non-const access to them
+/// does. An index that is up to date is complete, so a name it does not know is not declared.
+class DeclarationIndex {
+ public:
+    using Declarations = std::vector<const IDeclaration *>;
+
+    DeclarationIndex() = default;
+    DeclarationIndex(const DeclarationIndex & /*other*/) {}
+    DeclarationIndex &operator=(const DeclarationIndex & /*other*/) {
+        built = false;
+        return *this;
+    }
+
+    /// @returns the declarations named @p name among @p objects, in the order of @p objects.
+    /// The result stays valid when the index is rebuilt, and then holds the declarations of the
+    /// name among the modified objects.
+    template <class T>
+    const Declarations &lookup(const Vector<T> &objects, cstring name) {
+        if (!built || objects.revision() != indexedRevision) build(objects);
+        auto it = index.find(name);
+        return it != index.end() ? it->second : empty;
+    }
+
+ private:
+    /// Rebuilding keeps the entries of the names that are no longer declared, so references
+    /// returned by earlier lookups stay valid; the map does not allocate again either.
+    std::unordered_map<cstring, Declarations> index;
+
+    /// Whether @ref index holds the declarations of the objects of revision @ref indexedRevision.
+    bool built = false;
+    size_t indexedRevision = 0;
+
+    static inline const Declarations empty;
+
+    template <class T>
+    void build(const Vector<T> &objects) {
+        for (auto &[name, declarations] : index) declarations.clear();
+        for (const auto *object : objects) {
+            if (const auto *decl = dynamic_cast<const IDeclaration *>(object)) {
+                index[decl->getName().name].push_back(decl);
+            }
+        }
+        built = true;
+        indexedRevision = objects.revision();
+    }
+};
+
+}  // namespace IR
+
+#endif /* IR_DECLARATION_INDEX_H_ */
@@ -0,0 +1,174 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_DENSE_NODE_MAP_H_
+#define IR_DENSE_NODE_MAP_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir/node.h"
+
+namespace IR {
+
+/// A map from IR nodes to values of type V, stored in pages of a dense array indexed by
+/// Node::id. Visitors keep one entry for every node they visit; indexing by id avoids hashing
+/// and allocating for each of them.
+///
+/// The slots in use are listed, so clear() only resets those. The pages used since the last
+/// clear() are kept for the next traversal, up to MAX_RETAINED_PAGES of them; the others are
+/// released, so a map that is reused for many traversals only holds the pages of the ids that
+/// are still live. Reset slots hold no pointers, which would keep the nodes of earlier
+/// traversals from being garbage collected. Entries record their node: nodes that share an id
+/// with another node in the map (e.g., nodes read from a JSON file and not renumbered) are kept
+/// in a separate hash map. So are nodes whose page would make the map too sparse: the ids of the
+/// nodes of a program spread out as passes create new nodes, and the pages used since the last
+/// clear() may hold at most MAX_SLOTS_PER_ENTRY slots for each entry. Pointers to values stay
+/// valid until the value is erased or the map is cleared.
+template <class V>
+class DenseNodeMap {
+    static constexpr size_t PAGE_BITS = 8;
+    static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+    static constexpr size_t MAX_SLOTS_PER_ENTRY = 16;
+    static constexpr size_t MAX_RETAINED_PAGES = 512;
+
+    /// A slot is in use if its node is set.
+    struct Entry {
+        const Node *node = nullptr;
+        V value;
+    };
+
+    std::vector<std::unique_ptr<Entry[]>> pages;
+    /// Whether each page has been used since the last clear().
+    std::vector<bool> touched;
+    std::unordered_map<const Node *, V> overflow;
+    /// The slots in use.
+    std::vector<Entry *> used;
+    /// The indices of the allocated pages.
+    std::vector<size_t> allocated;
+    size_t touchedPages = 0;
+    size_t entries = 0;
+
+    /// @returns the slot of @p n, or nullptr if @p n is null or its id has no slot.
+    Entry *slot(const Node *n, bool allocate) {
+        if (n == nullptr || n->id < 0) return nullptr;
+        size_t page = size_t(n->id) >> PAGE_BITS;
+        if (page >= pages.size()) {
+            if (!allocate) return nullptr;
+            pages.resize(page + 1);
+            touched.resize(page + 1);
+        }
+        if (!pages[page]) {
+            if (!allocate || touchedPages * PAGE_SIZE > MAX_SLOTS_PER_ENTRY * entries)
+                return nullptr;
+            pages[page].reset(new Entry[PAGE_SIZE]);
+            allocated.push_back(page);
+        }
+        if (allocate && !touched[page]) {
+            touched[page] = true;
+            touchedPages++;
+        }
+        return &pages[page][size_t(n->id) & (PAGE_SIZE - 1)];
+    }
+    static void reset(Entry *e) {
+        e->node = nullptr;
+        e->value = V();
+    }
+
+ public:
+    DenseNodeMap() = default;
+    DenseNodeMap(const DenseNodeMap &) = delete;
+    DenseNodeMap &operator=(const DenseNodeMap &) = delete;
+
+    /// @returns the value of @p n, or nullptr if @p n is not in the map.
+    V *find(const Node *n) {
+        Entry *e = slot(n, false);
+        if (e != nullptr && e->node == n) return &e->value;
+        if (overflow.empty()) return nullptr;
+        auto it = overflow.find(n);
+        return it != overflow.end() ? &it->second : nullptr;
+    }
+    const V *find(const Node *n) const { return const_cast<DenseNodeMap *>(this)->find(n); }
+    size_t count(const Node *n) const { return find(n) != nullptr; }
+
+    /// Inserts @p value for @p n if @p n is not in the map yet.
+    /// @returns the value of @p n, and whether it was inserted.
+    std::pair<V *, bool> emplace(const Node *n, V value) {
+        if (V *existing = find(n)) return {existing, false};
+        entries++;
+        Entry *e = slot(n, true);
+        if (e != nullptr && e->node == nullptr) {
+            e->node = n;
+            e->value = std::move(value);
+            used.push_back(e);
+            return {&e->value, true};
+        }
+        return {&overflow.emplace(n, std::move(value)).first->second, true};
+    }
+
+    /// Removes all entries for which @p pred(node, value) holds.
+    template <class Pred>
+    void erase_if(Pred pred) {
+        size_t kept = 0;
+        for (Entry *e : used) {
+            if (pred(e->node, e->value)) {
+                reset(e);
+                entries--;
+            } else {
+                used[kept++] = e;
+            }
+        }
+        used.resize(kept);
+        for (auto it = overflow.begin(); it != overflow.end();) {
+            if (pred(it->first, it->second)) {
+                it = overflow.erase(it);
+                entries--;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /// Removes all entries in time linear in their number and the number of pages. Keeps the
+    /// pages used since the last clear() for reuse, up to MAX_RETAINED_PAGES, and releases the
+    /// others.
+    void clear() {
+        for (Entry *e : used) reset(e);
+        used.clear();
+        overflow.clear();
+        entries = 0;
+        size_t kept = 0;
+        for (size_t page : allocated) {
+            if (touched[page] && kept < MAX_RETAINED_PAGES)
+                allocated[kept++] = page;
+            else
+                pages[page].reset();
+            touched[page] = false;
+        }
+        allocated.resize(kept);
+        touchedPages = 0;
+    }
+
+    size_t size() const { return entries; }
+    /// @returns the number of pages the map holds.
+    size_t pageCount() const { return allocated.size(); }
+    bool empty() const { return entries == 0; }
+};
+
+}  // namespace IR
+
+#endif /* IR_DENSE_NODE_MAP_H_ */
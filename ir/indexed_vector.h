@@ -28,6 +28,7 @@ limitations under the License.
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryLoader;
 
 namespace IR {
 
@@ -82,6 +83,7 @@ class IndexedVector : public Vector<T> {
     }
     explicit IndexedVector(const Vector<T> &a) { insert(Vector<T>::end(), a.begin(), a.end()); }
     explicit IndexedVector(JSONLoader &json);
+    explicit IndexedVector(BinaryLoader &binary);
 
     void clear() {
         IR::Vector<T>::clear();
@@ -201,7 +203,9 @@ class IndexedVector : public Vector<T> {
     void visit_children(Visitor &v) const override;
 
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryGenerator &binary) const override;
     static IndexedVector<T> *fromJSON(JSONLoader &json);
+    static IndexedVector<T> *fromBinary(BinaryLoader &binary);
     void validate() const override {
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
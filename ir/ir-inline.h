@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef IR_IR_INLINE_H_
 #define IR_IR_INLINE_H_
 
+#include "ir/binary_generator.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/json_generator.h"
@@ -112,6 +113,8 @@ void IR::Vector<T>::visit_children(Visitor &v) {
             continue;
         }
         if (auto e = dynamic_cast<const T *>(n)) {
+            // The visitor may have looked at this vector since the iteration started.
+            revisions++;
             *i++ = e;
             continue;
         }
@@ -148,8 +151,21 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     json << "]";
 }
 
+template <class T>
+void IR::Vector<T>::toBinary(BinaryGenerator &binary) const {
+    Node::toBinary(binary);
+    binary << vec;
+}
+
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Expression> &v);
 
+// The declarations are written in their order, which may differ from that of the elements.
+template <class T>
+void IR::IndexedVector<T>::toBinary(BinaryGenerator &binary) const {
+    Vector<T>::toBinary(binary);
+    binary << declarations;
+}
+
 template <class T>
 void IR::IndexedVector<T>::visit_children(Visitor &v) {
     for (auto i = begin(); i != end();) {
@@ -287,6 +303,13 @@ void IR::NameMap<T, MAP, COMP, ALLOC>::toJSON(JSONGenerator &json) const {
     }
     json << "}";
 }
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+void IR::NameMap<T, MAP, COMP, ALLOC>::toBinary(BinaryGenerator &binary) const {
+    Node::toBinary(binary);
+    binary << symbols;
+}
 
 template <class KEY, class VALUE,
           template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
@@ -40,6 +40,7 @@ limitations under the License.
 #include "lib/error.h"
 #include "lib/error_catalog.h"
 #include "lib/exceptions.h"
+#include "lib/iterator_range.h"
 #include "lib/log.h"
 #include "lib/null.h"
 #include "lib/ordered_map.h"
@@ -259,8 +260,16 @@ const IR::CompileTimeValue *InstantiatedBlock::findParameterValue(cstring paramN
 }
 
 Util::Enumerator<const IDeclaration *> *P4Program::getDeclarations() const {
-    return objects.getEnumerator()->as<const IDeclaration *>()->where(
-        [](const IDeclaration *d) { return d != nullptr; });
+    auto decls = Util::only<const IDeclaration *>(objects);
+    return Util::Enumerator<const IDeclaration *>::createEnumerator(decls.begin(), decls.end());
+}
+
+const std::vector<const IDeclaration *> &P4Program::getDeclarationsByName(cstring name) const {
+    return declarationIndex.lookup(objects, name);
+}
+
+Util::Enumerator<const IDeclaration *> *P4Program::getDeclsByName(cstring name) const {
+    return Util::Enumerator<const IDeclaration *>::createEnumerator(getDeclarationsByName(name));
 }
 
 const IR::PackageBlock *ToplevelBlock::getMain() const {
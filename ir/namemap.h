@@ -20,12 +20,15 @@ limitations under the License.
 #include <map>
 
 #include "ir/node.h"
+#include "ir/structural_hash.h"
 #include "lib/cstring.h"
 #include "lib/enumerator.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
+#include "lib/iterator_range.h"
 
 class JSONLoader;
+class BinaryLoader;
 
 namespace IR {
 
@@ -52,6 +55,7 @@ class NameMap : public Node {
     NameMap(const NameMap &) = default;
     NameMap(NameMap &&) = default;
     explicit NameMap(JSONLoader &);
+    explicit NameMap(BinaryLoader &);
     NameMap &operator=(const NameMap &) = default;
     NameMap &operator=(NameMap &&) = default;
     typedef typename map_t::value_type value_type;
@@ -141,12 +145,22 @@ class NameMap : public Node {
             if (el.first != it->first || !el.second->equiv(*(it++)->second)) return false;
         return true;
     }
+    size_t computeStructuralHash() const override {
+        size_t hash = Node::computeStructuralHash();
+        for (auto &el : *this) {
+            hashField(hash, el.first);
+            hashField(hash, el.second);
+        }
+        return hash;
+    }
     cstring node_type_name() const override { return "NameMap<" + T::static_type_name() + ">"; }
     static cstring static_type_name() { return "NameMap<" + T::static_type_name() + ">"; }
     void visit_children(Visitor &v) override;
     void visit_children(Visitor &v) const override;
     void toJSON(JSONGenerator &json) const override;
     static NameMap<T, MAP, COMP, ALLOC> *fromJSON(JSONLoader &json);
+    void toBinary(BinaryGenerator &binary) const override;
+    static NameMap<T, MAP, COMP, ALLOC> *fromBinary(BinaryLoader &binary);
 
     Util::Enumerator<const T *> *valueEnumerator() const {
         return Util::Enumerator<const T *>::createEnumerator(Values(symbols).begin(),
@@ -154,8 +168,8 @@ class NameMap : public Node {
     }
     template <typename S>
     Util::Enumerator<const S *> *only() const {
-        std::function<bool(const T *)> filter = [](const T *d) { return d->template is<S>(); };
-        return valueEnumerator()->where(filter)->template as<const S *>();
+        auto range = Util::only<const S *>(Values(symbols));
+        return Util::Enumerator<const S *>::createEnumerator(range.begin(), range.end());
     }
 };
 
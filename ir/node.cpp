@@ -24,10 +24,13 @@ limitations under the License.
 // use in combination with "raise" below
 // #include <csignal>
 
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
 #include "ir/declaration.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
+#include "ir/structural_hash.h"
 #include "ir/visitor.h"
 #include "lib/indent.h"
 #include "lib/json.h"
@@ -49,6 +52,27 @@ void IR::Node::traceCreation() const {
 
 int IR::Node::currentId = 0;
 
+size_t IR::Node::structuralHash() const {
+    if (auto *memo = StructuralHashMemo::current) return memo->hash(this);
+    return computeStructuralHash();
+}
+
+size_t IR::Node::computeStructuralHash() const { return typeid(*this).hash_code(); }
+
+thread_local IR::StructuralHashMemo *IR::StructuralHashMemo::current = nullptr;
+
+size_t IR::StructuralHashMemo::hash(const Node *node) {
+    auto it = hashes.find(node);
+    if (it != hashes.end()) return it->second;
+    auto *outer = current;
+    current = this;
+    size_t hash = node->computeStructuralHash();
+    current = outer;
+    ++computed;
+    hashes.emplace(node, hash);
+    return hash;
+}
+
 void IR::Node::toJSON(JSONGenerator &json) const {
     json << json.indent << "\"Node_ID\" : " << id << "," << std::endl
          << json.indent << "\"Node_Type\" : " << node_type_name();
@@ -63,6 +87,17 @@ IR::Node::Node(JSONLoader &json) : id(-1) {
     clone_id = id;
 }
 
+void IR::Node::toBinary(BinaryGenerator &binary) const { binary.generateId(id); }
+
+IR::Node::Node(BinaryLoader &binary) : id(-1) {
+    binary >> id;
+    if (id < 0)
+        id = currentId++;
+    else if (id >= currentId)
+        currentId = id + 1;
+    clone_id = id;
+}
+
 // Abbreviated debug print
 cstring IR::dbp(const IR::INode *node) {
     std::stringstream str;
@@ -158,4 +193,20 @@ void IR::Node::sourceInfoToJSON(JSONGenerator &json) const {
     json << --json.indent << "}";
 }
 
+void IR::Node::sourceInfoToBinary(BinaryGenerator &binary) const {
+    Util::SourceInfo si = srcInfo;
+    unsigned lineNumber, columnNumber;
+    cstring fName = prepareSourceInfoForJSON(si, &lineNumber, &columnNumber);
+    if (fName != nullptr) {
+        binary << true << fName << lineNumber << columnNumber
+               << si.toBriefSourceFragment().escapeJson();
+    } else if (si.line != -1) {
+        // The source info read with the node.
+        binary << true << srcInfo.filename << static_cast<unsigned>(srcInfo.line)
+               << static_cast<unsigned>(srcInfo.column) << srcInfo.srcBrief;
+    } else {
+        binary << false;
+    }
+}
+
 IRNODE_DEFINE_APPLY_OVERLOAD(Node, , )
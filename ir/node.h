@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef IR_NODE_H_
 #define IR_NODE_H_
 
+#include <cstddef>
 #include <iosfwd>
 #include <typeinfo>
 
@@ -34,6 +35,8 @@ class Modifier;
 class Transform;
 class JSONGenerator;
 class JSONLoader;
+class BinaryGenerator;
+class BinaryLoader;
 
 namespace Util {
 class JsonObject;
@@ -57,6 +60,7 @@ class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable
     virtual void dbprint(std::ostream &out) const = 0;  // for debugging
     virtual cstring toString() const = 0;               // for user consumption
     virtual void toJSON(JSONGenerator &) const = 0;
+    virtual void toBinary(BinaryGenerator &) const = 0;
     virtual cstring node_type_name() const = 0;
     virtual void validate() const {}
     virtual const Annotation *getAnnotation(cstring) const { return nullptr; }
@@ -115,6 +119,9 @@ class Node : public virtual INode {
         traceCreation();
     }
     virtual ~Node() {}
+    // Gives a node loaded from a file written by another compilation a fresh id, so that
+    // it does not clash with the ids of the nodes created by this one.
+    void renumber() { id = clone_id = currentId++; }
     const Node *apply(Visitor &v, const Visitor_Context *ctxt = nullptr) const;
     const Node *apply(Visitor &&v, const Visitor_Context *ctxt = nullptr) const {
         return apply(v, ctxt);
@@ -132,6 +139,9 @@ class Node : public virtual INode {
     cstring toString() const override { return node_type_name(); }
     void toJSON(JSONGenerator &json) const override;
     void sourceInfoToJSON(JSONGenerator &json) const;
+    explicit Node(BinaryLoader &binary);
+    void toBinary(BinaryGenerator &binary) const override;
+    void sourceInfoToBinary(BinaryGenerator &binary) const;
     Util::JsonObject *sourceInfoJsonObj() const;
     /* operator== does a 'shallow' comparison, comparing two Node subclass objects for equality,
      * and comparing pointers in the Node directly for equality */
@@ -139,6 +149,13 @@ class Node : public virtual INode {
     /* 'equiv' does a deep-equals comparison, comparing all non-pointer fields and recursing
      * though all Node subclass pointers to compare them with 'equiv' as well. */
     virtual bool equiv(const Node &a) const { return typeid(*this) == typeid(a); }
+    /* 'structuralHash' is consistent with 'equiv': nodes that are equiv have the same hash.
+     * Like 'equiv', it visits the whole subtree; nodes do not store their hash, so users that
+     * hash the same nodes repeatedly should hash them through a StructuralHashMemo, which the
+     * hashes of the children then also go through.  'computeStructuralHash' is generated for
+     * all IR classes from the fields that 'equiv' compares. */
+    size_t structuralHash() const;
+    virtual size_t computeStructuralHash() const;
 #define DEFINE_OPEQ_FUNC(CLASS, BASE) \
     virtual bool operator==(const CLASS &) const { return false; }
     IRNODE_ALL_SUBCLASSES(DEFINE_OPEQ_FUNC)
@@ -18,6 +18,7 @@ limitations under the License.
 #define IR_NODEMAP_H_
 
 #include "ir/node.h"
+#include "ir/structural_hash.h"
 #include "lib/cstring.h"
 
 namespace IR {
@@ -85,6 +86,15 @@ class NodeMap : public Node {
             if (el.first != it->first || !el.second->equiv(*(it++)->second)) return false;
         return true;
     }
+    size_t computeStructuralHash() const override {
+        // Keys are compared by identity.
+        size_t hash = Node::computeStructuralHash();
+        for (auto &el : *this) {
+            hashCombine(hash, std::hash<const void *>()(el.first));
+            hashField(hash, el.second);
+        }
+        return hash;
+    }
     cstring node_type_name() const override {
         return "NodeMap<" + KEY::static_type_name() + "," + VALUE::static_type_name() + ">";
     }
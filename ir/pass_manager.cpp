@@ -16,21 +16,26 @@ limitations under the License.
 
 #include "pass_manager.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility>
 
 #include "ir/dump.h"
 #include "ir/node.h"
+#include "ir/pass_result_cache.h"
 #include "ir/visitor.h"
 #include "lib/error.h"
 #include "lib/gc.h"
 #include "lib/indent.h"
 #include "lib/log.h"
 #include "lib/n4.h"
+#include "lib/timer.h"
 
 void PassManager::removePasses(const std::vector<cstring> &exclude) {
     for (auto it : exclude) {
@@ -68,8 +73,34 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
 
     early_exit_flag = false;
     unsigned initial_error_count = ::errorCount();
+    unsigned initial_diagnostic_count = ::diagnosticCount();
     BUG_CHECK(running, "not calling apply properly");
-    for (auto it = passes.begin(); it != passes.end();) {
+    auto it = passes.begin();
+    cstring cacheKey;
+    PassResultCache::Sources cacheSources;
+    if (resultCache) {
+        auto checkpoint = std::find_if(passes.begin(), passes.end(), [this](Visitor *v) {
+            return cacheCheckpoint == v->name();
+        });
+        BUG_CHECK(checkpoint != passes.end(), "%1%: no pass %2% to cache the result of", name(),
+                  cacheCheckpoint);
+        std::stringstream context;
+        context << cacheContext << '\0';
+        listPasses(context, ",");
+        cacheKey = resultCache->key(program, cacheCheckpoint, context.str(), cacheSources);
+        if (auto *cached = resultCache->load(cacheKey, cacheSources)) {
+            LOG1(log_indent << name() << " using the cached result of " << cacheCheckpoint);
+            program = cached;
+            for (auto *v : cacheHitPasses) {
+                if ((program = program->apply(*v)) == nullptr) break;
+            }
+            cacheKey = nullptr;
+            it = std::next(checkpoint);
+            seqNo += it - passes.begin();
+            if (program == nullptr || ::errorCount() > initial_error_count) it = passes.end();
+        }
+    }
+    for (; it != passes.end();) {
         Visitor *v = *it;
         if (auto b = dynamic_cast<Backtrack *>(v)) {
             if (!b->never_backtracks()) {
@@ -80,6 +111,7 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
                 auto after = program->apply(**it);
+                Util::incrementCounter("passes");
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " << n4(mem)
@@ -110,6 +142,11 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
             continue;
         }
         runDebugHooks(v->name(), program);
+        if (cacheKey && cacheCheckpoint == v->name()) {
+            if (::diagnosticCount() == initial_diagnostic_count)
+                resultCache->store(cacheKey, program, cacheSources);
+            cacheKey = nullptr;
+        }
         if (early_exit_flag) break;
         seqNo++;
         it++;
@@ -20,7 +20,9 @@ limitations under the License.
 #include <functional>
 #include <initializer_list>
 #include <iosfwd>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "ir/node.h"
@@ -33,6 +35,8 @@ typedef std::function<void(const char *manager, unsigned seqNo, const char *pass
                            const IR::Node *node)>
     DebugHook;
 
+class PassResultCache;
+
 class PassManager : virtual public Visitor, virtual public Backtrack {
     bool early_exit_flag = false;
     mutable int never_backtracks_cache = -1;
@@ -44,6 +48,11 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     bool stop_on_error = true;
     bool running = false;
     unsigned seqNo = 0;
+    // optional cache of the result of the passes up to a checkpoint pass
+    PassResultCache *resultCache = nullptr;
+    cstring cacheCheckpoint;
+    std::string cacheContext;
+    safe_vector<Visitor *> cacheHitPasses;
     void runDebugHooks(const char *visitorName, const IR::Node *node);
     profile_t init_apply(const IR::Node *root) override {
         running = true;
@@ -117,6 +126,24 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
                     child->addDebugHooks(hooks, recursive);
     }
     void early_exit() { early_exit_flag = true; }
+    /// Caches the IR produced by the passes up to and including the pass named @p checkpoint
+    /// in @p cache.  When the cache has a result for the same input IR, context and pass
+    /// list, it is used instead of running these passes, and the @p onHit passes are run on
+    /// it to rebuild whatever state later passes or callers need (e.g. the evaluator).
+    /// @p context must describe everything else the passes depend on, such as the options.
+    /// Results are only stored when the passes reported no errors or warnings, so using a
+    /// cached result never loses diagnostics, and keep their source positions, so later
+    /// diagnostics do not change either.  Passes with debug hooks that produce output
+    /// should not be cached, since they are not run on a hit.
+    void cacheResults(PassResultCache *cache, cstring checkpoint, std::string context,
+                      const std::initializer_list<VisitorRef> &onHit = {}) {
+        resultCache = cache;
+        cacheCheckpoint = checkpoint;
+        cacheContext = std::move(context);
+        cacheHitPasses.clear();
+        for (auto &p : onHit)
+            if (p.visitor) cacheHitPasses.emplace_back(p.visitor);
+    }
     PassManager *clone() const override { return new PassManager(*this); }
 };
 
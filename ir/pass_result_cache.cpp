@@ -0,0 +1,92 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_result_cache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ir/binary_ir.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+#include "lib/path.h"
+
+namespace {
+
+cstring fileName(cstring dir, cstring key) {
+    return Util::PathName(dir).join(key + ".p4ir").toString();
+}
+
+}  // namespace
+
+cstring PassResultCache::key(const IR::Node *input, cstring checkpoint,
+                             const std::string &context, Sources &sources) const {
+    std::stringstream data;
+    data << checkpoint << '\0' << binaryIRVersion << '\0' << context << '\0';
+    // The positions of the input are part of the key, so the positions of a result are valid
+    // in the input sources of any input with the same key.  Node ids are left out: they differ
+    // between compilations of the same input.
+    sources = inputSourcesOf(input);
+    writeBinaryIR(data, input, true, &sources, false);
+    auto bytes = data.str();
+    // Two independent 64 bit hashes make collisions, which would silently produce wrong
+    // output, unlikely enough even for a cache shared by many compilations.
+    char digest[40];
+    snprintf(digest, sizeof(digest), "%016llx%016llx",
+             static_cast<unsigned long long>(Util::Hash::fnv1a(bytes.data(), bytes.size())),
+             static_cast<unsigned long long>(Util::Hash::murmur(bytes.data(), bytes.size())));
+    return checkpoint + "-" + digest;
+}
+
+const IR::Node *PassResultCache::load(cstring key, const Sources &sources) const {
+    auto file = fileName(dir, key);
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) return nullptr;
+    LOG2("Loading cached result " << file);
+    return loadBinaryIR(file, true, &sources);
+}
+
+void PassResultCache::store(cstring key, const IR::Node *result, const Sources &sources) const {
+    // Nodes created from other input sources, e.g. by parsing annotations, would lose their
+    // position in a loaded result.
+    for (auto *s : inputSourcesOf(result)) {
+        if (std::find(sources.begin(), sources.end(), s) == sources.end()) {
+            LOG2("Not caching a result with positions in other input sources");
+            return;
+        }
+    }
+    auto file = fileName(dir, key);
+    // Write to a temporary file first, so concurrent compilations never see a partial entry.
+    auto tmpName = file + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmpName.c_str(), std::ios::binary);
+        if (out) writeBinaryIR(out, result, true, &sources);
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "%1%: could not write pass cache entry", tmpName);
+            return;
+        }
+    }
+    if (rename(tmpName.c_str(), file.c_str()) != 0) {
+        ::warning(ErrorType::WARN_FAILED, "%1%: could not write pass cache entry", file);
+        unlink(tmpName.c_str());
+        return;
+    }
+    LOG2("Stored cached result " << file);
+}
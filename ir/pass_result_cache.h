@@ -0,0 +1,63 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_PASS_RESULT_CACHE_H_
+#define IR_PASS_RESULT_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+
+namespace IR {
+class Node;
+}  // namespace IR
+
+namespace Util {
+class InputSources;
+}  // namespace Util
+
+/**
+An on-disk cache of the IR produced by a sequence of passes, used by PassManager::cacheResults.
+Entries are content addressed: the key of an entry is a hash of the input IR (including its
+source positions), of the name of the last pass of the sequence and of a context string that
+must describe everything else the passes depend on (compiler version, options, pass list).
+Entries are stored in the binary IR format and are written atomically, so concurrent
+compilations can share a cache directory.  Stale entries are never removed.
+
+The nodes of an entry keep their source positions, as indexes in the input sources of the
+input IR, so that diagnostics reported on a loaded result are the same as on a computed one.
+*/
+class PassResultCache {
+    cstring dir;
+
+ public:
+    /// The input sources of an input IR, which the positions of cached results refer to.
+    using Sources = std::vector<const Util::InputSources *>;
+
+    explicit PassResultCache(cstring dir) : dir(dir) {}
+
+    /// @returns the key of the IR produced from @p input by the passes up to @p checkpoint,
+    /// and sets @p sources to the input sources of @p input.
+    cstring key(const IR::Node *input, cstring checkpoint, const std::string &context,
+                Sources &sources) const;
+    /// @returns the IR stored for @p key, with fresh node ids and source positions in
+    /// @p sources, or nullptr if there is none.
+    const IR::Node *load(cstring key, const Sources &sources) const;
+    /// Stores @p result for @p key.  Results with source positions outside of @p sources
+    /// are not stored; failures to write the cache are only warnings.
+    void store(cstring key, const IR::Node *result, const Sources &sources) const;
+};
+
+#endif /* IR_PASS_RESULT_CACHE_H_ */
@@ -0,0 +1,143 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_STRUCTURAL_HASH_H_
+#define IR_STRUCTURAL_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "ir/id.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/cstring.h"
+
+namespace IR {
+
+/// Mixes @p value into @p hash.
+inline void hashCombine(size_t &hash, size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+}
+
+/// Mixes a field of a node into the structural hash @p hash of the node. The generated
+/// computeStructuralHash methods call this for every field that equiv compares. Fields of
+/// other types than the ones below do not contribute to the hash, which keeps it consistent
+/// with equiv.
+template <class T>
+void hashField(size_t &hash, const T &value) {
+    if constexpr (std::is_convertible_v<const T &, const Node *>) {
+        hashCombine(hash, value ? value->structuralHash() : 0);
+    } else if constexpr (std::is_convertible_v<const T &, const INode *>) {
+        hashCombine(hash, value ? value->getNode()->structuralHash() : 0);
+    } else if constexpr (std::is_base_of_v<Node, T>) {
+        hashCombine(hash, value.structuralHash());
+    } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        hashCombine(hash, std::hash<T>()(value));
+    } else if constexpr (std::is_same_v<T, cstring>) {
+        hashCombine(hash, std::hash<cstring>()(value));
+    } else if constexpr (std::is_same_v<T, ID>) {
+        // IDs compare by name only.
+        hashCombine(hash, std::hash<cstring>()(value.name));
+    } else if constexpr (std::is_same_v<T, big_int>) {
+        // Values beyond 64 bits are hashed by their conversion to 64 bits.
+        hashCombine(hash, std::hash<int64_t>()(value.template convert_to<int64_t>()));
+    }
+}
+
+/// Remembers the structural hashes of the nodes it hashed. While it hashes a node, the hashes
+/// of the children of the node also go through it, so hashing a node whose children were hashed
+/// before only visits the fields of the node itself. Nodes must not be modified while their hash
+/// is remembered.
+class StructuralHashMemo {
+    std::unordered_map<const Node *, size_t> hashes;
+    /// The number of nodes whose hash was computed.
+    size_t computed = 0;
+
+    /// The memo that Node::structuralHash goes through, if any.
+    static thread_local StructuralHashMemo *current;
+    friend class Node;
+
+ public:
+    StructuralHashMemo() = default;
+    StructuralHashMemo(const StructuralHashMemo &) = delete;
+    StructuralHashMemo &operator=(const StructuralHashMemo &) = delete;
+
+    size_t hash(const Node *node);
+
+    size_t computedCount() const { return computed; }
+    size_t size() const { return hashes.size(); }
+    void clear() { hashes.clear(); }
+};
+
+/// Hash and equality on the structure of nodes, for unordered containers of nodes. With a
+/// memo, repeated hashes of the same nodes, and of their children, are not computed again.
+struct StructuralHash {
+    StructuralHashMemo *memo = nullptr;
+
+    StructuralHash() = default;
+    explicit StructuralHash(StructuralHashMemo *memo) : memo(memo) {}
+    size_t operator()(const Node *node) const {
+        if (!node) return 0;
+        return memo ? memo->hash(node) : node->structuralHash();
+    }
+};
+struct StructuralEquiv {
+    bool operator()(const Node *a, const Node *b) const { return equiv(a, b); }
+};
+
+/// Shares structurally identical nodes: intern returns the first node interned that is equiv to
+/// its argument. This is meant for immutable expressions (constants, members, operations) that
+/// are created many times over, e.g. in symbolic execution. equiv ignores source positions, so
+/// nodes whose source position matters, e.g. for error messages, should not be interned.
+/// Interned nodes must not be modified.
+class HashConsTable {
+    StructuralHashMemo hashes;
+    std::unordered_set<const Node *, StructuralHash, StructuralEquiv> nodes{
+        0, StructuralHash(&hashes)};
+
+ public:
+    HashConsTable() = default;
+    HashConsTable(const HashConsTable &) = delete;
+    HashConsTable &operator=(const HashConsTable &) = delete;
+
+    /// @returns the interned node that is equiv to @p node, interning @p node if there is none.
+    template <class T>
+    const T *intern(const T *node) {
+        // equiv compares the dynamic types of nodes, so the interned node is also a T.
+        return static_cast<const T *>(*nodes.insert(node).first);
+    }
+
+    /// Creates a T from @p args and returns the interned node that is equiv to it.
+    template <class T, class... Args>
+    const T *make(Args &&...args) {
+        return intern(new T(std::forward<Args>(args)...));
+    }
+
+    size_t size() const { return nodes.size(); }
+    void clear() {
+        nodes.clear();
+        hashes.clear();
+    }
+    /// The memo of the structural hashes of the nodes interned so far.
+    const StructuralHashMemo &hashMemo() const { return hashes; }
+};
+
+}  // namespace IR
+
+#endif /* IR_STRUCTURAL_HASH_H_ */
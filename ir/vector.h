@@ -19,11 +19,14 @@ limitations under the License.
 
 #include "ir/dbprint.h"
 #include "ir/node.h"
+#include "ir/structural_hash.h"
 #include "lib/enumerator.h"
+#include "lib/iterator_range.h"
 #include "lib/null.h"
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryLoader;
 
 namespace IR {
 
@@ -47,6 +50,7 @@ class VectorBase : public Node {
 
  protected:
     explicit VectorBase(JSONLoader &json) : Node(json) {}
+    explicit VectorBase(BinaryLoader &binary) : Node(binary) {}
 };
 
 // This class should only be used in the IR.
@@ -55,49 +59,92 @@ template <class T>
 class Vector : public VectorBase {
     safe_vector<const T *> vec;
 
+    /// Incremented by every non-const access, as it may modify the elements.
+    size_t revisions = 0;
+
  public:
     typedef const T *value_type;
     Vector() = default;
     Vector(const Vector &) = default;
     Vector(Vector &&) = default;
     explicit Vector(JSONLoader &json);
-    Vector &operator=(const Vector &) = default;
-    Vector &operator=(Vector &&) = default;
+    explicit Vector(BinaryLoader &binary);
+    Vector &operator=(const Vector &a) {
+        VectorBase::operator=(a);
+        vec = a.vec;
+        revisions++;
+        return *this;
+    }
+    Vector &operator=(Vector &&a) {
+        VectorBase::operator=(std::move(a));
+        vec = std::move(a.vec);
+        revisions++;
+        return *this;
+    }
     explicit Vector(const T *a) { vec.emplace_back(std::move(a)); }
     explicit Vector(const safe_vector<const T *> &a) { vec.insert(vec.end(), a.begin(), a.end()); }
     Vector(const std::initializer_list<const T *> &a) : vec(a) {}
     static Vector<T> *fromJSON(JSONLoader &json);
+    static Vector<T> *fromBinary(BinaryLoader &binary);
     typedef typename safe_vector<const T *>::iterator iterator;
     typedef typename safe_vector<const T *>::const_iterator const_iterator;
-    iterator begin() { return vec.begin(); }
+    iterator begin() {
+        revisions++;
+        return vec.begin();
+    }
     const_iterator begin() const { return vec.begin(); }
     VectorBase::iterator VectorBase_begin() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
         return reinterpret_cast<VectorBase::iterator>(&vec[0]);
     }
-    iterator end() { return vec.end(); }
+    iterator end() {
+        revisions++;
+        return vec.end();
+    }
     const_iterator end() const { return vec.end(); }
     VectorBase::iterator VectorBase_end() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
         return reinterpret_cast<VectorBase::iterator>(&vec[0] + vec.size());
     }
-    std::reverse_iterator<iterator> rbegin() { return vec.rbegin(); }
+    std::reverse_iterator<iterator> rbegin() {
+        revisions++;
+        return vec.rbegin();
+    }
     std::reverse_iterator<const_iterator> rbegin() const { return vec.rbegin(); }
-    std::reverse_iterator<iterator> rend() { return vec.rend(); }
+    std::reverse_iterator<iterator> rend() {
+        revisions++;
+        return vec.rend();
+    }
     std::reverse_iterator<const_iterator> rend() const { return vec.rend(); }
     size_t size() const override { return vec.size(); }
-    void resize(size_t sz) { vec.resize(sz); }
+    void resize(size_t sz) {
+        revisions++;
+        vec.resize(sz);
+    }
     bool empty() const override { return vec.empty(); }
     const T *const &front() const { return vec.front(); }
-    const T *&front() { return vec.front(); }
-    void clear() { vec.clear(); }
-    iterator erase(iterator i) { return vec.erase(i); }
-    iterator erase(iterator s, iterator e) { return vec.erase(s, e); }
+    const T *&front() {
+        revisions++;
+        return vec.front();
+    }
+    void clear() {
+        revisions++;
+        vec.clear();
+    }
+    iterator erase(iterator i) {
+        revisions++;
+        return vec.erase(i);
+    }
+    iterator erase(iterator s, iterator e) {
+        revisions++;
+        return vec.erase(s, e);
+    }
     template <typename ForwardIter>
     iterator insert(iterator i, ForwardIter b, ForwardIter e) {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
         int index = i - vec.begin();
+        revisions++;
         vec.insert(i, b, e);
         return vec.begin() + index;
     }
@@ -131,6 +178,7 @@ class Vector : public VectorBase {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
         int index = i - vec.begin();
+        revisions++;
         vec.insert(i, v);
         return vec.begin() + index;
     }
@@ -138,27 +186,51 @@ class Vector : public VectorBase {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
         int index = i - vec.begin();
+        revisions++;
         vec.insert(i, n, v);
         return vec.begin() + index;
     }
 
     const T *const &operator[](size_t idx) const { return vec[idx]; }
-    const T *&operator[](size_t idx) { return vec[idx]; }
+    const T *&operator[](size_t idx) {
+        revisions++;
+        return vec[idx];
+    }
     const T *const &at(size_t idx) const { return vec.at(idx); }
-    const T *&at(size_t idx) { return vec.at(idx); }
+    const T *&at(size_t idx) {
+        revisions++;
+        return vec.at(idx);
+    }
     template <class... Args>
     void emplace_back(Args &&...args) {
+        revisions++;
         vec.emplace_back(new T(std::forward<Args>(args)...));
     }
-    void push_back(T *a) { vec.push_back(a); }
-    void push_back(const T *a) { vec.push_back(a); }
-    void pop_back() { vec.pop_back(); }
+    void push_back(T *a) {
+        revisions++;
+        vec.push_back(a);
+    }
+    void push_back(const T *a) {
+        revisions++;
+        vec.push_back(a);
+    }
+    void pop_back() {
+        revisions++;
+        vec.pop_back();
+    }
     const T *const &back() const { return vec.back(); }
-    const T *&back() { return vec.back(); }
+    const T *&back() {
+        revisions++;
+        return vec.back();
+    }
     template <class U>
     void push_back(U &a) {
+        revisions++;
         vec.push_back(a);
     }
+    /// @returns a number that changes whenever the elements may have been modified. Writes
+    /// through a reference or an iterator only count when it is obtained.
+    size_t revision() const { return revisions; }
     void check_null() const {
         for (auto e : vec) CHECK_NULL(e);
     }
@@ -191,6 +263,11 @@ class Vector : public VectorBase {
             if (!el->equiv(**it++)) return false;
         return true;
     }
+    size_t computeStructuralHash() const override {
+        size_t hash = Node::computeStructuralHash();
+        for (auto *el : *this) hashField(hash, el);
+        return hash;
+    }
     cstring node_type_name() const override { return "Vector<" + T::static_type_name() + ">"; }
     static cstring static_type_name() { return "Vector<" + T::static_type_name() + ">"; }
     void visit_children(Visitor &v) override;
@@ -198,13 +275,14 @@ class Vector : public VectorBase {
     virtual void parallel_visit_children(Visitor &v);
     virtual void parallel_visit_children(Visitor &v) const;
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryGenerator &binary) const override;
     Util::Enumerator<const T *> *getEnumerator() const {
         return Util::Enumerator<const T *>::createEnumerator(vec);
     }
     template <typename S>
     Util::Enumerator<const S *> *only() const {
-        std::function<bool(const T *)> filter = [](const T *d) { return d->template is<S>(); };
-        return getEnumerator()->where(filter)->template as<const S *>();
+        auto range = Util::only<const S *>(vec);
+        return Util::Enumerator<const S *>::createEnumerator(range.begin(), range.end());
     }
 };
 
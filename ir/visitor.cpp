@@ -19,6 +19,16 @@ limitations under the License.
 #include <stdlib.h>
 #include <time.h>
 
+#include <algorithm>
+#include <memory>
+#ifdef MULTITHREAD
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
+#include <vector>
+
 #include "ir/ir-generated.h"
 #include "lib/source_file.h"
 
@@ -27,12 +37,14 @@ limitations under the License.
 #endif
 
 #include "dbprint.h"
+#include "ir/dense_node_map.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/ir.h"
 #include "ir/vector.h"
 #include "lib/algorithm.h"
 #include "lib/error_catalog.h"
+#include "lib/gc.h"
 #include "lib/indent.h"
 #include "lib/log.h"
 #include "lib/map.h"
@@ -51,7 +63,7 @@ class Visitor::ChangeTracker {
         bool visitOnce;
         const IR::Node *result;
     };
-    typedef std::unordered_map<const IR::Node *, visit_info_t> visited_t;
+    typedef IR::DenseNodeMap<visit_info_t> visited_t;
     visited_t visited;
 
  public:
@@ -60,15 +72,14 @@ class Visitor::ChangeTracker {
      */
     void start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        visited_t::iterator visited_it;
+        visit_info_t *visit_info;
         bool inserted;
         bool visit_in_progress = true;
-        std::tie(visited_it, inserted) =
+        std::tie(visit_info, inserted) =
             visited.emplace(n, visit_info_t{visit_in_progress, defaultVisitOnce, n});
 
         // Sanity check for IR loops
         bool already_present = !inserted;
-        visit_info_t *visit_info = &(visited_it->second);
         if (already_present && visit_info->visit_in_progress) BUG("IR loop detected ");
     }
 
@@ -86,10 +97,9 @@ class Visitor::ChangeTracker {
      * previously been invoked.
      */
     bool finish(const IR::Node *orig, const IR::Node *final) {
-        auto it = visited.find(orig);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        visit_info_t *orig_visit_info = visited.find(orig);
+        if (!orig_visit_info) BUG("visitor state tracker corrupted");
 
-        visit_info_t *orig_visit_info = &(it->second);
         orig_visit_info->visit_in_progress = false;
         if (!final) {
             orig_visit_info->result = final;
@@ -114,29 +124,29 @@ class Visitor::ChangeTracker {
     /** Return a pointer to the visitOnce flag for node @n so that it can be changed
      */
     bool *refVisitOnce(const IR::Node *n) {
-        if (!visited.count(n)) BUG("visitor state tracker corrupted");
-        return &visited.at(n).visitOnce;
+        visit_info_t *visit_info = visited.find(n);
+        if (!visit_info) BUG("visitor state tracker corrupted");
+        return &visit_info->visitOnce;
     }
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (!it->second.visit_in_progress)
-                it = visited.erase(it);
-            else
-                ++it;
-        }
+        visited.erase_if(
+            [](const IR::Node *, const visit_info_t &info) { return !info.visit_in_progress; });
     }
 
+    /** Forget all nodes, keeping the storage for the next traversal. */
+    void clear() { visited.clear(); }
+
     /** Determine whether @n is currently being visited and the visitor has not finished
      * That is, `start(@n)` has been invoked, and `finish(@n)` has not,
      *
      * @return true if @n is being visited and has not finished
      */
     bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.visit_in_progress;
+        const visit_info_t *visit_info = visited.find(n);
+        return visit_info && visit_info->visit_in_progress;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -147,8 +157,8 @@ class Visitor::ChangeTracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
+        const visit_info_t *visit_info = visited.find(n);
+        return visit_info && !visit_info->visit_in_progress && visit_info->visitOnce;
     }
 
     /** Produce the result of visiting @n.
@@ -158,11 +168,49 @@ class Visitor::ChangeTracker {
      * if `start(@n)` has not been invoked.
      */
     const IR::Node *result(const IR::Node *n) const {
-        if (!visited.count(n)) return n;
-        return visited.at(n).result;
+        const visit_info_t *visit_info = visited.find(n);
+        if (!visit_info) return n;
+        return visit_info->result;
     }
 };
 
+namespace {
+
+/// The most tables of each kind that are kept for reuse. Nested visitors need a table each.
+constexpr size_t MAX_POOLED_VISITED_TABLES = 4;
+
+/** Create a table for tracking the nodes visited by a traversal.  When the traversal is done,
+ *  the table is cleared and kept for a later traversal, so its pages are only allocated once.
+ */
+template <class Table>
+std::shared_ptr<Table> makeVisitedTable() {
+    // Never destroyed: visitors with static storage duration may be destroyed after the pool.
+    static auto *pool = new std::vector<Table *>;
+#ifdef MULTITHREAD
+    static auto *lock = new std::mutex;
+    std::lock_guard<std::mutex> acquire(*lock);
+#endif  // MULTITHREAD
+    Table *table = nullptr;
+    if (!pool->empty()) {
+        table = pool->back();
+        pool->pop_back();
+    } else {
+        table = new Table;
+    }
+    return std::shared_ptr<Table>(table, [](Table *released) {
+        released->clear();
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(*lock);
+#endif  // MULTITHREAD
+        if (pool->size() < MAX_POOLED_VISITED_TABLES)
+            pool->push_back(released);
+        else
+            delete released;
+    });
+}
+
+}  // namespace
+
 // static
 bool Visitor::warning_enabled(const Visitor *visitor, int warning_kind) {
     auto errorString = ErrorCatalog::getCatalog().getName(warning_kind);
@@ -196,23 +244,24 @@ Visitor::profile_t Visitor::init_apply(const IR::Node *root, const Context *pare
 }
 Visitor::profile_t Modifier::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<ChangeTracker>();
+    visited = makeVisitedTable<ChangeTracker>();
     return rv;
 }
 Visitor::profile_t Inspector::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<visited_t>();
+    visited = makeVisitedTable<visited_t>();
     return rv;
 }
 Visitor::profile_t Transform::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<ChangeTracker>();
+    visited = makeVisitedTable<ChangeTracker>();
     return rv;
 }
 void Visitor::end_apply() {}
 void Visitor::end_apply(const IR::Node *) {}
 
-static indent_t profile_indent;
+// Visitors on other threads, e.g. the workers of ParallelInspector, indent on their own.
+static thread_local indent_t profile_indent;
 static uint64_t first_start = 0;
 Visitor::profile_t::profile_t(Visitor &v_) : v(v_) {
     struct timespec ts;
@@ -347,20 +396,20 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
     if (n && !join_flows(n)) {
         PushContext local(ctxt, n);
         auto vp = visited->emplace(n, info_t{false, visitDagOnce});
-        if (!vp.second && !vp.first->second.done) {
+        if (!vp.second && !vp.first->done) {
             n->apply_visitor_loop_revisit(*this);
-        } else if (!vp.second && vp.first->second.visitOnce) {
+        } else if (!vp.second && vp.first->visitOnce) {
             n->apply_visitor_revisit(*this);
         } else {
-            vp.first->second.done = false;
-            visitCurrentOnce = &vp.first->second.visitOnce;
+            vp.first->done = false;
+            visitCurrentOnce = &vp.first->visitOnce;
             if (n->apply_visitor_preorder(*this)) {
                 n->visit_children(*this);
-                visitCurrentOnce = &vp.first->second.visitOnce;
+                visitCurrentOnce = &vp.first->visitOnce;
                 n->apply_visitor_postorder(*this);
             }
             if (vp.first != visited->find(n)) BUG("visitor state tracker corrupted");
-            vp.first->second.done = true;
+            vp.first->done = true;
         }
         post_join_flows(n, n);
     }
@@ -372,6 +421,104 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
     return n;
 }
 
+unsigned ParallelInspector::maxThreads = 0;
+
+Visitor::profile_t ParallelInspector::init_apply(const IR::Node *root) {
+    applyRoot = root;
+    return Inspector::init_apply(root);
+}
+
+const IR::Node *ParallelInspector::apply_visitor(const IR::Node *n, const char *name) {
+    const auto *program = n != nullptr && n == applyRoot ? n->to<IR::P4Program>() : nullptr;
+    applyRoot = nullptr;
+#ifdef MULTITHREAD
+    unsigned threads = maxThreads ? maxThreads : std::thread::hardware_concurrency();
+#else
+    unsigned threads = 1;
+#endif  // MULTITHREAD
+    if (program == nullptr || threads <= 1 || program->objects.size() < 2)
+        return Inspector::apply_visitor(n, name);
+
+    // Same as Inspector::apply_visitor, except for visiting the declarations.
+    if (ctxt) ctxt->child_name = name;
+    {
+        PushContext local(ctxt, program);
+        auto vp = visited->emplace(program, info_t{false, visitDagOnce});
+        visitCurrentOnce = &vp.first->visitOnce;
+        if (program->apply_visitor_preorder(*this)) {
+            visitDeclarations(program, threads);
+            visitCurrentOnce = &vp.first->visitOnce;
+            program->apply_visitor_postorder(*this);
+        }
+        vp.first->done = true;
+    }
+    if (ctxt)
+        ctxt->child_index++;
+    else
+        visited.reset();
+    return n;
+}
+
+#ifdef MULTITHREAD
+void ParallelInspector::visitDeclarations(const IR::P4Program *program, unsigned threads) {
+    // Chunks are smaller than an even share of each thread, to balance the load.
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+    struct Chunk {
+        ParallelInspector *worker;
+        std::exception_ptr failure;
+    };
+
+    const auto &objects = program->objects;
+    std::vector<Chunk> chunks(std::min(objects.size(), threads * CHUNKS_PER_THREAD));
+    threads = std::min<size_t>(threads, chunks.size());
+    for (auto &chunk : chunks) {
+        chunk.worker = newWorker();
+        chunk.worker->setCalledBy(this);
+    }
+    // Build the declaration index of the program, which is built lazily, before the workers
+    // look up declarations in it.
+    program->getDeclarationsByName(IR::P4Program::main);
+
+    std::atomic<size_t> next = 0;
+    std::atomic<bool> failed = false;
+    bool loggingInContext = Log::Detail::enableLoggingInContext;
+    auto work = [&]() {
+        GCThreadRegistration gcThread;
+        Log::Detail::enableLoggingInContext = loggingInContext;
+        for (size_t c = next++; c < chunks.size() && !failed; c = next++) {
+            auto &chunk = chunks[c];
+            try {
+                // Each worker updates the child index in its own copy of the program context.
+                Context programContext = *ctxt;
+                auto *worker = chunk.worker;
+                auto profile = worker->Visitor::init_apply(program, &programContext);
+                size_t end = (c + 1) * objects.size() / chunks.size();
+                for (size_t i = c * objects.size() / chunks.size(); i < end; i++)
+                    worker->visit(objects[i], nullptr, static_cast<int>(i));
+                worker->end_apply(program);
+                worker->visited.reset();
+            } catch (...) {
+                chunk.failure = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+    enable_gc_threads();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(work);
+    work();
+    for (auto &thread : pool) thread.join();
+
+    for (auto &chunk : chunks)
+        if (chunk.failure) std::rethrow_exception(chunk.failure);
+    for (auto &chunk : chunks) reduce(*chunk.worker);
+}
+#else
+void ParallelInspector::visitDeclarations(const IR::P4Program *, unsigned) {
+    BUG("Parallel visits require MULTITHREAD");
+}
+#endif  // MULTITHREAD
+
 const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
     if (ctxt) ctxt->child_name = name;
     if (n) {
@@ -434,12 +581,7 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
 }
 
 void Inspector::revisit_visited() {
-    for (auto it = visited->begin(); it != visited->end();) {
-        if (it->second.done)
-            it = visited->erase(it);
-        else
-            ++it;
-    }
+    visited->erase_if([](const IR::Node *, const info_t &info) { return info.done; });
 }
 void Modifier::revisit_visited() { visited->revisit_visited(); }
 bool Modifier::visit_in_progress(const IR::Node *n) const { return visited->busy(n); }
@@ -29,6 +29,7 @@ limitations under the License.
 #include <unordered_map>
 #include <utility>
 
+#include "ir/dense_node_map.h"
 #include "ir/gen-tree-macro.h"
 #include "ir/ir-tree-macros.h"
 #include "ir/node.h"
@@ -362,6 +363,7 @@ class Visitor {
     friend class Modifier;
     friend class Transform;
     friend class ControlFlowVisitor;
+    friend class ParallelInspector;
 };
 
 class Modifier : public virtual Visitor {
@@ -391,7 +393,7 @@ class Inspector : public virtual Visitor {
     struct info_t {
         bool done, visitOnce;
     };
-    typedef std::unordered_map<const IR::Node *, info_t> visited_t;
+    typedef IR::DenseNodeMap<info_t> visited_t;
     std::shared_ptr<visited_t> visited;
     bool check_clone(const Visitor *) override;
 
@@ -411,9 +413,53 @@ class Inspector : public virtual Visitor {
 #undef DECLARE_VISIT_FUNCTIONS
     void revisit_visited();
     bool visit_in_progress(const IR::Node *n) const {
-        if (visited->count(n)) return !visited->at(n).done;
-        return false;
+        auto *info = visited->find(n);
+        return info != nullptr && !info->done;
     }
+    friend class ParallelInspector;
+};
+
+/** An Inspector that visits the top-level declarations of a P4Program concurrently.
+ *
+ *  Deriving from ParallelInspector declares that an inspector is thread-safe: its preorder and
+ *  postorder functions only modify the visitor itself, and nothing else they read (the IR,
+ *  reference and type maps, ...) is modified during the traversal.  Several global tables
+ *  are not thread-safe either, so the visit functions must not:
+ *   - report errors or warnings through the error reporter;
+ *   - create cstrings from other strings, which interns them (see lib/cstring.h); copying
+ *     existing cstrings, e.g. node names, is safe;
+ *   - create or clone IR nodes, which increments IR::Node::currentId;
+ *   - call IR::Type_Bits::get or the other functions that intern types.
+ *  An exception thrown by a worker, e.g. by BUG(), is rethrown by apply(), but formatting its
+ *  message interns strings, so it is only safe as a fatal error.
+ *
+ *  When applied to a P4Program, the program itself is visited by this visitor.  Its top-level
+ *  declarations are split into contiguous chunks, and each chunk is visited by a new worker
+ *  from newWorker() on one of a pool of threads.  Once all declarations have been visited,
+ *  reduce() merges the results of the workers into this visitor, in program order.  The
+ *  workers do not share the nodes they have visited, so nodes shared by declarations of
+ *  different chunks may be visited more than once, even with visitDagOnce.
+ *
+ *  Without MULTITHREAD, or when applied to another node, this is an ordinary Inspector.
+ */
+class ParallelInspector : public Inspector {
+    const IR::Node *applyRoot = nullptr;
+    void visitDeclarations(const IR::P4Program *program, unsigned threads);
+
+ public:
+    /// The most threads a traversal uses; 0 uses one thread per hardware thread, and 1 visits
+    /// the declarations sequentially.
+    static unsigned maxThreads;
+
+    profile_t init_apply(const IR::Node *root) override;
+    const IR::Node *apply_visitor(const IR::Node *n, const char *name = 0) override;
+
+    /// @returns a visitor without results, to visit a chunk of the declarations.  The worker
+    /// may share state that is only read with this visitor.
+    virtual ParallelInspector *newWorker() const = 0;
+    /// Merges the results of @p worker, which has visited a chunk of the declarations, into
+    /// this visitor.
+    virtual void reduce(ParallelInspector &worker) = 0;
 };
 
 class Transform : public virtual Visitor {
@@ -0,0 +1,370 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/compile_server.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#ifndef __APPLE__
+#include <stdio_ext.h>
+#endif
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lib/log.h"
+#include "lib/timer.h"
+
+bool CompileServer::running = false;
+
+namespace {
+
+/// The exit code of a worker that cannot accept requests any more.
+constexpr int WORKER_FAILED = 125;
+
+/// The standard input, output and error of the client are sent with each request.
+constexpr int STREAMS = 3;
+
+volatile sig_atomic_t stopping = 0;
+
+void stop(int) { stopping = 1; }
+
+bool writeAll(int fd, const void *data, size_t size) {
+    const auto *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool readAll(int fd, void *data, size_t size) {
+    auto *bytes = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+bool socketAddress(const char *path, sockaddr_un &address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    size_t length = strlen(path);
+    if (length >= sizeof(address.sun_path)) {
+        std::cerr << path << ": socket path is too long" << std::endl;
+        return false;
+    }
+    memcpy(address.sun_path, path, length);
+    return true;
+}
+
+void flushStreams() {
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    fflush(nullptr);
+}
+
+/// Discards what was read ahead from the standard input of a request, so that the next request
+/// starts reading its own input, and clears the end-of-file and error states.
+void discardInput() {
+    std::cin.clear();
+    if (auto available = std::cin.rdbuf()->in_avail(); available > 0) std::cin.ignore(available);
+#ifdef __APPLE__
+    fpurge(stdin);
+#else
+    __fpurge(stdin);
+#endif
+    clearerr(stdin);
+    std::cin.clear();
+}
+
+/// A request: a message with the size of the rest of the request, which carries the standard
+/// streams of the client, followed by the working directory of the client and its arguments,
+/// each terminated by a NUL character.
+struct Request {
+    std::string cwd;
+    std::vector<std::string> args;
+    int streams[STREAMS] = {-1, -1, -1};
+
+    ~Request() {
+        for (int fd : streams)
+            if (fd >= 0) close(fd);
+    }
+
+    bool receive(int connection) {
+        uint32_t size = 0;
+        iovec iov = {&size, sizeof(size)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(streams))];
+        msghdr message = {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        ssize_t received;
+        do {
+            received = recvmsg(connection, &message, 0);
+        } while (received < 0 && errno == EINTR);
+        // Take the descriptors that arrived before checking the request, so that they are
+        // closed if it is rejected.
+        auto *header = CMSG_FIRSTHDR(&message);
+        bool rights = header != nullptr && header->cmsg_level == SOL_SOCKET &&
+                      header->cmsg_type == SCM_RIGHTS && header->cmsg_len >= CMSG_LEN(0);
+        if (rights) {
+            size_t count =
+                std::min<size_t>((header->cmsg_len - CMSG_LEN(0)) / sizeof(int), STREAMS);
+            memcpy(streams, CMSG_DATA(header), count * sizeof(int));
+        }
+        // The kernel closes the descriptors that did not fit into a truncated control message.
+        if (received != sizeof(size) || (message.msg_flags & MSG_CTRUNC) != 0) return false;
+        if (!rights || header->cmsg_len != CMSG_LEN(sizeof(streams))) return false;
+
+        std::string payload(size, '\0');
+        if (!readAll(connection, payload.data(), size)) return false;
+        for (size_t pos = 0; pos < payload.size();) {
+            size_t end = payload.find('\0', pos);
+            if (end == std::string::npos) return false;
+            if (pos == 0)
+                cwd = payload.substr(0, end);
+            else
+                args.push_back(payload.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        return !cwd.empty();
+    }
+
+    bool send(int connection, int argc, char *const argv[]) const {
+        std::string payload = cwd;
+        payload.push_back('\0');
+        for (int i = 1; i < argc; i++) {
+            payload.append(argv[i]);
+            payload.push_back('\0');
+        }
+        uint32_t size = payload.size();
+        iovec iov = {&size, sizeof(size)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(streams))];
+        msghdr message = {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        auto *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(streams));
+        const int clientStreams[STREAMS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+        memcpy(CMSG_DATA(header), clientStreams, sizeof(clientStreams));
+        ssize_t sent;
+        do {
+            sent = sendmsg(connection, &message, 0);
+        } while (sent < 0 && errno == EINTR);
+        return sent == sizeof(size) && writeAll(connection, payload.data(), payload.size());
+    }
+};
+
+/// Compiles the program of @p request in its working directory, with its standard streams.
+int compileRequest(Request &request, const char *program,
+                   const CompileServer::CompileFunction &compile) {
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(program));
+    for (auto &arg : request.args) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    flushStreams();
+    int saved[STREAMS];
+    for (int fd = 0; fd < STREAMS; fd++) {
+        saved[fd] = dup(fd);
+        dup2(request.streams[fd], fd);
+    }
+    int cwd = open(".", O_RDONLY);
+
+    int rv = 1;
+    if (chdir(request.cwd.c_str()) != 0) {
+        std::cerr << request.cwd << ": " << strerror(errno) << std::endl;
+    } else {
+        Log::resetLogging();
+        Util::resetTimers();
+        try {
+            rv = compile(static_cast<int>(argv.size()) - 1, argv.data());
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Compilation failed with an unknown exception" << std::endl;
+        }
+    }
+
+    flushStreams();
+    discardInput();
+    for (int fd = 0; fd < STREAMS; fd++) {
+        dup2(saved[fd], fd);
+        close(saved[fd]);
+    }
+    if (cwd >= 0) {
+        if (fchdir(cwd) != 0) perror("fchdir");
+        close(cwd);
+    }
+    return rv;
+}
+
+/// Handles the requests sent to @p listener, one at a time.
+[[noreturn]] void runWorker(int listener, const char *program,
+                            const CompileServer::CompileFunction &compile) {
+    // The server stops the worker with these signals.
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGHUP, SIG_DFL);
+    // A client that exits early must not stop the worker.
+    signal(SIGPIPE, SIG_IGN);
+    while (true) {
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            perror("accept");
+            _exit(WORKER_FAILED);
+        }
+        Request request;
+        if (request.receive(connection)) {
+            int32_t rv = compileRequest(request, program, compile);
+            writeAll(connection, &rv, sizeof(rv));
+        }
+        close(connection);
+    }
+}
+
+}  // namespace
+
+int CompileServer::main(int argc, char *const argv[], CompileFunction compile) {
+    for (int i = 1; i + 1 < argc; i++) {
+        bool server = strcmp(argv[i], "--server") == 0;
+        if (!server && strcmp(argv[i], "--client") != 0) continue;
+        if (server) {
+            if (argc != 3) {
+                std::cerr << "--server takes no other options" << std::endl;
+                return 1;
+            }
+            return serve(argv[i + 1], argv[0], std::move(compile));
+        }
+        std::vector<char *> args(argv, argv + i);
+        args.insert(args.end(), argv + i + 2, argv + argc);
+        args.push_back(nullptr);
+        return sendRequest(argv[i + 1], static_cast<int>(args.size()) - 1, args.data());
+    }
+    return compile(argc, argv);
+}
+
+int CompileServer::serve(const char *socketPath, const char *program, CompileFunction compile) {
+    sockaddr_un address;
+    if (!socketAddress(socketPath, address)) return 1;
+    // Remove the socket of a server that did not stop cleanly, but nothing else.
+    struct stat st;
+    if (lstat(socketPath, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << socketPath << ": exists and is not a socket" << std::endl;
+            return 1;
+        }
+        unlink(socketPath);
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    auto *bound = reinterpret_cast<sockaddr *>(&address);
+    if (listener < 0 || bind(listener, bound, sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        perror(socketPath);
+        return 1;
+    }
+    running = true;
+
+    struct sigaction action = {};
+    action.sa_handler = stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGHUP, &action, nullptr);
+
+    // The worker keeps its caches between requests; it is only restarted when it exits.
+    int rv = 0;
+    while (!stopping) {
+        pid_t worker = fork();
+        if (worker < 0) {
+            perror("fork");
+            rv = 1;
+            break;
+        }
+        if (worker == 0) runWorker(listener, program, compile);
+        int status = 0;
+        pid_t waited;
+        while ((waited = waitpid(worker, &status, 0)) < 0 && errno == EINTR && !stopping) {
+        }
+        if (waited < 0) {
+            kill(worker, SIGTERM);
+            waitpid(worker, &status, 0);
+            break;
+        }
+        if (WIFEXITED(status) && WEXITSTATUS(status) == WORKER_FAILED) {
+            rv = 1;
+            break;
+        }
+        LOG1("Compile server worker " << worker << " stopped; restarting it");
+    }
+    close(listener);
+    unlink(socketPath);
+    return rv;
+}
+
+int CompileServer::sendRequest(const char *socketPath, int argc, char *const argv[]) {
+    sockaddr_un address;
+    if (!socketAddress(socketPath, address)) return 1;
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0 ||
+        connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        std::cerr << socketPath << ": cannot connect to the compile server: " << strerror(errno)
+                  << std::endl;
+        return 1;
+    }
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+        perror("getcwd");
+        return 1;
+    }
+    Request request;
+    request.cwd = cwd;
+    int32_t rv = 1;
+    if (!request.send(connection, argc, argv))
+        perror(socketPath);
+    else if (!readAll(connection, &rv, sizeof(rv))) {
+        std::cerr << "The compile server stopped while compiling" << std::endl;
+        rv = 1;
+    }
+    close(connection);
+    return rv;
+}
@@ -0,0 +1,53 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_COMPILE_SERVER_H_
+#define LIB_COMPILE_SERVER_H_
+
+#include <functional>
+
+/// Runs a compiler as a long-running process that compiles the programs of requests received
+/// on a Unix domain socket, so that the requests do not pay for starting the compiler and
+/// share what the compiler keeps in memory (singletons, parsed include files, ...).
+///
+/// A compiler started with `--server <socket>` listens on the socket.  A compiler started with
+/// `--client <socket> <options>` sends its command line, its working directory and its
+/// standard streams to the server, and exits with the exit code of the compilation.  The
+/// environment of the client is not sent: environment variables that the compiler reads
+/// (e.g. P4C_16_INCLUDE_PATH) are those of the server.
+///
+/// The server handles one request at a time, in a worker process that it restarts when the
+/// worker exits, e.g. because an option such as --help exits the compiler.  The client of the
+/// request that stopped the worker exits with code 1.  Each request is compiled by calling the
+/// compile function of the compiler, which creates a new compilation context for it.
+class CompileServer {
+ public:
+    /// Compiles the program of the command line @p argv, and returns the exit code.
+    using CompileFunction = std::function<int(int argc, char *const argv[])>;
+
+    /// The main function of a compiler that supports the compile server: runs a server or a
+    /// client if the command line has --server or --client, and otherwise calls @p compile.
+    static int main(int argc, char *const argv[], CompileFunction compile);
+
+    /// @returns true in a server, where caches may be kept for later requests.
+    static bool isRunning() { return running; }
+
+ private:
+    static bool running;
+
+    static int serve(const char *socketPath, const char *program, CompileFunction compile);
+    static int sendRequest(const char *socketPath, int argc, char *const argv[]);
+};
+
+#endif /* LIB_COMPILE_SERVER_H_ */
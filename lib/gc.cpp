@@ -16,6 +16,10 @@ limitations under the License.
 
 #include "config.h"
 #if HAVE_LIBGC
+#ifdef MULTITHREAD
+// declares the functions that register threads
+#define GC_THREADS
+#endif  // MULTITHREAD
 #include <gc/gc_cpp.h>
 #include <gc/gc_mark.h>
 #endif /* HAVE_LIBGC */
@@ -220,3 +224,24 @@ size_t gc_mem_inuse(size_t *max) {
     return 0;
 #endif
 }
+
+void enable_gc_threads() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    GC_allow_register_threads();
+#endif
+}
+
+GCThreadRegistration::GCThreadRegistration() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    // Registering a thread that is already registered, e.g. the main thread, does nothing.
+    struct GC_stack_base base;
+    if (GC_get_stack_base(&base) == GC_SUCCESS)
+        registered = GC_register_my_thread(&base) == GC_SUCCESS;
+#endif
+}
+
+GCThreadRegistration::~GCThreadRegistration() {
+#if HAVE_LIBGC && defined(MULTITHREAD)
+    if (registered) GC_unregister_my_thread();
+#endif
+}
@@ -22,4 +22,21 @@ limitations under the License.
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
 
+// Lets threads other than the main thread register with the garbage collector.  Must be
+// called from the main thread before it starts threads that allocate memory.
+void enable_gc_threads();
+
+// Registers the calling thread with the garbage collector while it exists, so that the
+// collector scans the stack of the thread and stops it while collecting.  Threads other than
+// the main thread must do so before they allocate memory.
+class GCThreadRegistration {
+    bool registered = false;
+
+ public:
+    GCThreadRegistration();
+    ~GCThreadRegistration();
+    GCThreadRegistration(const GCThreadRegistration &) = delete;
+    GCThreadRegistration &operator=(const GCThreadRegistration &) = delete;
+};
+
 #endif /* LIB_GC_H_ */
@@ -0,0 +1,45 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/input_buffer.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Util {
+
+InputBuffer::InputBuffer(FILE *in) {
+    struct stat st;
+    // Only a file that nothing was read from yet is mapped: stdio may have buffered the
+    // beginning of a file that was read from.
+    if (fstat(fileno(in), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+        ftello(in) == 0) {
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+        if (data != MAP_FAILED) {
+            posix_madvise(data, st.st_size, POSIX_MADV_SEQUENTIAL);
+            mapped = data;
+            mappedSize = st.st_size;
+            return;
+        }
+    }
+    char buffer[1 << 16];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), in)) > 0) text.append(buffer, size);
+}
+
+InputBuffer::~InputBuffer() {
+    if (mapped) munmap(mapped, mappedSize);
+}
+
+}  // namespace Util
@@ -0,0 +1,71 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_INPUT_BUFFER_H_
+#define LIB_INPUT_BUFFER_H_
+
+#include <cstdio>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace Util {
+
+/// The rest of the contents of a stdio file in one contiguous buffer.  Regular files are
+/// memory mapped; other files, such as the output of the preprocessor, are read into memory.
+class InputBuffer {
+    std::string text;
+    void *mapped = nullptr;
+    size_t mappedSize = 0;
+
+ public:
+    /// Reads @p in from its current position to its end; @p in is not closed.
+    explicit InputBuffer(FILE *in);
+    ~InputBuffer();
+    InputBuffer(const InputBuffer &) = delete;
+    InputBuffer &operator=(const InputBuffer &) = delete;
+
+    std::string_view contents() const {
+        if (mapped) return std::string_view(static_cast<const char *>(mapped), mappedSize);
+        return text;
+    }
+};
+
+/// An input stream that reads a buffer in place, without copying it.  The buffer must
+/// outlive the stream.  The whole buffer is available at once: rdbuf()->in_avail() is
+/// the size of the rest of the input.
+///
+/// This does not make lexing copy-free: a flex C++ scanner reads its input in chunks into a
+/// buffer of its own, which it writes to while scanning.  Flex can only scan a caller's buffer
+/// in place (yy_scan_buffer) in a C scanner, and the buffer would have to be writable and end
+/// in two NULs, which a read-only mapping of the input is not.
+class MemoryInputStream : public std::istream {
+    struct Buffer : public std::streambuf {
+        explicit Buffer(std::string_view data) {
+            // The get area is only read from.
+            auto *begin = const_cast<char *>(data.data());
+            setg(begin, begin, begin + data.size());
+        }
+    } buffer;
+
+ public:
+    explicit MemoryInputStream(std::string_view data) : std::istream(nullptr), buffer(data) {
+        rdbuf(&buffer);
+    }
+};
+
+}  // namespace Util
+
+#endif /* LIB_INPUT_BUFFER_H_ */
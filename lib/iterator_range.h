@@ -0,0 +1,153 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_ITERATOR_RANGE_H_
+#define LIB_ITERATOR_RANGE_H_
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/* Lazy ranges: an alternative to the where/map chains of Util::Enumerator for hot code.
+   The filters and functions are template parameters, so they are inlined, and building
+   a range never allocates.  A range refers to the iterators of the container it was built
+   from, so the container must outlive the range. */
+
+namespace Util {
+
+/// A pair of iterators that can be used in range-based for loops.
+template <class Iter>
+class iterator_range {
+    Iter b, e;
+
+ public:
+    iterator_range(Iter b, Iter e) : b(std::move(b)), e(std::move(e)) {}
+    Iter begin() const { return b; }
+    Iter end() const { return e; }
+    bool empty() const { return b == e; }
+};
+
+template <class Iter>
+iterator_range<Iter> make_range(Iter b, Iter e) {
+    return iterator_range<Iter>(std::move(b), std::move(e));
+}
+
+/// Iterates over the elements of [it, end) for which the predicate holds.
+template <class Iter, class Pred>
+class filter_iterator {
+    Iter it, end;
+    // Lambdas are not assignable; keeping the predicate in an optional makes the iterator so.
+    std::optional<Pred> pred;
+
+    void skip() {
+        while (it != end && !(*pred)(*it)) ++it;
+    }
+
+ public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<Iter>::value_type;
+    using difference_type = typename std::iterator_traits<Iter>::difference_type;
+    using pointer = typename std::iterator_traits<Iter>::pointer;
+    using reference = typename std::iterator_traits<Iter>::reference;
+
+    filter_iterator(Iter it, Iter end, Pred pred) : it(it), end(end), pred(std::move(pred)) {
+        skip();
+    }
+    filter_iterator(const filter_iterator &other) : it(other.it), end(other.end) {
+        pred.emplace(*other.pred);
+    }
+    filter_iterator &operator=(const filter_iterator &other) {
+        it = other.it;
+        end = other.end;
+        pred.emplace(*other.pred);
+        return *this;
+    }
+    reference operator*() const { return *it; }
+    filter_iterator &operator++() {
+        ++it;
+        skip();
+        return *this;
+    }
+    filter_iterator operator++(int) {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+    bool operator==(const filter_iterator &other) const { return it == other.it; }
+    bool operator!=(const filter_iterator &other) const { return it != other.it; }
+};
+
+/// Iterates over the results of applying a function to the elements of an iterator.
+template <class Iter, class Fn>
+class transform_iterator {
+    Iter it;
+    std::optional<Fn> fn;
+
+ public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::decay_t<
+        std::invoke_result_t<const Fn &, typename std::iterator_traits<Iter>::reference>>;
+    using difference_type = typename std::iterator_traits<Iter>::difference_type;
+    using pointer = const value_type *;
+    using reference = value_type;
+
+    transform_iterator(Iter it, Fn fn) : it(it), fn(std::move(fn)) {}
+    transform_iterator(const transform_iterator &other) : it(other.it) { fn.emplace(*other.fn); }
+    transform_iterator &operator=(const transform_iterator &other) {
+        it = other.it;
+        fn.emplace(*other.fn);
+        return *this;
+    }
+    value_type operator*() const { return (*fn)(*it); }
+    transform_iterator &operator++() {
+        ++it;
+        return *this;
+    }
+    transform_iterator operator++(int) {
+        auto copy = *this;
+        ++it;
+        return copy;
+    }
+    bool operator==(const transform_iterator &other) const { return it == other.it; }
+    bool operator!=(const transform_iterator &other) const { return it != other.it; }
+};
+
+/// @returns the elements of @p range for which @p pred holds.
+template <class Range, class Pred>
+auto filter(const Range &range, Pred pred) {
+    using Iter = decltype(std::begin(range));
+    return make_range(filter_iterator<Iter, Pred>(std::begin(range), std::end(range), pred),
+                      filter_iterator<Iter, Pred>(std::end(range), std::end(range), pred));
+}
+
+/// @returns the results of applying @p fn to the elements of @p range.
+template <class Range, class Fn>
+auto transform(const Range &range, Fn fn) {
+    using Iter = decltype(std::begin(range));
+    return make_range(transform_iterator<Iter, Fn>(std::begin(range), fn),
+                      transform_iterator<Iter, Fn>(std::end(range), fn));
+}
+
+/// @returns the elements of @p range that are of type S (e.g., const IR::Type *), cast to S.
+template <class S, class Range>
+auto only(const Range &range) {
+    auto cast = [](const auto &el) { return dynamic_cast<S>(el); };
+    return filter(transform(range, cast), [](S el) { return el != nullptr; });
+}
+
+}  // namespace Util
+
+#endif /* LIB_ITERATOR_RANGE_H_ */
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "json.h"
 
+#include <charconv>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
@@ -203,4 +206,176 @@ JsonObject *JsonObject::emplace_non_null(cstring label, IJson *value) {
     return this;
 }
 
+void JsonStream::serialize(std::ostream &out) const {
+    JsonWriter writer(out);
+    write(writer);
+}
+
+void JsonWriter::newline() { out << '\n' << indent_t::getindent(out); }
+
+void JsonWriter::beginValue() {
+    if (levels.empty()) return;
+    auto &level = levels.back();
+    if (level.isObject) {
+        if (!keyWritten) throw std::logic_error("JSON object value written without a key");
+        keyWritten = false;
+        return;
+    }
+    if (!level.empty) out << (level.compact ? ", " : ",");
+    if (!level.compact) newline();
+    level.empty = false;
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    beginValue();
+    out << '{';
+    ++indent_t::getindent(out);
+    levels.push_back({true, false, true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (levels.empty() || !levels.back().isObject || keyWritten)
+        throw std::logic_error("Unbalanced JSON object");
+    levels.pop_back();
+    --indent_t::getindent(out);
+    newline();
+    out << '}';
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(bool compact) {
+    beginValue();
+    out << '[';
+    if (!compact) ++indent_t::getindent(out);
+    levels.push_back({false, compact, true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (levels.empty() || levels.back().isObject) throw std::logic_error("Unbalanced JSON array");
+    auto level = levels.back();
+    levels.pop_back();
+    if (!level.compact) {
+        --indent_t::getindent(out);
+        // Empty arrays are printed as [], like JsonArray does.
+        if (!level.empty) newline();
+    }
+    out << ']';
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(cstring label) {
+    if (levels.empty() || !levels.back().isObject || keyWritten)
+        throw std::logic_error("JSON key written outside of an object");
+    if (label.isNullOrEmpty()) throw std::logic_error("Empty label");
+    auto &level = levels.back();
+    if (!level.empty) out << ',';
+    level.empty = false;
+    newline();
+    writeString(out, label.c_str(), label.size());
+    out << " : ";
+    keyWritten = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::null() {
+    beginValue();
+    out << "null";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool b) {
+    beginValue();
+    out << (b ? "true" : "false");
+    return *this;
+}
+
+void JsonWriter::writeSigned(long long v) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), v);
+    out.write(buf, result.ptr - buf);
+}
+
+void JsonWriter::writeUnsigned(unsigned long long v) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), v);
+    out.write(buf, result.ptr - buf);
+}
+
+JsonWriter &JsonWriter::value(const big_int &v) {
+    beginValue();
+    out << v;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(cstring s) {
+    beginValue();
+    writeString(out, s.isNull() ? "" : s.c_str(), s.size());
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const std::string &s) {
+    beginValue();
+    writeString(out, s.data(), s.size());
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *s) {
+    beginValue();
+    writeString(out, s, strlen(s));
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const IJson *json) {
+    beginValue();
+    if (json == nullptr)
+        out << "null";
+    else
+        json->serialize(out);
+    return *this;
+}
+
+void JsonWriter::writeString(std::ostream &out, const char *s, size_t length) {
+    out << '"';
+    // Most strings need no escaping, so copy runs of plain characters in one write.
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++) {
+        auto c = static_cast<unsigned char>(s[i]);
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+        out.write(s + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\b':
+                out << "\\b";
+                break;
+            case '\f':
+                out << "\\f";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default: {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out << buf;
+            }
+        }
+    }
+    out.write(s + start, length - start);
+    out << '"';
+}
+
 }  // namespace Util
@@ -17,8 +17,10 @@ limitations under the License.
 #ifndef LIB_JSON_H_
 #define LIB_JSON_H_
 
+#include <functional>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -183,6 +185,81 @@ class JsonObject final : public IJson, public ordered_map<cstring, IJson *> {
     IJson *get(cstring label) const { return ::get(*this, label); }
 };
 
+class JsonWriter;
+
+/// A JSON value that is written by a JsonWriter when the tree is serialized. This
+/// lets large sections of a JSON document be written straight into the output
+/// stream, without keeping them in memory as a tree of IJson nodes or as text.
+class JsonStream final : public IJson {
+    std::function<void(JsonWriter &)> write;
+
+ public:
+    explicit JsonStream(std::function<void(JsonWriter &)> write) : write(std::move(write)) {}
+    void serialize(std::ostream &out) const;
+};
+
+/// A streaming (SAX style) JSON writer. Values are written to the output stream
+/// as soon as they are produced, using the same layout as IJson::serialize.
+/// Unbalanced nesting and values without a key inside an object throw
+/// std::logic_error.
+class JsonWriter {
+    struct Level {
+        bool isObject;
+        // Compact arrays are written on a single line, which is how JsonArray
+        // prints arrays that only contain scalar values.
+        bool compact;
+        bool empty;
+    };
+    std::ostream &out;
+    std::vector<Level> levels;
+    bool keyWritten = false;
+
+    void beginValue();
+    void newline();
+    void writeSigned(long long v);
+    void writeUnsigned(unsigned long long v);
+
+ public:
+    explicit JsonWriter(std::ostream &out) : out(out) {}
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray(bool compact = false);
+    JsonWriter &endArray();
+    JsonWriter &key(cstring label);
+
+    JsonWriter &null();
+    JsonWriter &value(bool b);
+    template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                      !std::is_same<T, bool>::value,
+                                                  int>::type = 0>
+    JsonWriter &value(T v) {
+        beginValue();
+        if constexpr (std::is_signed<T>::value)
+            writeSigned(v);
+        else
+            writeUnsigned(v);
+        return *this;
+    }
+    JsonWriter &value(const big_int &v);
+    JsonWriter &value(cstring s);
+    JsonWriter &value(const std::string &s);
+    JsonWriter &value(const char *s);
+    /// Embeds an already built tree.
+    JsonWriter &value(const IJson *json);
+
+    /// Shorthand for key(label).value(v).
+    template <typename T>
+    JsonWriter &field(cstring label, T v) {
+        key(label);
+        return value(v);
+    }
+
+    /// Writes 'length' characters of 's' as a quoted JSON string, escaping
+    /// quotes, backslashes and control characters like cstring::escapeJson.
+    static void writeString(std::ostream &out, const char *s, size_t length);
+};
+
 }  // namespace Util
 
 #endif /* LIB_JSON_H_ */
@@ -43,7 +43,7 @@ namespace Detail {
 int verbosity = 0;
 int maximumLogLevel = 0;
 bool enableLoggingGlobally = true;
-bool enableLoggingInContext = false;
+thread_local bool enableLoggingInContext = false;
 
 // The time at which logging was initialized; used so that log messages can have
 // relative rather than absolute timestamps.
@@ -357,4 +357,13 @@ void increaseVerbosity() {
     Detail::invalidateCaches(Detail::verbosity - 1);
 }
 
+void resetLogging() {
+    Detail::verbosity = 0;
+    Detail::maximumLogLevel = 0;
+    Detail::enableLoggingGlobally = true;
+    Detail::debugSpecs.clear();
+    Detail::logfiles.clear();
+    Detail::invalidateCaches(0);
+}
+
 }  // namespace Log
@@ -40,7 +40,9 @@ extern int maximumLogLevel;
 
 // Used to restrict logging to a specific IR context.
 extern bool enableLoggingGlobally;
-extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this is ignored.
+// Set by visitors while they visit a node in the context, so it is kept for each thread.
+// If enableLoggingGlobally is true, this is ignored.
+extern thread_local bool enableLoggingInContext;
 
 // Look up the log level of @file.
 int fileLogLevel(const char *file);
@@ -98,6 +100,11 @@ inline bool enableLogging() {
 }
 void increaseVerbosity();
 
+// Restores the logging settings of a new process, e.g. before a compile server compiles
+// the program of its next request.  This must not be called while other threads log or
+// change the logging settings.
+void resetLogging();
+
 }  // namespace Log
 
 #ifndef MAX_LOGGING_LEVEL
@@ -17,6 +17,7 @@ limitations under the License.
 #include "source_file.h"
 
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "exceptions.h"
@@ -56,7 +57,7 @@ cstring SourceInfo::toDebugString() const {
 
 InputSources::InputSources() : sealed(false) {
     mapLine(nullptr, 1);  // the first line read will be line 1 of stdin
-    contents.push_back("");
+    lineStarts.push_back(0);
 }
 
 void InputSources::addComment(SourceInfo srcInfo, bool singleLine, cstring body) {
@@ -75,8 +76,8 @@ void InputSources::seal() {
 }
 
 unsigned InputSources::lineCount() const {
-    int size = contents.size();
-    if (contents.back().empty()) {
+    int size = lineStarts.size();
+    if (text.size() == lineStarts.back()) {
         // do not count the last line if it is empty.
         size -= 1;
         if (size < 0) BUG("Negative line count");
@@ -84,54 +85,17 @@ unsigned InputSources::lineCount() const {
     return size;
 }
 
-// Append this text to the last line
-void InputSources::appendToLastLine(StringRef text) {
-    if (sealed) BUG("Appending to sealed InputSources");
-    // Text should not contain any newline characters
-    for (size_t i = 0; i < text.len; i++) {
-        char c = text[i];
-        if (c == '\n') BUG("Text contains newlines");
-    }
-    contents.back() += text.toString();
-}
-
-// Append a newline and start a new line
-void InputSources::appendNewline(StringRef newline) {
-    if (sealed) BUG("Appending to sealed InputSources");
-    contents.back() += newline.toString();
-    contents.push_back("");  // start a new line
-}
-
 void InputSources::appendText(const char *text) {
     if (text == nullptr) BUG("Null text being appended");
-    StringRef ref = text;
-
-    while (ref.len > 0) {
-        const char *nl = ref.find("\r\n");
-        if (nl == nullptr) {
-            appendToLastLine(ref);
-            break;
-        }
-
-        size_t toCut = nl - ref.p;
-        if (toCut != 0) {
-            StringRef nonnl(ref.p, toCut);
-            appendToLastLine(nonnl);
-            ref += toCut;
-        } else {
-            if (ref[0] == '\n') {
-                appendNewline("\n");
-                ref += 1;
-            } else if (ref.len > 2 && ref[0] == '\r' && ref[1] == '\n') {
-                appendNewline("\r\n");
-                ref += 2;
-            } else {
-                // Just \r
-                appendToLastLine(ref.substr(0, 1));
-                ref += 1;
-            }
-        }
-    }
+    if (sealed) BUG("Appending to sealed InputSources");
+    size_t offset = this->text.size();
+    this->text.append(text);
+    // A line ends with "\n" or "\r\n", so only newlines start lines.
+    const char *begin = this->text.data();
+    const char *end = begin + this->text.size();
+    const char *p = begin + offset;
+    while ((p = static_cast<const char *>(memchr(p, '\n', end - p))) != nullptr)
+        lineStarts.push_back(++p - begin);
 }
 
 cstring InputSources::getLine(unsigned lineNumber) const {
@@ -141,7 +105,9 @@ cstring InputSources::getLine(unsigned lineNumber) const {
         // don't throw: this code may be called by exceptions
         // reporting on elements that have no source position
     }
-    return contents.at(lineNumber - 1);
+    size_t start = lineStarts.at(lineNumber - 1);
+    size_t end = lineNumber < lineStarts.size() ? lineStarts[lineNumber] : text.size();
+    return cstring(text.data() + start, end - start);
 }
 
 void InputSources::mapLine(cstring file, unsigned originalSourceLineNo) {
@@ -171,11 +137,11 @@ SourceFileLine InputSources::getSourceLine(unsigned line) const {
     return SourceFileLine(it->second.fileName, realLine);
 }
 
-unsigned InputSources::getCurrentLineNumber() const { return contents.size(); }
+unsigned InputSources::getCurrentLineNumber() const { return lineStarts.size(); }
 
 SourcePosition InputSources::getCurrentPosition() const {
     unsigned line = getCurrentLineNumber();
-    unsigned column = contents.back().size();
+    unsigned column = text.size() - lineStarts.back();
     return SourcePosition(line, column);
 }
 
@@ -251,7 +217,7 @@ cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
 
 cstring InputSources::toDebugString() const {
     std::stringstream builder;
-    for (auto line : contents) builder << line;
+    builder << text;
     builder << "---------------" << std::endl;
     for (auto lf : line_file_map) builder << lf.first << ": " << lf.second.toString() << std::endl;
     return cstring(builder.str());
@@ -190,6 +190,8 @@ class SourceInfo final {
 
     const SourcePosition &getEnd() const { return this->end; }
 
+    const InputSources *getSources() const { return this->sources; }
+
     /**
        True if this comes 'before' this source position.
        'invalid' source positions come first.
@@ -277,6 +279,9 @@ class InputSources final {
     /// Prevents further changes; currently not used.
     void seal();
 
+    /// Reserves space for @p size more bytes of text, e.g. the size of the input.
+    void reserve(size_t size) { text.reserve(text.size() + size); }
+
     /// Append this text; it is either a newline or a text with no newlines.
     void appendText(const char *text);
 
@@ -298,18 +303,15 @@ class InputSources final {
     void addComment(SourceInfo srcInfo, bool singleLine, cstring body);
 
  private:
-    /// Append this text to the last line; must not contain newlines
-    void appendToLastLine(StringRef text);
-    /// Append a newline and start a new line
-    void appendNewline(StringRef newline);
-
     /// Input program that is being currently compiled; there can be only one.
     bool sealed;
 
     std::map<unsigned, SourceFileLine> line_file_map;
 
-    /// Each line also stores the end-of-line character(s)
-    std::vector<std::string> contents;
+    /// The text of all the lines, each with its end-of-line character(s).
+    std::string text;
+    /// The offset in 'text' of the first character of each line.
+    std::vector<size_t> lineStarts;
     /// The commends found in the file.
     std::vector<Comment *> comments;
 };
@@ -2,10 +2,14 @@
 
 #include <algorithm>
 #include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
+#include "lib/exceptions.h"
+
 namespace Util {
 
 namespace {
@@ -140,4 +144,37 @@ std::vector<TimerEntry> getTimers() {
     return ret;
 }
 
+namespace {
+
+std::mutex countersMutex;
+
+std::map<std::string, uint64_t, std::less<>> &counters() {
+    static std::map<std::string, uint64_t, std::less<>> counters;
+    return counters;
+}
+
+}  // namespace
+
+void incrementCounter(const char *name, uint64_t n) {
+    std::lock_guard<std::mutex> lock(countersMutex);
+    auto &all = counters();
+    auto it = all.find(name);
+    if (it == all.end()) it = all.emplace(name, 0).first;
+    it->second += n;
+}
+
+std::map<std::string, uint64_t> getCounters() {
+    std::lock_guard<std::mutex> lock(countersMutex);
+    return std::map<std::string, uint64_t>(counters().begin(), counters().end());
+}
+
+void resetTimers() {
+    auto &root = RootCounter::get();
+    BUG_CHECK(root.getCurrent() == &root.counter, "Resetting timers while a timer is running");
+    root.counter.counters.clear();
+    root.start = Clock::now();
+    std::lock_guard<std::mutex> lock(countersMutex);
+    counters().clear();
+}
+
 }  // namespace Util
@@ -2,7 +2,9 @@
 #define LIB_TIMER_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -36,6 +38,16 @@ struct TimerEntry {
 /// Returns list of all timers for and their current values.
 std::vector<TimerEntry> getTimers();
 
+/// Adds @p n to the counter @p name, e.g. the number of passes run.
+void incrementCounter(const char *name, uint64_t n = 1);
+
+/// Returns all counters and their current values.
+std::map<std::string, uint64_t> getCounters();
+
+/// Resets all timers and counters, e.g. between the compilations of a compile server.
+/// Must not be called while a timer is running.
+void resetTimers();
+
 // Internal implementation.
 struct ScopedTimerCtx;
 
@@ -16,6 +16,13 @@ bool SourceIdCmp::operator()(const IR::Node *s1, const IR::Node *s2) const {
 
 CollectNodes::CollectNodes(CoverageOptions coverageOptions) : coverageOptions(coverageOptions) {}
 
+ParallelInspector *CollectNodes::newWorker() const { return new CollectNodes(coverageOptions); }
+
+void CollectNodes::reduce(ParallelInspector &worker) {
+    const auto &collected = dynamic_cast<CollectNodes &>(worker).coverableNodes;
+    coverableNodes.insert(collected.begin(), collected.end());
+}
+
 bool CollectNodes::preorder(const IR::AssignmentStatement *stmt) {
     // Only track statements, which have a valid source position in the P4 program.
     if (coverageOptions.coverStatements && stmt->getSourceInfo().isValid()) {
@@ -33,7 +33,9 @@ using CoverageSet = std::set<const IR::Node *, SourceIdCmp>;
 
 /// CollectNodes iterates across selected nodes in the P4 program and collects them in a
 /// "CoverageSet". The nodes to collect are specified as options to the collector.
-class CollectNodes : public Inspector {
+/// The visit functions only read the source information of the nodes, so the top-level
+/// declarations of a program are visited in parallel.
+class CollectNodes : public ParallelInspector {
     /// The set of nodes in the program that could potentially be covered.
     CoverageSet coverableNodes;
 
@@ -51,6 +53,9 @@ class CollectNodes : public Inspector {
  public:
     explicit CollectNodes(CoverageOptions coverageOptions);
 
+    ParallelInspector *newWorker() const override;
+    void reduce(ParallelInspector &worker) override;
+
     /// @return the set of coverable nodes in the program.
     const CoverageSet &getCoverableNodes();
 };
@@ -0,0 +1,252 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/binary_ir.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+
+namespace Test {
+
+class BinaryIRTest : public P4CTest {};
+
+namespace {
+
+const IR::Node *loadBinary(const std::string &data) {
+    return readBinaryIR(data.data(), data.size());
+}
+
+std::string toJson(const IR::Node *node) {
+    std::stringstream ss;
+    JSONGenerator(ss) << node << std::endl;
+    return ss.str();
+}
+
+std::string toBinary(const IR::Node *node) {
+    std::stringstream ss;
+    writeBinaryIR(ss, node);
+    return ss.str();
+}
+
+/// A block of @size assignments, with a variable declaration and nodes shared by all of them.
+const IR::BlockStatement *mkBlock(int size) {
+    auto *block = new IR::BlockStatement();
+    auto *type = IR::Type_Bits::get(32);
+    block->push_back(new IR::Declaration_Variable(IR::ID("tmp"), type));
+    auto *shared = new IR::Constant(type, 1);
+    for (int i = 0; i < size; i++) {
+        auto *path = new IR::PathExpression(IR::ID("var" + std::to_string(i % 100)));
+        block->push_back(new IR::AssignmentStatement(
+            new IR::PathExpression(IR::ID("tmp")),
+            new IR::Add(new IR::Mul(path, shared), new IR::Constant(i))));
+    }
+    return block;
+}
+
+}  // namespace
+
+TEST_F(BinaryIRTest, RoundTrip) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(16), 2);
+    auto *big = new IR::Constant(big_int("123456789012345678901234567890"));
+    auto *neg = new IR::Constant(-7);
+    const IR::Expression *e = new IR::Add(new IR::Sub(c, neg), new IR::Mul(c, big));
+    const IR::Expression *s = new IR::StringLiteral(cstring("a \"quoted\" \\ string"));
+    const IR::Expression *p = new IR::PathExpression(IR::ID("x", "original"));
+    auto *list = new IR::ListExpression(IR::Vector<IR::Expression>({e, s, p, e}));
+
+    auto binary = toBinary(list);
+    auto *loaded = loadBinary(binary);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(toJson(loaded), toJson(list));
+    EXPECT_LT(binary.size(), toJson(list).size());
+
+    // Shared nodes stay shared, and IDs keep their original name.
+    const auto &components = loaded->to<IR::ListExpression>()->components;
+    ASSERT_EQ(components.size(), 4u);
+    EXPECT_EQ(components.at(0), components.at(3));
+    EXPECT_EQ(components.at(2)->to<IR::PathExpression>()->path->name.originalName, "original");
+}
+
+// Programs from the frontend load to the same IR from the binary format.
+TEST_F(BinaryIRTest, RoundTripPrograms) {
+    std::vector<std::string> sources = {
+        P4_SOURCE(P4Headers::V1MODEL, R"(
+            enum bit<8> Kind { A = 1, B = 2 }
+            header h_t { bit<8> kind; bit<16> value; varbit<32> rest; }
+            header e_t { bit<8> kind; }
+            header_union u_t { h_t first; e_t second; }
+            struct Headers { h_t h; e_t[2] stack; u_t u; }
+            struct Metadata { bit<16> sum; bool seen; }
+            error { Unknown }
+            bit<16> twice(in bit<16> x) { return x << 1; }
+            parser parse(packet_in p, out Headers h, inout Metadata m,
+                         inout standard_metadata_t sm) {
+                value_set<bit<8>>(4) kinds;
+                state start {
+                    p.extract(h.h, 32);
+                    transition select(h.h.kind) {
+                        kinds: next;
+                        8w2 &&& 8w0xf: accept;
+                        default: reject;
+                    }
+                }
+                state next {
+                    p.extract(h.stack.next);
+                    verify(h.stack[0].kind != 0, error.Unknown);
+                    transition accept;
+                }
+            }
+            control checksum(inout Headers h, inout Metadata m) { apply { } }
+            control ingress(inout Headers h, inout Metadata m,
+                            inout standard_metadata_t sm) {
+                counter<bit<32>>(32w16, CounterType.packets) hits;
+                action set(bit<9> port, Kind kind) {
+                    sm.egress_spec = port;
+                    h.h.kind = (bit<8>)kind;
+                }
+                table t {
+                    key = { h.h.kind : exact; h.h.value : ternary; }
+                    actions = { set; NoAction; }
+                    const entries = {
+                        (1, 16w0x10 &&& 16w0xf0) : set(1, Kind.A);
+                        (2, _) : set(2, Kind.B);
+                    }
+                    default_action = NoAction();
+                    size = 64;
+                }
+                apply {
+                    m.sum = twice(h.h.value);
+                    m.sum = m.sum + (m.seen ? 16w1 : 16w0);
+                    switch (t.apply().action_run) {
+                        set: { hits.count(32w1); }
+                        default: { mark_to_drop(sm); }
+                    }
+                    if (h.u.first.isValid()) { h.u.second = h.stack[1]; }
+                }
+            }
+            control egress(inout Headers h, inout Metadata m,
+                           inout standard_metadata_t sm) { apply { } }
+            control deparse(packet_out p, in Headers h) {
+                apply { p.emit(h.h); p.emit(h.stack); p.emit(h.u); }
+            }
+            V1Switch(parse(), checksum(), ingress(), egress(), checksum(), deparse()) main;
+        )"),
+        P4_SOURCE(P4Headers::CORE, R"(
+            struct Pair<T> { T first; T second; }
+            enum Color { Red, Green }
+            const bit<32> WIDTH = 32w0xffff_0000;
+            extern Box<T> {
+                Box(T initial);
+                T get();
+                @pure void set(in T value);
+            }
+            control C<T>(inout Pair<T> pair)(bool swap);
+            control impl(inout Pair<bit<4>> pair)(bool swap) {
+                Box<bit<4>>(4w3) box;
+                apply {
+                    bit<4> tmp = pair.first;
+                    if (swap) {
+                        pair.first = pair.second;
+                        pair.second = tmp;
+                    }
+                    box.set(pair.first[3:1] ++ 1w0);
+                    Color c = Color.Red;
+                    pair.second = c == Color.Green ? box.get() : (bit<4>)WIDTH[3:0];
+                }
+            }
+            package top(C<bit<4>> c);
+            top(impl(true)) main;
+        )"),
+    };
+    for (const auto &source : sources) {
+        auto test = FrontendTestCase::create(source);
+        ASSERT_TRUE(test);
+        auto *loaded = loadBinary(toBinary(test->program));
+        ASSERT_NE(loaded, nullptr);
+        ASSERT_TRUE(loaded->is<IR::P4Program>());
+        EXPECT_EQ(toJson(loaded), toJson(test->program));
+    }
+}
+
+TEST_F(BinaryIRTest, RejectsMalformedInput) {
+    auto binary = toBinary(new IR::Constant(42));
+    EXPECT_EQ(loadBinary(binary.substr(0, binary.size() - 1)), nullptr);
+    binary[0] = 'X';
+    EXPECT_EQ(loadBinary(binary), nullptr);
+    EXPECT_EQ(::errorCount(), 2u);
+}
+
+// Both formats load to the same IR, and the binary format is smaller on a large IR.
+TEST_F(BinaryIRTest, CompareWithJson) {
+    auto *block = mkBlock(20000);
+
+    auto json = toJson(block);
+    std::stringstream in(json);
+    const IR::Node *fromJson = nullptr;
+    JSONLoader(in) >> fromJson;
+    auto binary = toBinary(block);
+    auto *fromBinary = loadBinary(binary);
+
+    ASSERT_NE(fromJson, nullptr);
+    ASSERT_NE(fromBinary, nullptr);
+    EXPECT_EQ(toJson(fromBinary), toJson(fromJson));
+    EXPECT_LT(binary.size(), json.size());
+    // The declarations of the indexed vector are rebuilt.
+    EXPECT_NE(fromBinary->to<IR::BlockStatement>()->getDeclByName("tmp"), nullptr);
+}
+
+// Compares the time to write and load a large IR in both formats.
+TEST_F(BinaryIRTest, Benchmark) {
+    auto *block = mkBlock(50000);
+    auto micros = [](auto duration) {
+        return std::to_string(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto json = toJson(block);
+    auto toJsonTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    std::stringstream in(json);
+    const IR::Node *fromJson = nullptr;
+    JSONLoader(in) >> fromJson;
+    auto fromJsonTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    auto binary = toBinary(block);
+    auto toBinaryTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    auto *fromBinary = loadBinary(binary);
+    auto fromBinaryTime = std::chrono::steady_clock::now() - start;
+
+    ASSERT_NE(fromJson, nullptr);
+    ASSERT_NE(fromBinary, nullptr);
+    RecordProperty("json_bytes", std::to_string(json.size()));
+    RecordProperty("binary_bytes", std::to_string(binary.size()));
+    RecordProperty("to_json_us", micros(toJsonTime));
+    RecordProperty("from_json_us", micros(fromJsonTime));
+    RecordProperty("to_binary_us", micros(toBinaryTime));
+    RecordProperty("from_binary_us", micros(fromBinaryTime));
+}
+
+}  // namespace Test
@@ -0,0 +1,193 @@
+#include "lib/compile_server.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace Test {
+
+namespace {
+
+/// Counts the compilations of a server process, and writes the count and the arguments of the
+/// last compilation to "compiled.txt" in the working directory of the request. With --read,
+/// also writes the first line of the standard input.
+int compilations = 0;
+
+int fakeCompile(int argc, char *const argv[]) {
+    compilations++;
+    std::ofstream out("compiled.txt");
+    out << compilations;
+    for (int i = 1; i < argc; i++) out << ' ' << argv[i];
+    if (argc > 1 && std::string(argv[1]) == "--read") {
+        std::string line;
+        std::getline(std::cin, line);
+        out << ' ' << line;
+    }
+    out.close();
+    if (argc > 1 && std::string(argv[1]) == "--exit") exit(0);
+    return argc - 1;
+}
+
+int runMain(std::vector<const char *> args) {
+    args.insert(args.begin(), "compiler");
+    args.push_back(nullptr);
+    return CompileServer::main(static_cast<int>(args.size()) - 1,
+                               const_cast<char *const *>(args.data()), fakeCompile);
+}
+
+std::string compiled() {
+    std::ifstream in("compiled.txt");
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+}  // namespace
+
+class CompileServerTest : public ::testing::Test {
+ protected:
+    std::string dir, socket;
+    pid_t server = -1;
+    int cwd = -1;
+
+    void SetUp() override {
+        char tmpl[] = "/tmp/p4c-compile-server-XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir = tmpl;
+        socket = dir + "/socket";
+        server = fork();
+        ASSERT_GE(server, 0);
+        if (server == 0) _exit(runMain({"--server", socket.c_str()}));
+        struct stat st;
+        for (int i = 0; i < 100 && stat(socket.c_str(), &st) != 0; i++) usleep(10000);
+        cwd = open(".", O_RDONLY);
+        ASSERT_EQ(chdir(dir.c_str()), 0);
+    }
+
+    void TearDown() override {
+        if (server > 0) {
+            kill(server, SIGTERM);
+            int status = 0;
+            waitpid(server, &status, 0);
+            EXPECT_TRUE(WIFEXITED(status));
+            EXPECT_EQ(WEXITSTATUS(status), 0);
+        }
+        if (cwd >= 0) {
+            EXPECT_EQ(fchdir(cwd), 0);
+            close(cwd);
+        }
+        unlink((dir + "/compiled.txt").c_str());
+        unlink((dir + "/input.txt").c_str());
+        rmdir(dir.c_str());
+    }
+
+    /// Sends a request with @p text as its standard input.
+    int runWithInput(const std::string &text, std::vector<const char *> args) {
+        std::ofstream(dir + "/input.txt") << text;
+        int input = open((dir + "/input.txt").c_str(), O_RDONLY);
+        int saved = dup(STDIN_FILENO);
+        dup2(input, STDIN_FILENO);
+        close(input);
+        int rv = runMain(args);
+        dup2(saved, STDIN_FILENO);
+        close(saved);
+        return rv;
+    }
+};
+
+TEST_F(CompileServerTest, requests) {
+    EXPECT_EQ(runMain({"a", "--client", socket.c_str(), "b"}), 2);
+    EXPECT_EQ(compiled(), "1 a b");
+    // The worker keeps its state between requests.
+    EXPECT_EQ(runMain({"--client", socket.c_str(), "c"}), 1);
+    EXPECT_EQ(compiled(), "2 c");
+}
+
+TEST_F(CompileServerTest, restart) {
+    EXPECT_EQ(runMain({"--client", socket.c_str(), "--exit"}), 1);
+    EXPECT_EQ(compiled(), "1 --exit");
+    // A new worker handles the next request.
+    EXPECT_EQ(runMain({"--client", socket.c_str(), "d"}), 1);
+    EXPECT_EQ(compiled(), "1 d");
+}
+
+TEST_F(CompileServerTest, inputOfEachRequest) {
+    // The worker reads ahead the rest of the first input, which the second request must not see.
+    EXPECT_EQ(runWithInput("first\nsecond\n", {"--client", socket.c_str(), "--read"}), 1);
+    EXPECT_EQ(compiled(), "1 --read first");
+    EXPECT_EQ(runWithInput("third\n", {"--client", socket.c_str(), "--read"}), 1);
+    EXPECT_EQ(compiled(), "2 --read third");
+}
+
+TEST_F(CompileServerTest, rejectsTruncatedDescriptors) {
+    // A request that passes more descriptors than the standard streams does not fit into the
+    // control message the server receives, so some of its descriptors are lost.
+    int connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(connection, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+
+    std::string payload = dir + '\0' + "e" + '\0';
+    uint32_t size = payload.size();
+    iovec iov[] = {{&size, sizeof(size)}, {payload.data(), payload.size()}};
+    int streams[] = {STDIN_FILENO,  STDOUT_FILENO, STDERR_FILENO,
+                     STDERR_FILENO, STDERR_FILENO, STDERR_FILENO};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(streams))];
+    msghdr message = {};
+    message.msg_iov = iov;
+    message.msg_iovlen = 2;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(streams));
+    memcpy(CMSG_DATA(header), streams, sizeof(streams));
+    ASSERT_EQ(sendmsg(connection, &message, MSG_NOSIGNAL),
+              static_cast<ssize_t>(sizeof(size) + payload.size()));
+
+    // The server closes the connection without compiling or answering, and keeps serving. The
+    // connection is reset if the server did not read the whole request.
+    int32_t rv = 0;
+    EXPECT_LE(read(connection, &rv, sizeof(rv)), 0);
+    close(connection);
+    EXPECT_EQ(compiled(), "");
+    EXPECT_EQ(runMain({"--client", socket.c_str(), "f"}), 1);
+    EXPECT_EQ(compiled(), "1 f");
+}
+
+TEST(CompileServer, keepsOtherFiles) {
+    char tmpl[] = "/tmp/p4c-compile-server-XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    std::string file = std::string(tmpl) + "/socket";
+    std::ofstream(file) << "not a socket";
+    EXPECT_EQ(runMain({"--server", file.c_str()}), 1);
+    struct stat st;
+    EXPECT_EQ(stat(file.c_str(), &st), 0);
+    unlink(file.c_str());
+    rmdir(tmpl);
+}
+
+TEST(CompileServer, withoutServer) {
+    EXPECT_FALSE(CompileServer::isRunning());
+    EXPECT_EQ(runMain({"x", "y", "z"}), 3);
+    EXPECT_EQ(runMain({"--client", "/nonexistent/socket"}), 1);
+}
+
+}  // namespace Test
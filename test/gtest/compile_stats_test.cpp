@@ -0,0 +1,157 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/compileStats.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "config.h"
+#include "frontends/common/options.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/json_parser.h"
+#include "lib/error.h"
+#include "lib/timer.h"
+
+namespace Test {
+
+namespace {
+
+const IR::P4Program *program() {
+    auto *program = new IR::P4Program();
+    program->objects.push_back(new IR::Declaration_Constant(
+        IR::ID("c"), IR::Type_Bits::get(8), new IR::Constant(IR::Type_Bits::get(8), 1)));
+    return program;
+}
+
+/// @returns the member @p name of the JSON object @p json, or nullptr.
+JsonData *member(JsonData *json, const std::string &name) {
+    auto *object = json != nullptr ? json->to<JsonObject>() : nullptr;
+    if (object == nullptr || object->count(name) == 0) return nullptr;
+    return object->at(name);
+}
+
+/// @returns the value of the JSON number @p json, or -1 if it is not a number.
+int64_t number(JsonData *json) {
+    auto *value = json != nullptr ? json->to<JsonNumber>() : nullptr;
+    return value != nullptr ? static_cast<int64_t>(value->val) : -1;
+}
+
+/// @returns the value of the JSON string @p json, or "<none>" if it is not a string.
+std::string text(JsonData *json) {
+    auto *value = json != nullptr ? json->to<JsonString>() : nullptr;
+    return value != nullptr ? std::string(*value) : "<none>";
+}
+
+}  // namespace
+
+class CompileStatsTest : public P4CTest {
+ protected:
+    std::string dir;
+    CompilerOptions options;
+
+    void SetUp() override {
+        char tmpl[] = "/tmp/p4c-compile-stats-XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir = tmpl;
+        options.compilerVersion = "1.2.3";
+        options.file = "prog.p4";
+        options.statsJsonFile = cstring(dir + "/stats.json");
+        Util::resetTimers();
+    }
+    void TearDown() override {
+        Util::resetTimers();
+        std::filesystem::remove_all(dir);
+    }
+
+    /// @returns the parsed statistics file, or nullptr if it was not written.
+    JsonData *read() const {
+        std::ifstream in(options.statsJsonFile.c_str());
+        if (!in) return nullptr;
+        JsonData *json = nullptr;
+        in >> json;
+        return json;
+    }
+};
+
+TEST_F(CompileStatsTest, writesJson) {
+    Util::withTimer("parse", [] {});
+    Util::incrementCounter("passes", 3);
+    P4::writeCompileStats(options, program());
+
+    auto *json = read();
+    ASSERT_NE(json, nullptr);
+    EXPECT_EQ(text(member(json, "compilerVersion")), "1.2.3");
+    EXPECT_EQ(text(member(json, "program")), "prog.p4");
+    EXPECT_EQ(number(member(json, "errors")), 0);
+    EXPECT_GE(number(member(member(json, "timersMs"), "parse")), 0);
+    EXPECT_EQ(number(member(member(json, "counters"), "passes")), 3);
+
+    auto *memory = member(json, "memory");
+    EXPECT_GT(number(member(memory, "peakRssBytes")), 0);
+    EXPECT_EQ(member(memory, "serverPeakRssBytes"), nullptr);
+#if HAVE_LIBGC
+    EXPECT_GT(number(member(memory, "gcHeapBytes")), 0);
+#else
+    EXPECT_EQ(number(member(memory, "gcHeapBytes")), 0);
+#endif
+
+    // The shared Type_Bits is counted once.
+    auto *nodes = member(json, "irNodes");
+    auto *byClass = member(nodes, "byClass");
+    EXPECT_EQ(number(member(byClass, "P4Program")), 1);
+    EXPECT_EQ(number(member(byClass, "Declaration_Constant")), 1);
+    EXPECT_EQ(number(member(byClass, "Constant")), 1);
+    EXPECT_EQ(number(member(byClass, "Type_Bits")), 1);
+    int64_t total = 0;
+    for (auto &c : *byClass->to<JsonObject>()) total += number(c.second);
+    EXPECT_EQ(number(member(nodes, "total")), total);
+}
+
+TEST_F(CompileStatsTest, noFileWithoutOption) {
+    options.statsJsonFile = nullptr;
+    P4::writeCompileStats(options, program());
+    EXPECT_TRUE(std::filesystem::is_empty(dir));
+}
+
+TEST_F(CompileStatsTest, writerWritesOnFailure) {
+    // A driver that fails before it has a program.
+    [this] {
+        const IR::P4Program *program = nullptr;
+        P4::CompileStatsWriter statsWriter(options, program);
+        ::error(ErrorType::ERR_INVALID, "%1%: cannot parse", "prog.p4");
+    }();
+    auto *json = read();
+    ASSERT_NE(json, nullptr);
+    EXPECT_EQ(number(member(json, "errors")), 1);
+    EXPECT_EQ(member(json, "irNodes"), nullptr);
+
+    // The writer counts the nodes of the last program of the driver.
+    [this] {
+        const IR::P4Program *program = nullptr;
+        P4::CompileStatsWriter statsWriter(options, program);
+        program = ::Test::program();
+    }();
+    json = read();
+    ASSERT_NE(json, nullptr);
+    EXPECT_EQ(number(member(member(member(json, "irNodes"), "byClass"), "Constant")), 1);
+}
+
+}  // namespace Test
@@ -0,0 +1,141 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "test/gtest/helpers.h"
+
+namespace Test {
+
+namespace {
+
+std::optional<FrontendTestCase> createConstEntriesTestCase(const std::string &entries) {
+    auto source = P4_SOURCE(P4Headers::V1MODEL, R"(
+        header h_t { bit<8> a; bit<16> b; }
+        struct Headers { h_t h; }
+        struct Metadata { }
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { p.extract(h.h); transition accept; } }
+        control checksum(inout Headers h, inout Metadata m) { apply { } }
+        control ingress(inout Headers h, inout Metadata m, inout standard_metadata_t sm) {
+            action set(bit<9> port) { sm.egress_spec = port; }
+            table t {
+                key = { h.h.a : exact; h.h.b : ternary; }
+                actions = { set; }
+                const entries = {
+%ENTRIES%
+                }
+            }
+            apply { t.apply(); }
+        }
+        control egress(inout Headers h, inout Metadata m,
+                       inout standard_metadata_t sm) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { p.emit(h.h); } }
+        V1Switch(parse(), checksum(), ingress(), egress(), checksum(), deparse()) main;
+    )");
+
+    boost::replace_first(source, "%ENTRIES%", entries);
+    return FrontendTestCase::create(source);
+}
+
+std::vector<const IR::Entry *> entries(const IR::P4Program *program) {
+    std::vector<const IR::Entry *> result;
+    forAllMatching<IR::Entry>(program, [&](const IR::Entry *entry) { result.push_back(entry); });
+    return result;
+}
+
+/// Checks that @p key is a constant of type bit<@p width> with value @p value.
+void expectConstant(const IR::Expression *key, int width, int value) {
+    auto constant = key->to<IR::Constant>();
+    ASSERT_NE(constant, nullptr) << key;
+    auto type = constant->type->to<IR::Type_Bits>();
+    ASSERT_NE(type, nullptr) << constant->type;
+    EXPECT_EQ(type->width_bits(), width);
+    EXPECT_EQ(constant->asInt(), value);
+}
+
+}  // namespace
+
+class ConstEntries : public P4CTest {};
+
+TEST_F(ConstEntries, LiteralKeys) {
+    auto test = createConstEntriesTestCase(P4_SOURCE(R"(
+        (1, 2) : set(1);
+        (8w3, 16w4) : set(2);
+        (5, _) : set(3);
+        (6, 0x10 &&& 0xf0) : set(4);
+    )"));
+    ASSERT_TRUE(test);
+    EXPECT_EQ(0u, ::diagnosticCount());
+
+    auto all = entries(test->program);
+    ASSERT_EQ(all.size(), 4u);
+    expectConstant(all[0]->keys->components.at(0), 8, 1);
+    expectConstant(all[0]->keys->components.at(1), 16, 2);
+    expectConstant(all[1]->keys->components.at(0), 8, 3);
+    expectConstant(all[1]->keys->components.at(1), 16, 4);
+    expectConstant(all[2]->keys->components.at(0), 8, 5);
+    EXPECT_TRUE(all[2]->keys->components.at(1)->is<IR::DefaultExpression>());
+    expectConstant(all[3]->keys->components.at(0), 8, 6);
+    auto mask = all[3]->keys->components.at(1)->to<IR::Mask>();
+    ASSERT_NE(mask, nullptr);
+    expectConstant(mask->left, 16, 0x10);
+    expectConstant(mask->right, 16, 0xf0);
+}
+
+TEST_F(ConstEntries, Overflow) {
+    auto test = createConstEntriesTestCase(P4_SOURCE(R"(
+        (256, 1) : set(1);
+    )"));
+    ASSERT_TRUE(test);
+    // The value does not fit in bit<8>; it is truncated, as with type unification.
+    EXPECT_LE(1u, ::diagnosticCount());
+    EXPECT_EQ(0u, ::errorCount());
+    auto all = entries(test->program);
+    ASSERT_EQ(all.size(), 1u);
+    expectConstant(all[0]->keys->components.at(0), 8, 0);
+}
+
+TEST_F(ConstEntries, TypeErrors) {
+    auto test = createConstEntriesTestCase(P4_SOURCE(R"(
+        (1, 2, 3) : set(1);
+    )"));
+    EXPECT_FALSE(test);
+    EXPECT_LT(0u, ::errorCount());
+}
+
+TEST_F(ConstEntries, ManyEntries) {
+    std::string list;
+    const int count = 5000;
+    for (int i = 0; i < count; i++) {
+        list += "(" + std::to_string(i % 256) + ", " + std::to_string(i) + ") : set(" +
+                std::to_string(i % 512) + ");\n";
+    }
+    auto test = createConstEntriesTestCase(list);
+    ASSERT_TRUE(test);
+    auto all = entries(test->program);
+    ASSERT_EQ(all.size(), static_cast<size_t>(count));
+    expectConstant(all[count - 1]->keys->components.at(0), 8, (count - 1) % 256);
+    expectConstant(all[count - 1]->keys->components.at(1), 16, count - 1);
+}
+
+}  // namespace Test
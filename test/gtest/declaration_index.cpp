@@ -0,0 +1,138 @@
+#include "ir/declaration_index.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+using namespace IR;
+
+const Declaration_Constant *testConstant(cstring name, int value) {
+    return new Declaration_Constant(ID(name), Type_Bits::get(8), new Constant(value));
+}
+
+P4Program *wideProgram(size_t width) {
+    auto *program = new P4Program();
+    for (size_t i = 0; i < width; i++) {
+        program->objects.push_back(
+            testConstant("c" + std::to_string(i), static_cast<int>(i % 256)));
+    }
+    return program;
+}
+
+TEST(DeclarationIndex, lookup) {
+    auto *program = wideProgram(20000);
+    for (size_t i = 0; i < program->objects.size(); i += 997) {
+        cstring name = "c" + std::to_string(i);
+        const auto &decls = program->getDeclarationsByName(name);
+        ASSERT_EQ(decls.size(), 1u);
+        EXPECT_EQ(decls[0]->getNode(), program->objects[i]);
+        EXPECT_EQ(program->getDeclsByName(name)->count(), 1u);
+    }
+    EXPECT_TRUE(program->getDeclarationsByName("missing").empty());
+}
+
+TEST(DeclarationIndex, duplicates) {
+    auto *program = wideProgram(10);
+    program->objects.push_back(testConstant("c3", 42));
+    const auto &decls = program->getDeclarationsByName("c3");
+    ASSERT_EQ(decls.size(), 2u);
+    EXPECT_EQ(decls[0]->getNode(), program->objects[3]);
+    EXPECT_EQ(decls[1]->getNode(), program->objects[10]);
+}
+
+TEST(DeclarationIndex, modification) {
+    auto *program = wideProgram(10);
+    EXPECT_EQ(program->getDeclarationsByName("c5").size(), 1u);
+
+    // Replacing an object in place keeps the size and the storage of the objects.
+    program->objects[5] = testConstant("d5", 5);
+    EXPECT_TRUE(program->getDeclarationsByName("c5").empty());
+    ASSERT_EQ(program->getDeclarationsByName("d5").size(), 1u);
+
+    program->objects.push_back(testConstant("c5", 6));
+    ASSERT_EQ(program->getDeclarationsByName("c5").size(), 1u);
+    EXPECT_EQ(program->getDeclarationsByName("c5")[0]->getNode(), program->objects[10]);
+}
+
+TEST(DeclarationIndex, replacementFoundFirst) {
+    auto *program = wideProgram(10);
+    EXPECT_EQ(program->getDeclarationsByName("c5").size(), 1u);
+
+    // The new name is looked up before the replaced one.
+    program->objects[5] = testConstant("d5", 5);
+    ASSERT_EQ(program->getDeclarationsByName("d5").size(), 1u);
+    EXPECT_EQ(program->getDeclarationsByName("d5")[0]->getNode(), program->objects[5]);
+    EXPECT_TRUE(program->getDeclarationsByName("c5").empty());
+}
+
+TEST(DeclarationIndex, rebuild) {
+    auto *program = wideProgram(10);
+    const auto &decls = program->getDeclarationsByName("c2");
+    ASSERT_EQ(decls.size(), 1u);
+    auto revision = program->objects.revision();
+    EXPECT_TRUE(program->getDeclarationsByName("missing").empty());
+    EXPECT_EQ(program->objects.revision(), revision);
+
+    // Results of earlier lookups stay valid and follow the modified objects.
+    program->objects.push_back(testConstant("c2", 2));
+    EXPECT_NE(program->objects.revision(), revision);
+    EXPECT_EQ(&program->getDeclarationsByName("c2"), &decls);
+    ASSERT_EQ(decls.size(), 2u);
+    EXPECT_EQ(decls[1]->getNode(), program->objects[10]);
+    program->objects[2] = testConstant("d2", 2);
+    EXPECT_TRUE(program->getDeclarationsByName("missing").empty());
+    EXPECT_EQ(decls.size(), 1u);
+}
+
+TEST(DeclarationIndex, clone) {
+    auto *program = wideProgram(10);
+    EXPECT_EQ(program->getDeclarationsByName("c1").size(), 1u);
+
+    auto *clone = program->clone();
+    clone->objects[1] = testConstant("d1", 1);
+    EXPECT_TRUE(clone->getDeclarationsByName("c1").empty());
+    EXPECT_EQ(clone->getDeclarationsByName("d1").size(), 1u);
+    EXPECT_EQ(program->getDeclarationsByName("c1").size(), 1u);
+}
+
+// Compares indexed lookups in a wide program with scans of its objects. Most lookups of the
+// reference resolution and of the shadowing checks are for names the program does not declare.
+TEST(DeclarationIndex, WideProgramThroughput) {
+    auto *program = wideProgram(20000);
+    std::vector<cstring> names;
+    for (size_t i = 0; i < 2000; i++) {
+        names.push_back("c" + std::to_string(i * 10));
+        names.push_back("missing" + std::to_string(i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t indexedFound = 0;
+    for (auto name : names) indexedFound += program->getDeclarationsByName(name).size();
+    auto indexedTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    size_t scannedFound = 0;
+    for (auto name : names) {
+        for (const auto *object : program->objects) {
+            const auto *decl = dynamic_cast<const IDeclaration *>(object);
+            if (decl != nullptr && decl->getName().name == name) scannedFound++;
+        }
+    }
+    auto scanTime = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(indexedFound, 2000u);
+    EXPECT_EQ(indexedFound, scannedFound);
+    auto micros = [](auto duration) {
+        return std::to_string(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+    RecordProperty("indexed_us", micros(indexedTime));
+    RecordProperty("scan_us", micros(scanTime));
+}
+
+}  // namespace Test
@@ -0,0 +1,82 @@
+#include "ir/dense_node_map.h"
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+using namespace IR;
+
+struct VisitInfo {
+    bool done, visitOnce;
+};
+
+TEST(DenseNodeMap, basics) {
+    DenseNodeMap<VisitInfo> map;
+    auto *first = new Constant(1);
+    auto *second = new Constant(2);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(first), nullptr);
+    // Visitors look up absent children too.
+    EXPECT_EQ(map.find(nullptr), nullptr);
+
+    auto inserted = map.emplace(first, VisitInfo{false, true});
+    EXPECT_TRUE(inserted.second);
+    EXPECT_EQ(map.find(first), inserted.first);
+    auto again = map.emplace(first, VisitInfo{true, false});
+    EXPECT_FALSE(again.second);
+    EXPECT_EQ(again.first, inserted.first);
+    EXPECT_FALSE(again.first->done);
+
+    map.emplace(second, VisitInfo{true, true});
+    EXPECT_EQ(map.size(), 2u);
+    map.erase_if([](const Node *, const VisitInfo &info) { return info.done; });
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.count(second), 0u);
+    EXPECT_EQ(map.count(first), 1u);
+    // An erased slot is free for the next node with its id.
+    auto reinserted = map.emplace(second, VisitInfo{false, false});
+    EXPECT_TRUE(reinserted.second);
+    EXPECT_FALSE(reinserted.first->done);
+    EXPECT_EQ(map.size(), 2u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(first), nullptr);
+    EXPECT_TRUE(map.emplace(first, VisitInfo{false, false}).second);
+}
+
+TEST(DenseNodeMap, sharedIds) {
+    // Nodes loaded from a file may share their id with other nodes.
+    DenseNodeMap<VisitInfo> map;
+    auto *first = new Constant(1);
+    auto *second = new Constant(2);
+    second->id = first->id;
+    auto *firstInfo = map.emplace(first, VisitInfo{false, true}).first;
+    auto *secondInfo = map.emplace(second, VisitInfo{true, false}).first;
+    EXPECT_NE(firstInfo, secondInfo);
+    EXPECT_EQ(map.find(first), firstInfo);
+    EXPECT_EQ(map.find(second), secondInfo);
+
+    map.erase_if([](const Node *node, const VisitInfo &) { return node->is<Constant>(); });
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(DenseNodeMap, reusedForTraversals) {
+    // Each traversal visits nodes of another id range, like the passes of a compilation.
+    DenseNodeMap<VisitInfo> map;
+    for (int traversal = 1; traversal <= 100; traversal++) {
+        for (int i = 0; i < 20; i++) {
+            auto *node = new Constant(i);
+            node->id = traversal * 1024 + i;
+            map.emplace(node, VisitInfo{false, false});
+        }
+        // The nodes are stored in a page of their own, next to the page kept from the previous
+        // traversal; the pages of earlier traversals have been released.
+        EXPECT_EQ(map.pageCount(), traversal == 1 ? 1u : 2u);
+        map.clear();
+        EXPECT_EQ(map.pageCount(), 1u);
+    }
+}
+
+}  // namespace Test
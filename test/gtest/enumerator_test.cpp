@@ -16,10 +16,14 @@ limitations under the License.
 
 #include "lib/enumerator.h"
 
+#include <cstdint>
 #include <exception>
+#include <iterator>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "lib/iterator_range.h"
 
 namespace Util {
 
@@ -203,4 +207,71 @@ TEST_F(UtilEnumerator, Linq) {
     }
 }
 
+TEST_F(UtilEnumerator, Ranges) {
+    struct Base {
+        int a;
+        explicit Base(int a) : a(a) {}
+        virtual ~Base() {}
+    };
+    struct Derived : public Base {
+        explicit Derived(int a) : Base(a) {}
+    };
+    std::vector<const Base *> objects{new Derived(1), new Base(2), nullptr, new Derived(3)};
+    std::vector<int> values;
+    for (auto *d : Util::only<const Derived *>(objects)) values.push_back(d->a);
+    EXPECT_EQ(values, (std::vector<int>{1, 3}));
+
+    auto odd = Util::filter(vec, [](int i) { return i % 2 == 1; });
+    auto squares = Util::transform(odd, [](int i) { return i * i; });
+    EXPECT_EQ(std::vector<int>(squares.begin(), squares.end()), (std::vector<int>{1, 9}));
+    EXPECT_TRUE(Util::filter(vec, [](int i) { return i > 3; }).empty());
+}
+
+// A range chain yields the same elements as the equivalent enumerator chain.
+TEST_F(UtilEnumerator, RangesMatchEnumerators) {
+    std::vector<int> data(100);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<int>(i);
+
+    std::vector<int64_t> enumerated;
+    for (auto i : *Enumerator<int>::createEnumerator(data)
+                       ->where([](const int &i) { return i % 3 == 0; })
+                       ->map<int64_t>([](const int &i) { return int64_t(i) * 2; }))
+        enumerated.push_back(i);
+    auto range = Util::transform(Util::filter(data, [](int i) { return i % 3 == 0; }),
+                                 [](int i) { return int64_t(i) * 2; });
+    EXPECT_EQ(std::vector<int64_t>(range.begin(), range.end()), enumerated);
+    EXPECT_EQ(enumerated.size(), 34u);
+}
+
+TEST_F(UtilEnumerator, RangeIterators) {
+    auto whole = Util::make_range(vec.begin(), vec.end());
+    EXPECT_FALSE(whole.empty());
+    EXPECT_EQ(std::vector<int>(whole.begin(), whole.end()), vec);
+    EXPECT_TRUE(Util::make_range(vec.end(), vec.end()).empty());
+
+    // Filter iterators can be copied and assigned although the predicate is a lambda.
+    auto odd = Util::filter(vec, [](int i) { return i % 2 == 1; });
+    auto it = odd.begin();
+    EXPECT_EQ(*it, 1);
+    auto copy = it++;
+    EXPECT_EQ(*copy, 1);
+    EXPECT_EQ(*it, 3);
+    copy = it;
+    EXPECT_TRUE(copy == it);
+    EXPECT_TRUE(++copy == odd.end());
+    EXPECT_TRUE(it != odd.end());
+
+    auto doubled = Util::transform(vec, [](int i) { return 2 * i; });
+    auto dit = doubled.begin();
+    EXPECT_EQ(*dit++, 2);
+    EXPECT_EQ(*dit, 4);
+    EXPECT_EQ(std::distance(doubled.begin(), doubled.end()), 3);
+
+    // A range refers to its container instead of copying it.
+    std::vector<int> values{1, 2, 3};
+    auto large = Util::filter(values, [](int i) { return i > 1; });
+    values[2] = 7;
+    EXPECT_EQ(std::vector<int>(large.begin(), large.end()), (std::vector<int>{2, 7}));
+}
+
 }  // namespace Util
@@ -72,4 +72,86 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonWriter) {
+    // The writer must produce the same layout as the tree serialization.
+    auto arr = new JsonArray();
+    arr->append(5);
+    arr->append("5");
+    auto arr1 = new JsonArray();
+    arr1->append(true);
+    arr->append(arr1);
+    arr->append(new JsonArray());
+    auto obj = new JsonObject();
+    obj->emplace("x", "x");
+    obj->emplace("y", arr);
+    obj->emplace("z", new JsonObject());
+
+    std::ostringstream out;
+    JsonWriter writer(out);
+    writer.beginObject().field("x", "x").key("y").beginArray();
+    writer.value(5).value("5").beginArray(true).value(true).endArray();
+    writer.beginArray().endArray().endArray();
+    writer.key("z").beginObject().endObject().endObject();
+    EXPECT_EQ(obj->toString(), out.str());
+
+    std::ostringstream numbers;
+    JsonWriter numberWriter(numbers);
+    numberWriter.beginArray(true).value(-123456789000LL).value(123456789000ULL);
+    numberWriter.value(big_int(1) << 80).null().endArray();
+    EXPECT_EQ("[-123456789000, 123456789000, 1208925819614629174706176, null]", numbers.str());
+
+    std::ostringstream escaped;
+    JsonWriter(escaped).value("a\"b\\c\nd\x01");
+    EXPECT_EQ("\"a\\\"b\\\\c\\nd\\u0001\"", escaped.str());
+
+    EXPECT_THROW(JsonWriter(escaped).beginObject().value(1), std::logic_error);
+    EXPECT_THROW(JsonWriter(escaped).beginArray().endObject(), std::logic_error);
+}
+
+TEST(Util, JsonStream) {
+    // A table with const entries, laid out as the BMv2 back end writes them.
+    big_int priority = big_int(1) << 40;
+    auto sourceInfo = new JsonObject();
+    sourceInfo->emplace("filename", "t.p4");
+    sourceInfo->emplace("line", 7);
+    // The tree holds strings escaped by cstring::escapeJson, the writer escapes them itself.
+    sourceInfo->emplace("source_fragment",
+                        cstring("0x0a &&& 0xff: a(\"x\\\b\f\x01\");").escapeJson());
+    auto matchKey = new JsonObject();
+    matchKey->emplace("match_type", "ternary");
+    matchKey->emplace("key", "0x0a");
+    matchKey->emplace("mask", "0xff");
+    auto actionData = new JsonArray();
+    actionData->append("0x01");
+    actionData->append("0x0002");
+    auto actionEntry = new JsonObject();
+    actionEntry->emplace("action_id", 3);
+    actionEntry->emplace("action_data", actionData);
+    auto entry = new JsonObject();
+    entry->emplace("source_info", sourceInfo);
+    entry->emplace("match_key", new JsonArray({matchKey}));
+    entry->emplace("action_entry", actionEntry);
+    entry->emplace("priority", priority);
+    auto expected = new JsonObject();
+    expected->emplace("name", "t");
+    expected->emplace("entries", new JsonArray({entry}));
+    expected->emplace("note", cstring("\b\f\n\r\t\"\\\x1f").escapeJson());
+
+    auto obj = new JsonObject();
+    obj->emplace("name", "t");
+    obj->emplace("entries", new JsonStream([sourceInfo, priority](JsonWriter &entries) {
+        entries.beginArray().beginObject().field("source_info", sourceInfo);
+        entries.key("match_key").beginArray().beginObject();
+        entries.field("match_type", "ternary").field("key", "0x0a").field("mask", "0xff");
+        entries.endObject().endArray();
+        entries.key("action_entry").beginObject().field("action_id", 3);
+        entries.key("action_data").beginArray(true).value("0x01").value("0x0002").endArray();
+        entries.endObject().field("priority", priority).endObject().endArray();
+    }));
+    obj->emplace("note", new JsonStream([](JsonWriter &note) {
+        note.value("\b\f\n\r\t\"\\\x1f");
+    }));
+    EXPECT_EQ(expected->toString(), obj->toString());
+}
+
 }  // namespace Util
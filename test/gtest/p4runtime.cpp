@@ -16,10 +16,13 @@ limitations under the License.
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/message_differencer.h>
 
 #include <iterator>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -1159,6 +1162,104 @@ TEST_F(P4Runtime, StaticTableEntries) {
     }
 }
 
+namespace {
+
+/// A program with a table holding 5 static entries.
+std::string staticEntriesProgram() {
+    return P4_SOURCE(P4Headers::V1MODEL, R"(
+        header Header { bit<8> hfA; }
+        struct Headers { Header h; }
+        struct Metadata { }
+
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            action a_with_control_params(bit<9> x) { sm.egress_spec = x; }
+            table t_exact {
+                key = { h.h.hfA : exact; }
+                actions = { a_with_control_params; }
+                default_action = a_with_control_params(0);
+                const entries = {
+                    (0x01) : a_with_control_params(1);
+                    (0x02) : a_with_control_params(2);
+                    (0x03) : a_with_control_params(3);
+                    (0x04) : a_with_control_params(4);
+                    (0x05) : a_with_control_params(5);
+                }
+            }
+            apply { t_exact.apply(); }
+        }
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )");
+}
+
+/// @return the sizes of the length-delimited WriteRequest messages in @stream,
+/// checking that they hold the updates of @expected in order.
+std::vector<int> readEntryBatches(std::istream &stream, const p4v1::WriteRequest &expected) {
+    google::protobuf::io::IstreamInputStream input(&stream);
+    std::vector<int> batchSizes;
+    int index = 0;
+    p4v1::WriteRequest batch;
+    bool cleanEof = false;
+    while (google::protobuf::util::ParseDelimitedFromZeroCopyStream(&batch, &input, &cleanEof)) {
+        batchSizes.push_back(batch.updates_size());
+        for (const auto &update : batch.updates()) {
+            EXPECT_LT(index, expected.updates_size());
+            if (index >= expected.updates_size()) break;
+            EXPECT_TRUE(MessageDifferencer::Equals(expected.updates(index++), update));
+        }
+    }
+    EXPECT_TRUE(cleanEof);
+    return batchSizes;
+}
+
+}  // namespace
+
+TEST_F(P4Runtime, StaticTableEntryBatches) {
+    auto test = createP4RuntimeTestCase(staticEntriesProgram());
+
+    ASSERT_TRUE(test);
+    EXPECT_EQ(0u, ::diagnosticCount());
+    ASSERT_EQ(5, test->entries->updates_size());
+
+    std::stringstream stream;
+    test->serializeEntryBatchesTo(&stream, 2);
+    EXPECT_EQ(0u, ::diagnosticCount());
+
+    // Expect batches of 2, 2 and 1 updates which together hold all the entries in order.
+    EXPECT_EQ(std::vector<int>({2, 2, 1}), readEntryBatches(stream, *test->entries));
+}
+
+TEST_F(P4Runtime, StaticTableEntriesStreamedInBatches) {
+    auto frontendTestCase = FrontendTestCase::create(staticEntriesProgram());
+    ASSERT_TRUE(frontendTestCase);
+    auto expected = P4::generateP4Runtime(frontendTestCase->program, defaultArch);
+    ASSERT_EQ(5, expected.entries->updates_size());
+
+    // The batches are passed on while the entries are converted, so none of them stay in the
+    // generated API.
+    std::stringstream stream;
+    auto streamed = P4::generateP4Runtime(
+        frontendTestCase->program, defaultArch, 2,
+        [&](const p4v1::WriteRequest &batch) {
+            EXPECT_LE(batch.updates_size(), 2);
+            google::protobuf::util::SerializeDelimitedToOstream(batch, &stream);
+        });
+    EXPECT_EQ(0u, ::diagnosticCount());
+    EXPECT_EQ(0, streamed.entries->updates_size());
+    EXPECT_TRUE(MessageDifferencer::Equals(*expected.p4Info, *streamed.p4Info));
+    EXPECT_EQ(std::vector<int>({2, 2, 1}), readEntryBatches(stream, *expected.entries));
+}
+
 TEST_F(P4Runtime, IsConstTable) {
     auto test = createP4RuntimeTestCase(P4_SOURCE(P4Headers::V1MODEL, R"(
         header Header { bit<8> hfA; }
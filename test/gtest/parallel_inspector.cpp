@@ -0,0 +1,128 @@
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/exceptions.h"
+#include "midend/coverage.h"
+
+namespace Test {
+
+using namespace IR;
+
+/// Collects the names of the constants of a program and the nodes below them.
+class CollectConstants : public ParallelInspector {
+ public:
+    std::vector<cstring> names;
+    std::set<const Node *> nodes;
+    size_t outsideProgram = 0;
+    cstring failOn;
+
+    bool preorder(const Declaration_Constant *constant) override {
+        if (constant->name.name == failOn) BUG("failing on %1%", constant);
+        if (findContext<P4Program>() == nullptr) outsideProgram++;
+        names.push_back(constant->name);
+        return true;
+    }
+    void postorder(const Node *node) override { nodes.insert(node); }
+
+    ParallelInspector *newWorker() const override {
+        auto *worker = new CollectConstants;
+        worker->failOn = failOn;
+        return worker;
+    }
+    void reduce(ParallelInspector &worker) override {
+        auto &collected = dynamic_cast<CollectConstants &>(worker);
+        names.insert(names.end(), collected.names.begin(), collected.names.end());
+        nodes.insert(collected.nodes.begin(), collected.nodes.end());
+        outsideProgram += collected.outsideProgram;
+    }
+};
+
+class ParallelInspectorTest : public P4CTest {
+    unsigned savedMaxThreads = ParallelInspector::maxThreads;
+
+ protected:
+    void TearDown() override { ParallelInspector::maxThreads = savedMaxThreads; }
+
+    static const P4Program *program(size_t width) {
+        auto *program = new P4Program();
+        for (size_t i = 0; i < width; i++) {
+            auto *value = new Constant(static_cast<int>(i % 256));
+            program->objects.push_back(
+                new Declaration_Constant(ID("c" + std::to_string(i)), Type_Bits::get(8), value));
+        }
+        return program;
+    }
+};
+
+TEST_F(ParallelInspectorTest, sameAsSequential) {
+    const auto *prog = program(1000);
+    ParallelInspector::maxThreads = 1;
+    CollectConstants sequential;
+    prog->apply(sequential);
+
+    ParallelInspector::maxThreads = 4;
+    CollectConstants parallel;
+    prog->apply(parallel);
+
+    ASSERT_EQ(parallel.names.size(), 1000u);
+    EXPECT_EQ(parallel.names, sequential.names);
+    // Nodes shared by declarations of different chunks, like the interned type bit<8>, are
+    // visited once by each worker, so only the distinct nodes are the same.
+    EXPECT_EQ(parallel.nodes, sequential.nodes);
+    EXPECT_EQ(parallel.outsideProgram, 0u);
+}
+
+TEST_F(ParallelInspectorTest, otherRoots) {
+    ParallelInspector::maxThreads = 4;
+    CollectConstants collect;
+    const auto *constant = program(1)->objects.at(0);
+    constant->apply(collect);
+    EXPECT_EQ(collect.names.size(), 1u);
+    EXPECT_EQ(collect.outsideProgram, 1u);
+}
+
+TEST_F(ParallelInspectorTest, failures) {
+    ParallelInspector::maxThreads = 4;
+    CollectConstants collect;
+    collect.failOn = "c500";
+    EXPECT_THROW(program(1000)->apply(collect), Util::CompilerBug);
+}
+
+TEST_F(ParallelInspectorTest, coverableNodes) {
+    std::string controls;
+    for (int i = 0; i < 40; i++) {
+        controls += "control c" + std::to_string(i) + "(inout bit<8> x) {\n";
+        controls += "    apply {\n";
+        controls += "        x = x + " + std::to_string(i + 1) + ";\n";
+        controls += "        if (x == 0) { exit; }\n";
+        controls += "    }\n}\n";
+    }
+    auto source = P4_SOURCE(P4Headers::CORE, controls.c_str());
+    auto test = FrontendTestCase::create(source);
+    ASSERT_TRUE(test);
+
+    P4::Coverage::CoverageOptions options;
+    options.coverStatements = true;
+    ParallelInspector::maxThreads = 1;
+    P4::Coverage::CollectNodes sequential(options);
+    test->program->apply(sequential);
+
+    ParallelInspector::maxThreads = 4;
+    P4::Coverage::CollectNodes parallel(options);
+    test->program->apply(parallel);
+
+    // An assignment and an exit statement in each control.
+    ASSERT_EQ(parallel.getCoverableNodes().size(), 80u);
+    std::vector<const Node *> sequentialNodes(sequential.getCoverableNodes().begin(),
+                                              sequential.getCoverableNodes().end());
+    std::vector<const Node *> parallelNodes(parallel.getCoverableNodes().begin(),
+                                            parallel.getCoverableNodes().end());
+    EXPECT_EQ(parallelNodes, sequentialNodes);
+}
+
+}  // namespace Test
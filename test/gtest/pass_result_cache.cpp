@@ -0,0 +1,260 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_result_cache.h"
+
+#include <stdlib.h>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frontends/common/options.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/p4/frontend.h"
+#include "frontends/p4/toP4/toP4.h"
+#include "frontends/parsers/parserDriver.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+#include "lib/error.h"
+#include "lib/timer.h"
+
+namespace Test {
+
+namespace {
+
+/// Increments the constants of the program, and counts its runs.
+class Increment : public Transform {
+    unsigned *runs;
+    bool warn;
+
+ public:
+    explicit Increment(unsigned *runs, bool warn = false) : runs(runs), warn(warn) {}
+    const IR::Node *preorder(IR::P4Program *program) override {
+        ++*runs;
+        if (warn) ::warning(ErrorType::WARN_FAILED, "%1%: incremented", "program");
+        return program;
+    }
+    const IR::Node *postorder(IR::Constant *constant) override {
+        return new IR::Constant(constant->type, constant->value + 1);
+    }
+};
+
+/// The checkpoint of the cached passes.
+class Last : public Inspector {
+ public:
+    Last() { setName("Last"); }
+};
+
+/// A program the frontend compiles without diagnostics, so that its result is cached. The
+/// default action of its table increments by @p increment.
+std::string frontEndSource(int increment) {
+    auto source = P4_SOURCE(P4Headers::CORE, R"(
+        header h_t { bit<8> a; bit<8> b; }
+        control c(inout h_t h) {
+            action inc(bit<8> v) { h.a = h.a + v; }
+            table t {
+                key = { h.b : exact; }
+                actions = { inc; }
+                default_action = inc(%INCREMENT%);
+            }
+            apply {
+                t.apply();
+                if (h.a == 2) { h.b = h.a << 1; }
+            }
+        }
+        control C(inout h_t h);
+        package top(C c);
+        top(c()) main;
+    )");
+    boost::replace_first(source, "%INCREMENT%", std::to_string(increment));
+    return source;
+}
+
+/// @returns @p program printed as P4.
+std::string toP4(const IR::Node *program) {
+    std::stringstream out;
+    program->apply(P4::ToP4(&out, false));
+    return out.str();
+}
+
+const IR::P4Program *program(int value) {
+    auto *program = new IR::P4Program();
+    program->objects.push_back(new IR::Declaration_Constant(
+        IR::ID("c"), IR::Type_Bits::get(8), new IR::Constant(IR::Type_Bits::get(8), value)));
+    return program;
+}
+
+}  // namespace
+
+class PassResultCacheTest : public P4CTest {
+ protected:
+    std::string dir;
+    unsigned runs = 0, after = 0, hits = 0;
+
+    void SetUp() override {
+        char tmpl[] = "/tmp/p4c-pass-cache-XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir = tmpl;
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    /// Parses @p source and runs the frontend on it with @p args as the command line, which
+    /// is part of the cache context. @returns the result and sets @p passes to the number of
+    /// passes that ran.
+    const IR::P4Program *runFrontEnd(const std::string &source, std::vector<const char *> args,
+                                     uint64_t &passes) {
+        CompilerOptions options;
+        args.insert(args.begin(), "p4test");
+        args.push_back("prog.p4");
+        options.process(args.size(), const_cast<char **>(args.data()));
+        options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+        const auto *program = P4::parseP4String(source, options.langVersion);
+        if (program == nullptr) return nullptr;
+        auto before = Util::getCounters()["passes"];
+        program = P4::FrontEnd().run(options, program, true);
+        passes = Util::getCounters()["passes"] - before;
+        return program;
+    }
+
+    const IR::Node *run(const IR::Node *input, const std::string &context, bool warn = false) {
+        PassManager passes({new Increment(&runs, warn), new Last, [this]() { after++; }});
+        passes.cacheResults(new PassResultCache(dir), "Last", context, {[this]() { hits++; }});
+        return input->apply(passes);
+    }
+};
+
+TEST_F(PassResultCacheTest, reusesResults) {
+    auto *first = run(program(1), "options");
+    EXPECT_EQ(runs, 1u);
+    EXPECT_EQ(hits, 0u);
+
+    auto *second = run(program(1), "options");
+    EXPECT_EQ(runs, 1u);
+    EXPECT_EQ(hits, 1u);
+    // The passes after the checkpoint still run.
+    EXPECT_EQ(after, 2u);
+    ASSERT_NE(second, nullptr);
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(second->equiv(*first));
+    EXPECT_EQ(second->to<IR::P4Program>()->objects.size(), 1u);
+}
+
+TEST_F(PassResultCacheTest, frontEndHitEqualsRecomputed) {
+    auto source = frontEndSource(1);
+    uint64_t uncachedPasses = 0, storingPasses = 0, cachedPasses = 0;
+    auto *uncached = runFrontEnd(source, {}, uncachedPasses);
+    auto *stored = runFrontEnd(source, {"--pass-cache", dir.c_str()}, storingPasses);
+    auto *cached = runFrontEnd(source, {"--pass-cache", dir.c_str()}, cachedPasses);
+    ASSERT_NE(uncached, nullptr);
+    ASSERT_NE(stored, nullptr);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(::diagnosticCount(), 0u);
+
+    // The second compilation with the cache loads the result of the first one.
+    EXPECT_EQ(storingPasses, uncachedPasses);
+    EXPECT_LT(cachedPasses, uncachedPasses);
+    EXPECT_NE(cached, stored);
+    EXPECT_TRUE(cached->equiv(*uncached));
+    EXPECT_TRUE(stored->equiv(*uncached));
+    EXPECT_EQ(toP4(cached), toP4(uncached));
+}
+
+TEST_F(PassResultCacheTest, frontEndInvalidation) {
+    uint64_t fullPasses = 0, passes = 0;
+    std::vector<const char *> args = {"--pass-cache", dir.c_str()};
+    std::vector<const char *> otherArgs = {"--pass-cache", dir.c_str(), "-D", "X=1"};
+    ASSERT_NE(runFrontEnd(frontEndSource(1), args, fullPasses), nullptr);
+
+    // Other options or another input are compiled again.
+    auto *otherOptions = runFrontEnd(frontEndSource(1), otherArgs, passes);
+    ASSERT_NE(otherOptions, nullptr);
+    EXPECT_EQ(passes, fullPasses);
+    auto *otherInput = runFrontEnd(frontEndSource(2), args, passes);
+    ASSERT_NE(otherInput, nullptr);
+    EXPECT_EQ(passes, fullPasses);
+    EXPECT_NE(toP4(otherInput), toP4(otherOptions));
+    EXPECT_EQ(::diagnosticCount(), 0u);
+
+    // Each of them was stored.
+    EXPECT_NE(runFrontEnd(frontEndSource(2), args, passes), nullptr);
+    EXPECT_LT(passes, fullPasses);
+    EXPECT_NE(runFrontEnd(frontEndSource(1), otherArgs, passes), nullptr);
+    EXPECT_LT(passes, fullPasses);
+}
+
+TEST_F(PassResultCacheTest, keyedByInputAndContext) {
+    run(program(1), "options");
+    run(program(2), "options");
+    EXPECT_EQ(runs, 2u);
+    run(program(1), "other options");
+    EXPECT_EQ(runs, 3u);
+    EXPECT_EQ(hits, 0u);
+
+    PassResultCache cache(dir);
+    PassResultCache::Sources sources;
+    EXPECT_EQ(cache.key(program(1), "Last", "options", sources),
+              cache.key(program(1), "Last", "options", sources));
+    EXPECT_NE(cache.key(program(1), "Last", "options", sources),
+              cache.key(program(1), "Last2", "options", sources));
+    EXPECT_EQ(cache.load(cache.key(program(3), "Last", "options", sources), sources), nullptr);
+}
+
+TEST_F(PassResultCacheTest, keepsSourcePositions) {
+    std::istringstream source("const bit<8> c = 1;\n");
+    auto *input = P4::P4ParserDriver::parse(source, "prog.p4");
+    ASSERT_NE(input, nullptr);
+    auto declaration = [](const IR::Node *program) {
+        return program->to<IR::P4Program>()->objects.at(0)->srcInfo;
+    };
+    auto expected = declaration(input);
+    ASSERT_TRUE(expected.isValid());
+
+    run(input, "options");
+    auto *cached = run(input, "options");
+    EXPECT_EQ(hits, 1u);
+    ASSERT_NE(cached, nullptr);
+    auto loaded = declaration(cached);
+    EXPECT_EQ(loaded, expected);
+    EXPECT_EQ(loaded.getSources(), expected.getSources());
+    EXPECT_EQ(loaded.toPositionString(), expected.toPositionString());
+    EXPECT_EQ(loaded.toSourceFragment(), expected.toSourceFragment());
+}
+
+TEST_F(PassResultCacheTest, contextIgnoresOutputFiles) {
+    auto context = [](std::vector<const char *> args) {
+        CompilerOptions options;
+        args.insert(args.begin(), "p4test");
+        options.process(args.size(), const_cast<char **>(args.data()));
+        return options.passCacheContext();
+    };
+    EXPECT_EQ(context({"--toJSON", "a.json", "prog.p4"}), context({"prog.p4"}));
+    EXPECT_EQ(context({"--p4runtime-files=a.txt", "--stats-json", "a.json", "prog.p4"}),
+              context({"--p4runtime-files=b.txt", "--stats-json", "b.json", "prog.p4"}));
+    EXPECT_NE(context({"--loopsUnroll", "prog.p4"}), context({"prog.p4"}));
+    EXPECT_NE(context({"prog.p4"}), context({"other.p4"}));
+}
+
+TEST_F(PassResultCacheTest, diagnosticsAreNotCached) {
+    run(program(1), "options", true);
+    run(program(1), "options", true);
+    EXPECT_EQ(runs, 2u);
+    EXPECT_EQ(hits, 0u);
+}
+
+}  // namespace Test
@@ -0,0 +1,190 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/preludeCache.h"
+#include "frontends/parsers/parserDriver.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/binary_ir.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+
+using namespace P4;
+
+namespace Test {
+
+class PreludeCacheTest : public P4CTest {};
+
+namespace {
+
+const char *prelude = R"(error { NoError }
+match_kind { exact }
+extern packet_in {
+    void extract<T>(out T hdr);
+}
+extern Register<T> {
+    Register(bit<32> size);
+    T read(in bit<32> index);
+}
+extern void mark_to_drop();
+typedef bit<9> port_t;
+enum HashAlgorithm { crc16 }
+const bit<9> DROP_PORT = 511;
+action NoAction() {}
+parser Parser<H>(packet_in b, out H hdr);
+control Ingress<H>(inout H hdr);
+package Top<H>(Parser<H> p, Ingress<H> ig);
+)";
+
+const char *program = R"(error { Custom }
+header h_t { port_t port; }
+struct headers_t { h_t h; }
+parser MyParser(packet_in b, out headers_t hdr) {
+    state start { b.extract(hdr.h); transition accept; }
+}
+control MyIngress(inout headers_t hdr) {
+    Register<bit<8>>(32) r;
+    apply { if (hdr.h.port == DROP_PORT) mark_to_drop(); }
+}
+Top(MyParser(), MyIngress()) main;
+)";
+
+std::string print(const IR::P4Program *p) {
+    std::stringstream ss;
+    for (auto node : p->objects) ss << node << std::endl;
+    return ss.str();
+}
+
+/// Parses the preprocessed program @text, through the prelude cache in @cacheDir if it is set,
+/// and returns the warning reported on the declaration of mark_to_drop in the prelude.
+std::string warnOnPreludeDeclaration(const std::string &text, cstring cacheDir) {
+    CompilerOptions options;
+    options.file = "prog.p4";
+    options.preludeCacheDir = cacheDir;
+    const IR::P4Program *parsed = nullptr;
+    if (cacheDir) {
+        FILE *in = fmemopen(const_cast<char *>(text.data()), text.size(), "r");
+        parsed = parseWithPreludeCache(in, options);
+        fclose(in);
+    } else {
+        std::istringstream in(text);
+        parsed = P4ParserDriver::parse(in, options.file);
+    }
+    if (parsed == nullptr) return "";
+    for (auto node : parsed->objects) {
+        auto *method = node->to<IR::Method>();
+        if (method == nullptr || method->name != "mark_to_drop") continue;
+        // Report in a new context, which has not seen the same diagnostic yet.
+        std::stringstream out;
+        AutoCompileContext context(new GTestContext);
+        BaseCompileContext::get().errorReporter().setOutputStream(&out);
+        ::warning(ErrorType::WARN_UNUSED, "%1%: declared here", method);
+        return out.str();
+    }
+    return "";
+}
+
+}  // namespace
+
+TEST_F(PreludeCacheTest, SplitPrelude) {
+    std::string text =
+        "# 1 \"prog.p4\"\n"
+        "# 1 \"<built-in>\"\n"
+        "# 1 \"prog.p4\"\n"
+        "/* License\n"
+        "   header */\n"
+        "# 1 \"/inc/core.p4\" 1\n"
+        "extern packet_in {}\n"
+        "# 2 \"prog.p4\" 2\n"
+        "// comment\n"
+        "# 1 \"/inc/arch.p4\" 1\n"
+        "control C();\n"
+        "# 3 \"prog.p4\" 2\n"
+        "\n"
+        "header h_t { bit<8> f; }\n";
+    std::string preludeText;
+    auto rest = splitPrelude(text, "/inc", preludeText);
+    EXPECT_EQ(preludeText,
+              "# 1 \"/inc/core.p4\" 1\n"
+              "extern packet_in {}\n"
+              "# 1 \"/inc/arch.p4\" 1\n"
+              "control C();\n");
+    EXPECT_EQ(text.substr(rest), "# 3 \"prog.p4\" 2\n\nheader h_t { bit<8> f; }\n");
+
+    // Without includes there is no prelude.
+    EXPECT_EQ(splitPrelude("# 1 \"prog.p4\"\nheader h_t { bit<8> f; }\n", "/inc", preludeText),
+              0u);
+}
+
+TEST_F(PreludeCacheTest, ParseAfterPrelude) {
+    auto *full = parseP4String(std::string(prelude) + program,
+                               CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(full != nullptr && ::errorCount() == 0);
+
+    std::istringstream preludeStream(prelude);
+    auto *parsedPrelude = P4ParserDriver::parse(preludeStream, "prelude.p4");
+    ASSERT_TRUE(parsedPrelude != nullptr && ::errorCount() == 0);
+    ASSERT_TRUE(P4ParserDriver::isPrelude(parsedPrelude));
+
+    // Go through the binary IR, as a cached prelude would.
+    cstring fileName = "prelude_cache_test.p4ir";
+    {
+        std::ofstream out(fileName.c_str(), std::ios::binary);
+        writeBinaryIR(out, parsedPrelude, true);
+    }
+    auto *loaded = loadBinaryIR(fileName, true);
+    std::remove(fileName.c_str());
+    ASSERT_TRUE(loaded != nullptr && loaded->is<IR::P4Program>());
+
+    std::istringstream rest(program);
+    auto *split = P4ParserDriver::parse(rest, "program.p4", 1, loaded->to<IR::P4Program>());
+    ASSERT_TRUE(split != nullptr && ::errorCount() == 0);
+    EXPECT_EQ(print(split), print(full));
+}
+
+TEST_F(PreludeCacheTest, CachedPreludeKeepsSourcePositions) {
+    std::string includeFile = std::string(p4includePath) + "/prelude.p4";
+    std::string text = "# 1 \"prog.p4\"\n# 1 \"" + includeFile + "\" 1\n" + prelude +
+                       "# 2 \"prog.p4\" 2\n" + program;
+    char tmpl[] = "/tmp/p4c-prelude-cache-XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    cstring cacheDir = tmpl;
+
+    auto uncached = warnOnPreludeDeclaration(text, nullptr);
+    // The first compilation parses the prelude and caches it, the second one loads it.
+    auto parsed = warnOnPreludeDeclaration(text, cacheDir);
+    auto cached = warnOnPreludeDeclaration(text, cacheDir);
+    size_t entries = std::distance(std::filesystem::directory_iterator(tmpl),
+                                   std::filesystem::directory_iterator());
+    std::filesystem::remove_all(tmpl);
+    EXPECT_EQ(entries, 1u);
+    EXPECT_EQ(::errorCount(), 0u);
+
+    EXPECT_NE(uncached.find(includeFile + "(10)"), std::string::npos) << uncached;
+    EXPECT_NE(uncached.find("extern void mark_to_drop();"), std::string::npos) << uncached;
+    EXPECT_EQ(parsed, uncached);
+    EXPECT_EQ(cached, uncached);
+}
+
+}  // namespace Test
@@ -16,10 +16,14 @@ limitations under the License.
 
 #include "lib/source_file.h"
 
+#include <cstdio>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "lib/compile_context.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
+#include "lib/input_buffer.h"
 
 namespace Util {
 
@@ -42,14 +46,14 @@ TEST(UtilSourceFile, SourcePosition) {
 
 TEST(UtilSourceFile, InputSources) {
     Util::InputSources sources;
-    sources.appendToLastLine("First line");
+    sources.appendText("First line");
     {
         SourcePosition position = sources.getCurrentPosition();
         EXPECT_EQ(1u, position.getLineNumber());
         EXPECT_EQ(10u, position.getColumnNumber());
     }
 
-    sources.appendNewline("\n");
+    sources.appendText("\n");
     sources.mapLine("fakesource.p4", 5);
 
     {
@@ -58,10 +62,9 @@ TEST(UtilSourceFile, InputSources) {
         EXPECT_EQ(0u, position.getColumnNumber());
     }
 
-    sources.appendToLastLine("Second line");
-    sources.appendNewline("\n");
-    sources.appendToLastLine("Third line");
-    sources.appendNewline("\n");
+    sources.appendText("Second line");
+    sources.appendText("\n");
+    sources.appendText("Third line\n");
     sources.seal();
 
     EXPECT_EQ(3u, sources.lineCount());
@@ -77,6 +80,46 @@ TEST(UtilSourceFile, InputSources) {
     EXPECT_EQ(5u, original.sourceLine);
 }
 
+TEST(UtilSourceFile, InputSourcesLines) {
+    Util::InputSources sources;
+    sources.appendText("a\r");
+    sources.appendText("\nb\n\nc\rd");
+    EXPECT_EQ(4u, sources.lineCount());
+    EXPECT_EQ("a\r\n", sources.getLine(1));
+    EXPECT_EQ("b\n", sources.getLine(2));
+    EXPECT_EQ("\n", sources.getLine(3));
+    EXPECT_EQ("c\rd", sources.getLine(4));
+    EXPECT_EQ("", sources.getLine(0));
+    SourcePosition position = sources.getCurrentPosition();
+    EXPECT_EQ(4u, position.getLineNumber());
+    EXPECT_EQ(3u, position.getColumnNumber());
+}
+
+TEST(UtilSourceFile, InputBuffer) {
+    const std::string text = "first line\nsecond line\n";
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    fputs(text.c_str(), file);
+    rewind(file);
+    {
+        InputBuffer mapped(file);
+        EXPECT_EQ(text, mapped.contents());
+        MemoryInputStream stream(mapped.contents());
+        EXPECT_EQ(static_cast<std::streamsize>(text.size()), stream.rdbuf()->in_avail());
+        std::string line;
+        std::getline(stream, line);
+        EXPECT_EQ("first line", line);
+        std::getline(stream, line);
+        EXPECT_EQ("second line", line);
+        EXPECT_FALSE(std::getline(stream, line));
+    }
+    // A file that was read from is read from its current position.
+    fseek(file, 6, SEEK_SET);
+    InputBuffer rest(file);
+    EXPECT_EQ(text.substr(6), rest.contents());
+    fclose(file);
+}
+
 TEST(UtilSourceFile, SourceInfo) {
     Util::InputSources sources;
 
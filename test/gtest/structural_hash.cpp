@@ -0,0 +1,85 @@
+#include "ir/structural_hash.h"
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+using namespace IR;
+
+const Expression *field(cstring header, cstring name) {
+    return new Member(Type_Bits::get(8), new PathExpression(header), name);
+}
+
+const Expression *sum(cstring header) {
+    return new Add(Type_Bits::get(8), field(header, "a"), new Constant(Type_Bits::get(8), 1));
+}
+
+TEST(StructuralHash, equivNodes) {
+    const auto *first = sum("h");
+    const auto *second = sum("h");
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(first->equiv(*second));
+    EXPECT_EQ(first->structuralHash(), second->structuralHash());
+
+    // Source positions are not part of the hash.
+    auto *positioned = sum("h")->clone();
+    positioned->srcInfo = Util::SourceInfo("test.p4", 1, 2, "h.a + 1");
+    EXPECT_EQ(first->structuralHash(), positioned->structuralHash());
+
+    EXPECT_NE(first->structuralHash(), sum("g")->structuralHash());
+    EXPECT_NE((new Add(first, first))->structuralHash(), (new Sub(first, first))->structuralHash());
+}
+
+TEST(StructuralHash, clonesRehash) {
+    const auto *original = new Constant(Type_Bits::get(8), 1);
+    auto hash = original->structuralHash();
+    auto *copy = original->clone();
+    copy->value = 2;
+    EXPECT_NE(copy->structuralHash(), hash);
+    EXPECT_EQ(copy->structuralHash(), Constant(Type_Bits::get(8), 2).structuralHash());
+}
+
+TEST(StructuralHash, modifiedNodesRehash) {
+    auto *constant = new Constant(Type_Bits::get(8), 1);
+    auto hash = constant->structuralHash();
+    constant->value = 2;
+    EXPECT_NE(constant->structuralHash(), hash);
+}
+
+TEST(StructuralHash, vectors) {
+    auto *first = new Vector<Expression>({sum("h"), field("h", "b")});
+    auto *second = new Vector<Expression>({sum("h"), field("h", "b")});
+    auto *reversed = new Vector<Expression>({field("h", "b"), sum("h")});
+    EXPECT_EQ(first->structuralHash(), second->structuralHash());
+    EXPECT_NE(first->structuralHash(), reversed->structuralHash());
+}
+
+TEST(HashConsTable, sharesNodes) {
+    HashConsTable table;
+    const auto *first = table.intern(sum("h"));
+    EXPECT_EQ(table.intern(sum("h")), first);
+    EXPECT_NE(table.intern(sum("g")), first);
+    const auto *constant = table.make<Constant>(Type_Bits::get(8), 1);
+    EXPECT_EQ(table.make<Constant>(Type_Bits::get(8), 1), constant);
+    EXPECT_NE(table.make<Constant>(Type_Bits::get(16), 1), constant);
+    EXPECT_EQ(table.size(), 4u);
+}
+
+// Interning a chain bottom-up hashes each node once, not its whole subtree again.
+TEST(HashConsTable, internsDeepChainsWithoutRehashing) {
+    HashConsTable table;
+    const Expression *chain = table.make<Constant>(Type_Bits::get(8), 1);
+    const int depth = 1000;
+    for (int i = 0; i < depth; i++) chain = table.make<Neg>(Type_Bits::get(8), chain);
+    // The chain nodes and the type of the constant and the negations, which is shared.
+    EXPECT_EQ(table.hashMemo().computedCount(), depth + 2u);
+
+    // Interning an equivalent chain only hashes its new nodes.
+    const Expression *copy = new Constant(Type_Bits::get(8), 1);
+    for (int i = 0; i < depth; i++) copy = new Neg(Type_Bits::get(8), copy);
+    EXPECT_EQ(table.intern(copy), chain);
+    EXPECT_EQ(table.hashMemo().computedCount(), 2 * depth + 3u);
+}
+
+}  // namespace Test
@@ -32,6 +32,9 @@ enum flags {
     FRIEND = 1024        // friend function, not a method
 };
 
+// Fields numbered from a counter of their class, like declid, identify a node as its id does.
+static bool isCounterId(const IrField *f) { return f->initializer == "nextId++"; }
+
 const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
     {"operator==",
      {&NamedType::Bool(),
@@ -70,6 +73,34 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
           buf << cl->indent << "}";
           return buf.str();
       }}},
+    {"computeStructuralHash",
+     {&NamedType::SizeT(),
+      {},
+      CONST + IN_IMPL + OVERRIDE,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          // Nodes that are equiv must have the same hash, so the fields of classes with a
+          // user-defined equiv are left out.  This entry precedes "equiv", so any equiv method
+          // that exists at this point was written by the user.
+          if (cl->getUserMethods()->where([](IrMethod *m) { return m->name == "equiv"; })->any())
+              return cstring();
+          bool needed = false;
+          std::stringstream buf;
+          buf << "{" << std::endl << cl->indent << cl->indent << "size_t hash = ";
+          if (auto parent = cl->getParent())
+              buf << parent->qualified_name(cl->containedIn) << "::computeStructuralHash();";
+          else
+              buf << "0;";
+          buf << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;  // not compared by equiv
+              buf << cl->indent << cl->indent << "hashField(hash, " << f->name << ");"
+                  << std::endl;
+              needed = true;
+          }
+          buf << cl->indent << cl->indent << "return hash;" << std::endl;
+          buf << cl->indent << "}";
+          return needed ? buf.str() : cstring();
+      }}},
     {"equiv",
      {&NamedType::Bool(),
       {new IrField(new ReferenceType(new NamedType(IrClass::nodeClass()), true), "a_")},
@@ -275,6 +306,58 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
           buf << "{ return new " << cl->name << "(json); }";
           return buf.str();
       }}},
+    {"toBinary",
+     {&NamedType::Void(),
+      {new IrField(new ReferenceType(&NamedType::BinaryGenerator()), "binary")},
+      CONST + IN_IMPL + OVERRIDE + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{" << std::endl;
+          if (auto parent = cl->getParent())
+              buf << cl->indent << parent->qualified_name(cl->containedIn)
+                  << "::toBinary(binary);" << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;  // FIXME -- deal with SourcInfo
+              if (isCounterId(f))
+                  buf << cl->indent << "binary.generateId(this->" << f->name << ");" << std::endl;
+              else
+                  buf << cl->indent << "binary << this->" << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    // The constructor used by BinaryLoader.  The JSONLoader constructor above already uses
+    // the nullptr key; generateMethods names CONSTRUCTOR methods after their class.
+    {"binaryConstructor",
+     {nullptr,
+      {new IrField(new ReferenceType(&NamedType::BinaryLoader()), "binary")},
+      IN_IMPL + CONSTRUCTOR + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          if (auto parent = cl->getParent())
+              buf << ": " << parent->qualified_name(cl->containedIn) << "(binary)";
+          buf << " {" << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;  // FIXME -- deal with SourcInfo
+              if (isCounterId(f))
+                  buf << cl->indent << "binary.unpackId(" << f->name << ");" << std::endl;
+              else
+                  buf << cl->indent << "binary >> " << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    {"fromBinary",
+     {nullptr,
+      {
+          new IrField(new ReferenceType(&NamedType::BinaryLoader()), "binary"),
+      },
+      FACTORY + IN_IMPL + CONCRETE_ONLY + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{ return new " << cl->name << "(binary); }";
+          return buf.str();
+      }}},
     {"toString",
      {&NamedType::Cstring(),
       {},
@@ -347,7 +430,7 @@ void IrClass::generateMethods() {
         if (!IrMethod::Generate.count(m->name))
             throw Util::CompilationError("Unrecognized predefined method %1%", m->name);
         auto &info = IrMethod::Generate.at(m->name);
-        if (m->name) {
+        if (m->name && !(info.flags & CONSTRUCTOR)) {
             if (info.rtype) {
                 // This predefined method has an explicit return type.
                 m->rtype = info.rtype;
@@ -80,6 +80,11 @@ NamedType &NamedType::Int() {
     return nt;
 }
 
+NamedType &NamedType::SizeT() {
+    static NamedType nt("size_t");
+    return nt;
+}
+
 NamedType &NamedType::Void() {
     static NamedType nt("void");
     return nt;
@@ -120,6 +125,16 @@ NamedType &NamedType::JSONObject() {
     return nt;
 }
 
+NamedType &NamedType::BinaryGenerator() {
+    static NamedType nt("BinaryGenerator");
+    return nt;
+}
+
+NamedType &NamedType::BinaryLoader() {
+    static NamedType nt("BinaryLoader");
+    return nt;
+}
+
 NamedType &NamedType::SourceInfo() {
     static NamedType nt(new LookupScope("Util"), "SourceInfo");
     return nt;
@@ -97,6 +97,7 @@ class NamedType : public Type {
 
     static NamedType &Bool();
     static NamedType &Int();
+    static NamedType &SizeT();
     static NamedType &Void();
     static NamedType &Cstring();
     static NamedType &Ostream();
@@ -105,6 +106,8 @@ class NamedType : public Type {
     static NamedType &JSONGenerator();
     static NamedType &JSONLoader();
     static NamedType &JSONObject();
+    static NamedType &BinaryGenerator();
+    static NamedType &BinaryLoader();
     static NamedType &SourceInfo();
 };
 